@@ -0,0 +1,1078 @@
+#include "animations/AnimInstance.h"
+#include "animations/AnimationDatabase.h"
+#include "animations/AnimationsUtils.h"
+#include "animations/Animator.h"
+#include "animations/anim-graph/AnimGraph.h"
+#include "animations/anim-graph/AnimGraphBaker.h"
+#include "animations/anim-graph/AnimationContext.h"
+#include "animations/anim-graph/nodes/AnimGraphClipNode.h"
+#include "animations/anim-graph/nodes/AnimGraphOutputPoseNode.h"
+#include "animations/anim-graph/nodes/AnimGraphStateMachineNode.h"
+#include "animations/compression/AnimationCompression.h"
+#include "animations/ik/IKSolverCCD.h"
+#include "animations/ik/IKSolverFABRIK.h"
+#include "animations/ik/IKSolverTwoBone.h"
+#include "animations/simd/PoseKernels.h"
+#include "asset-manager/ModelLoader.h"
+#include "core/ThreadPool.h"
+#include "tools/Logger.h"
+#include "vk-renderer/VkRenderData.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace
+{
+// every heap allocation of the process, steady state graph evaluation is expected not to make any
+std::atomic<size_t> g_AllocationCount{0};
+} // namespace
+
+// array and nothrow forms forward to these, so they are counted as well
+void* operator new(const std::size_t size)
+{
+    g_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* memory = std::malloc(size != 0 ? size : 1))
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+// headless animation micro-benchmarks, results are printed to stdout as json
+// usage: AnimationBenchmark [--bones N] [--depth N] [--keys N] [--iterations N] [--assets DIR]
+namespace
+{
+using namespace Core::Animations;
+
+struct BenchmarkOptions
+{
+    size_t boneCount = 64;
+    size_t depth = 8;
+    // keys per second of every synthetic track
+    size_t keysPerSecond = 30;
+    float clipSeconds = 4.f;
+    size_t iterations = 2000;
+    std::string assetsDirectory = "assets/mixamo";
+};
+
+struct BenchmarkResult
+{
+    std::string name;
+    double nanosecondsPerCall = 0.0;
+    double nanosecondsPerBone = 0.0;
+};
+
+// pass or fail checks of the anim graph path, any failure makes the benchmark exit with an error
+struct AnimGraphChecks
+{
+    // baked graph sampled at its keys against live evaluation of the same graph at the same times
+    float bakeMaxPositionError = 0.f;
+    // radians
+    float bakeMaxRotationError = 0.f;
+
+    // bone palettes of meshes updated on one thread against the same meshes updated on the worker pool
+    size_t parallelPaletteMismatches = 0;
+
+    // heap allocations of a warmed up instance over many frames, pooled poses and scratch should make it zero
+    size_t steadyStateAllocations = 0;
+
+    [[nodiscard]] bool isPassing() const
+    {
+        return bakeMaxPositionError < 1e-4f && bakeMaxRotationError < 1e-3f && parallelPaletteMismatches == 0 &&
+               steadyStateAllocations == 0;
+    }
+};
+
+// mat3x4 palette read by primitive.vert against the mat4 skinning it replaced, any failure fails the benchmark
+struct SkinningChecks
+{
+    // largest distance between old and new results, relative to their magnitude
+    float maxPositionError = 0.f;
+    float maxNormalError = 0.f;
+    // PoseKernels::skinPositions is the cpu copy of the shader, so it has to match as well
+    float maxKernelPositionError = 0.f;
+
+    [[nodiscard]] bool isPassing() const
+    {
+        return maxPositionError < 1e-5f && maxNormalError < 1e-5f && maxKernelPositionError < 1e-5f;
+    }
+};
+
+struct BenchmarkRig
+{
+    std::string name;
+    Core::Resources::SkeletonData skeletonData;
+    std::vector<AnimationClip> clips;
+    // effector first, same order IIKSolver expects
+    std::vector<int> ikChain;
+};
+
+// keeps results observable, so the optimizer can't drop the measured work
+volatile float benchmarkSink = 0.f;
+
+BenchmarkResult measure(const std::string& name, const size_t iterations, const size_t boneCount,
+                        const std::function<void()>& function)
+{
+    for (size_t i = 0; i < iterations / 10 + 1; ++i)
+    {
+        function();
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        function();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+
+    BenchmarkResult result;
+    result.name = name;
+    result.nanosecondsPerCall = nanoseconds / static_cast<double>(iterations);
+    result.nanosecondsPerBone = result.nanosecondsPerCall / static_cast<double>(std::max<size_t>(boneCount, 1));
+    return result;
+}
+
+// bones form chains of depth bones hanging from a single root bone
+Core::Resources::SkeletonData buildSyntheticSkeleton(const size_t boneCount, const size_t depth)
+{
+    Core::Resources::SkeletonData skeletonData;
+    skeletonData.boneParents.resize(boneCount, -1);
+
+    BoneNode& sceneRoot = skeletonData.rootNode;
+    sceneRoot.name = "scene_root";
+    sceneRoot.localTransform = glm::mat4(1.f);
+
+    BoneNode& rootBone = sceneRoot.children.emplace_back();
+    rootBone.name = "bone_0";
+    rootBone.localTransform = glm::mat4(1.f);
+    skeletonData.boneNameToIndexMap[rootBone.name] = 0;
+
+    const size_t chainLength = std::max<size_t>(depth, 2) - 1;
+
+    size_t nextBone = 1;
+    while (nextBone < boneCount)
+    {
+        BoneNode* parentNode = &rootBone;
+        int parentIndex = 0;
+
+        for (size_t link = 0; link < chainLength && nextBone < boneCount; ++link)
+        {
+            const int boneIndex = static_cast<int>(nextBone++);
+
+            BoneNode& node = parentNode->children.emplace_back();
+            node.name = "bone_" + std::to_string(boneIndex);
+            node.localTransform = glm::translate(glm::mat4(1.f), glm::vec3(0.f, 0.1f, 0.f)) *
+                                  glm::rotate(glm::mat4(1.f), 0.1f * static_cast<float>(boneIndex % 7),
+                                              glm::vec3(0.f, 0.f, 1.f));
+
+            skeletonData.boneNameToIndexMap[node.name] = boneIndex;
+            skeletonData.boneParents[boneIndex] = parentIndex;
+
+            parentNode = &node;
+            parentIndex = boneIndex;
+        }
+    }
+
+    AnimationsUtils::buildFlatSkeleton(skeletonData.rootNode, skeletonData.boneNameToIndexMap,
+                                       skeletonData.flatSkeleton);
+    skeletonData.referencePose = AnimationsUtils::createReferencePose(skeletonData);
+
+    return skeletonData;
+}
+
+struct SyntheticKeys
+{
+    std::vector<KeyframeVec3> vec3Keys;
+    std::vector<KeyframeQuat> quatKeys;
+};
+
+AnimationClip buildSyntheticClip(const Core::Resources::SkeletonData& skeletonData, const size_t keysPerSecond,
+                                 const float clipSeconds)
+{
+    AnimationClip clip;
+    clip.name = "synthetic";
+    clip.ticksPerSecond = 30.f;
+    clip.duration = clipSeconds * clip.ticksPerSecond;
+
+    const size_t boneCount = skeletonData.referencePose.size();
+    const size_t keyCount = std::max<size_t>(static_cast<size_t>(static_cast<float>(keysPerSecond) * clipSeconds), 2);
+
+    auto keys = std::make_shared<SyntheticKeys>();
+    keys->vec3Keys.reserve(boneCount * keyCount * 2);
+    keys->quatKeys.reserve(boneCount * keyCount);
+
+    for (size_t bone = 0; bone < boneCount; ++bone)
+    {
+        const BoneTransform bind = skeletonData.referencePose.getTransform(bone);
+
+        for (size_t key = 0; key < keyCount; ++key)
+        {
+            const float time = clip.duration * static_cast<float>(key) / static_cast<float>(keyCount - 1);
+            const float phase = time * 0.2f + static_cast<float>(bone);
+
+            const glm::quat swing = glm::angleAxis(0.3f * std::sin(phase), glm::vec3(1.f, 0.f, 0.f));
+
+            keys->vec3Keys.push_back({time, bind.position + glm::vec3(0.01f * std::sin(phase), 0.f, 0.f)});
+            keys->quatKeys.push_back({time, glm::normalize(bind.rotation * swing)});
+        }
+
+        for (size_t key = 0; key < keyCount; ++key)
+        {
+            const float time = clip.duration * static_cast<float>(key) / static_cast<float>(keyCount - 1);
+            keys->vec3Keys.push_back({time, bind.scale});
+        }
+    }
+
+    for (const auto& [name, boneIndex] : skeletonData.boneNameToIndexMap)
+    {
+        const size_t bone = static_cast<size_t>(boneIndex);
+
+        AnimationChannel& channel = clip.channels.emplace_back();
+        channel.boneName = name;
+        channel.positions = {keys->vec3Keys.data() + bone * keyCount * 2, keyCount};
+        channel.rotations = {keys->quatKeys.data() + bone * keyCount, keyCount};
+        channel.scalings = {keys->vec3Keys.data() + bone * keyCount * 2 + keyCount, keyCount};
+    }
+
+    clip.keyStorage = std::move(keys);
+
+    return clip;
+}
+
+// deepest bone and its ancestors, at most maxLength bones
+std::vector<int> findDeepestChain(const Core::Resources::SkeletonData& skeletonData, const size_t maxLength)
+{
+    const std::vector<int>& parents = skeletonData.boneParents;
+
+    int deepestBone = -1;
+    size_t deepestDepth = 0;
+    for (size_t bone = 0; bone < parents.size(); ++bone)
+    {
+        size_t depth = 0;
+        for (int current = static_cast<int>(bone); current >= 0; current = parents[current])
+        {
+            ++depth;
+        }
+
+        if (depth > deepestDepth)
+        {
+            deepestDepth = depth;
+            deepestBone = static_cast<int>(bone);
+        }
+    }
+
+    std::vector<int> chain;
+    for (int current = deepestBone; current >= 0 && chain.size() < maxLength; current = parents[current])
+    {
+        chain.push_back(current);
+    }
+
+    return chain;
+}
+
+// cursors should keep the per sample cost flat no matter how many keys the clip has, seeks grow with log of key count
+void runClipLengthSweep(const Core::Resources::SkeletonData& skeletonData, const BenchmarkOptions& options,
+                        std::vector<BenchmarkResult>& results)
+{
+    const size_t boneCount = skeletonData.referencePose.size();
+
+    for (const float clipSeconds : {1.f, 5.f, 30.f, 60.f, 300.f})
+    {
+        const AnimationClip clip = buildSyntheticClip(skeletonData, options.keysPerSecond, clipSeconds);
+        const AnimationClipBinding binding = AnimationsUtils::bindClipToSkeleton(clip, skeletonData);
+
+        std::vector<AnimationChannelCursor> cursors;
+        Pose pose;
+
+        const std::string suffix = "_" + std::to_string(static_cast<int>(clipSeconds)) + "s";
+
+        const float frameTicks = clip.ticksPerSecond / 60.f;
+        float time = 0.f;
+        results.push_back(measure("sampleClip" + suffix, options.iterations, boneCount,
+                                  [&]
+                                  {
+                                      time = std::fmod(time + frameTicks, clip.duration);
+                                      Animator::sampleClip(clip, binding, time, skeletonData, cursors, pose);
+                                      benchmarkSink = pose.positions[0].x;
+                                  }));
+
+        size_t seek = 0;
+        results.push_back(measure("sampleClipSeek" + suffix, options.iterations, boneCount,
+                                  [&]
+                                  {
+                                      seek = (seek * 7 + 13) % 1024;
+                                      const float seekTime = clip.duration * static_cast<float>(seek) / 1024.f;
+                                      Animator::sampleClip(clip, binding, seekTime, skeletonData, cursors, pose);
+                                      benchmarkSink = pose.positions[0].x;
+                                  }));
+    }
+}
+
+std::vector<BenchmarkResult> runRig(const BenchmarkRig& rig, const BenchmarkOptions& options)
+{
+    std::vector<BenchmarkResult> results;
+
+    const Core::Resources::SkeletonData& skeletonData = rig.skeletonData;
+    const size_t boneCount = skeletonData.referencePose.size();
+    const size_t iterations = options.iterations;
+
+    if (rig.clips.empty() || boneCount == 0)
+    {
+        return results;
+    }
+
+    const AnimationClip& clipA = rig.clips.front();
+    const AnimationClip& clipB = rig.clips.size() > 1 ? rig.clips[1] : rig.clips.front();
+
+    const AnimationClipBinding bindingA = AnimationsUtils::bindClipToSkeleton(clipA, skeletonData);
+    const AnimationClipBinding bindingB = AnimationsUtils::bindClipToSkeleton(clipB, skeletonData);
+
+    std::vector<AnimationChannelCursor> cursorsA;
+    std::vector<AnimationChannelCursor> cursorsB;
+
+    Pose poseA;
+    Pose poseB;
+    Pose blended;
+
+    // forward playback at 60 frames per second, cursors make this the common case
+    const float frameTicks = (clipA.ticksPerSecond != 0.f ? clipA.ticksPerSecond : 30.f) / 60.f;
+    float time = 0.f;
+
+    results.push_back(measure("sampleClip", iterations, boneCount,
+                              [&]
+                              {
+                                  time = std::fmod(time + frameTicks, std::max(clipA.duration, frameTicks));
+                                  Animator::sampleClip(clipA, bindingA, time, skeletonData, cursorsA, poseA);
+                                  benchmarkSink = poseA.positions[0].x;
+                              }));
+
+    // random access defeats cursors, every sample searches its keys
+    size_t seek = 0;
+    results.push_back(measure("sampleClipSeek", iterations, boneCount,
+                              [&]
+                              {
+                                  seek = (seek * 7 + 13) % 1024;
+                                  const float seekTime = clipA.duration * static_cast<float>(seek) / 1024.f;
+                                  Animator::sampleClip(clipA, bindingA, seekTime, skeletonData, cursorsA, poseA);
+                                  benchmarkSink = poseA.positions[0].x;
+                              }));
+
+    AnimationCompressionSettings compressionSettings;
+    compressionSettings.enabled = true;
+
+    AnimationClip compressedClip = clipA;
+    AnimationCompression::compressInPlace(compressedClip, &skeletonData, compressionSettings);
+
+    std::vector<AnimationChannelCursor> compressedCursors;
+    time = 0.f;
+    results.push_back(measure("sampleClipCompressed", iterations, boneCount,
+                              [&]
+                              {
+                                  time = std::fmod(time + frameTicks, std::max(clipA.duration, frameTicks));
+                                  Animator::sampleClip(compressedClip, bindingA, time, skeletonData,
+                                                       compressedCursors, poseA);
+                                  benchmarkSink = poseA.positions[0].x;
+                              }));
+
+    Animator::sampleClip(clipA, bindingA, 0.f, skeletonData, cursorsA, poseA);
+    Animator::sampleClip(clipB, bindingB, clipB.duration * 0.5f, skeletonData, cursorsB, poseB);
+
+    results.push_back(measure("blendPoses", iterations, boneCount,
+                              [&]
+                              {
+                                  Animator::blendPoses(poseA, poseB, 0.35f, blended);
+                                  benchmarkSink = blended.positions[0].x;
+                              }));
+
+    // every other bone masked, compiling happens once per mask edit, blending runs every frame
+    AnimationMask mask;
+    mask.name = "benchmark";
+    for (const auto& [name, boneIndex] : skeletonData.boneNameToIndexMap)
+    {
+        mask.setWeight(name, boneIndex % 2 == 0 ? 1.f : 0.25f);
+    }
+
+    results.push_back(measure("compileMask", iterations, boneCount,
+                              [&]
+                              {
+                                  mask.compiledSkeleton = nullptr;
+                                  AnimationsUtils::compileMask(mask, skeletonData);
+                                  benchmarkSink = mask.compiledWeights[0];
+                              }));
+
+    results.push_back(measure("blendMaskedPoses", iterations, boneCount,
+                              [&]
+                              {
+                                  Animator::blendMaskedPoses(poseA, poseB, mask.compiledWeights, 0.8f, blended);
+                                  benchmarkSink = blended.positions[0].x;
+                              }));
+
+    BonePalette palette;
+    results.push_back(measure("buildGlobalTransforms", iterations, boneCount,
+                              [&]
+                              {
+                                  Animator::buildGlobalTransforms(poseA, skeletonData, palette);
+                                  benchmarkSink = palette.globalTransforms.back()[3].x;
+                              }));
+
+    if (rig.ikChain.size() < 2)
+    {
+        return results;
+    }
+
+    AnimationScratch scratch;
+
+    PoseGlobalData bindGlobals;
+    AnimationsUtils::buildPoseGlobalTransforms(skeletonData.referencePose, skeletonData, bindGlobals);
+
+    // target is pulled a bit towards the chain root, so it stays reachable and solvers have to iterate
+    const glm::vec3 effectorPosition = glm::vec3(bindGlobals.globalTransforms[rig.ikChain.front()][3]);
+    const glm::vec3 rootPosition = glm::vec3(bindGlobals.globalTransforms[rig.ikChain.back()][3]);
+    const float targetRadius = glm::distance(effectorPosition, rootPosition) * 0.3f;
+
+    IKSolverCCD ccd(rig.ikChain, 10, 0.0001f);
+    IKSolverFABRIK fabrik(rig.ikChain, 10, 0.0001f);
+    IKSolverTwoBone twoBone(rig.ikChain);
+
+    Pose ikPose;
+    size_t targetIndex = 0;
+
+    // per bone cost is reported per chain bone, pose reset to reference is included
+    const auto measureSolver = [&](const std::string& name, IIKSolver& solver, const size_t solvedBoneCount)
+    {
+        return measure(name, iterations, solvedBoneCount,
+                       [&]
+                       {
+                           const float angle = static_cast<float>(targetIndex++ % 16) * 0.4f;
+                           const glm::vec3 offset = glm::vec3(std::cos(angle), 0.f, std::sin(angle)) * targetRadius;
+                           const glm::vec3 target = glm::mix(effectorPosition, rootPosition, 0.3f) + offset;
+
+                           ikPose = skeletonData.referencePose;
+                           solver.solveForTarget(skeletonData, target, ikPose, scratch);
+                           benchmarkSink = ikPose.rotations[rig.ikChain.back()].w;
+                       });
+    };
+
+    results.push_back(measureSolver("IKSolverCCD", ccd, rig.ikChain.size()));
+    results.push_back(measureSolver("IKSolverFABRIK", fabrik, rig.ikChain.size()));
+
+    // closed form solver only bends the effector and its two parents
+    if (rig.ikChain.size() >= 3)
+    {
+        results.push_back(measureSolver("IKSolverTwoBone", twoBone, 3));
+
+        // per bone cost of these entries is cost per chain
+        for (const size_t chainCount : {1, 100, 1000})
+        {
+            std::vector<Pose> poses(chainCount, skeletonData.referencePose);
+            std::vector<TwoBoneIKRequest> requests(chainCount);
+
+            for (size_t chain = 0; chain < chainCount; ++chain)
+            {
+                const float angle = static_cast<float>(chain % 16) * 0.4f;
+                const glm::vec3 offset = glm::vec3(std::cos(angle), 0.f, std::sin(angle)) * targetRadius;
+
+                requests[chain].pose = &poses[chain];
+                requests[chain].skeletonData = &skeletonData;
+                requests[chain].limb = twoBone.getLimb();
+                requests[chain].target = glm::mix(effectorPosition, rootPosition, 0.3f) + offset;
+            }
+
+            // only limb bones change, so only they are reset between runs
+            const auto resetLimbs = [&]
+            {
+                for (Pose& pose : poses)
+                {
+                    for (const int boneIndex : twoBone.getLimb())
+                    {
+                        pose.rotations[boneIndex] = skeletonData.referencePose.rotations[boneIndex];
+                    }
+                }
+            };
+
+            const size_t chainIterations = std::max<size_t>(iterations / chainCount, 10);
+
+            results.push_back(measure("TwoBoneIKPerChain_" + std::to_string(chainCount), chainIterations, chainCount,
+                                      [&]
+                                      {
+                                          resetLimbs();
+                                          for (size_t chain = 0; chain < chainCount; ++chain)
+                                          {
+                                              twoBone.solveForTarget(skeletonData, requests[chain].target,
+                                                                     poses[chain], scratch);
+                                          }
+                                          benchmarkSink = poses.back().rotations[rig.ikChain[2]].w;
+                                      }));
+
+            results.push_back(measure("TwoBoneIKBatched_" + std::to_string(chainCount), chainIterations, chainCount,
+                                      [&]
+                                      {
+                                          resetLimbs();
+                                          TwoBoneIKBatch::solve(requests, scratch.twoBoneIK);
+                                          benchmarkSink = poses.back().rotations[rig.ikChain[2]].w;
+                                      }));
+        }
+    }
+
+    return results;
+}
+
+// idle and run clips switched by a state machine on the "run" bool, same shape as a typical locomotion graph
+std::shared_ptr<AnimGraph> buildSwitchGraph(const AnimationClipHandle idleHandle, const AnimationClipHandle runHandle)
+{
+    constexpr AnimParamID run("run");
+
+    auto graph = std::make_shared<AnimGraph>();
+    graph->declareParameter("run", AnimParamType::Bool);
+
+    const auto idleClip = graph->createNode<AnimGraphClipNode>();
+    idleClip->setProperty("clip", static_cast<int>(idleHandle.id));
+    const auto runClip = graph->createNode<AnimGraphClipNode>();
+    runClip->setProperty("clip", static_cast<int>(runHandle.id));
+
+    const auto stateMachine = graph->createNode<AnimGraphStateMachineNode>();
+    const int idleState = stateMachine->addState("idle");
+    const int runState = stateMachine->addState("run");
+    stateMachine->addTransition({idleState, runState, run, AnimTransitionCondition::BoolSet, 0.f, 0.25f});
+    stateMachine->addTransition({runState, idleState, run, AnimTransitionCondition::BoolCleared, 0.f, 0.25f});
+
+    const auto output = graph->createNode<AnimGraphOutputPoseNode>();
+    graph->setOutputNode(output->getUUID());
+
+    graph->addLink({1, idleClip->getOutputPin(), stateMachine->getStates()[idleState].inputPin});
+    graph->addLink({2, runClip->getOutputPin(), stateMachine->getStates()[runState].inputPin});
+    graph->addLink({3, stateMachine->getOutputPin(), output->getInputPin()});
+
+    graph->compilePlanIfDirty();
+
+    return graph;
+}
+
+// baked clip sampled at its keys has to match live evaluation of the graph it was baked from
+void runBakeCheck(const std::shared_ptr<AnimGraph>& graph, AnimationContext context, const BenchmarkRig& rig,
+                  const BenchmarkOptions& options, std::vector<BenchmarkResult>& results, AnimGraphChecks& outChecks)
+{
+    const Core::Resources::SkeletonData& skeletonData = *context.skeletonData;
+    const size_t boneCount = skeletonData.referencePose.size();
+
+    AnimGraphBakeSettings settings;
+    settings.clipName = rig.name + ":baked";
+    settings.endTime = options.clipSeconds;
+    settings.sampleRate = 30.f;
+    settings.parameterTracks.push_back(
+        {AnimParamID("run"), AnimParamType::Bool, {{0.f, 0.f}, {1.f, 1.f}, {2.5f, 0.f}}});
+
+    // per bone cost is cost of baking one frame of one bone
+    const size_t frameCount = static_cast<size_t>(settings.endTime * settings.sampleRate) + 1;
+    results.push_back(measure("bakeAnimGraph", std::max<size_t>(options.iterations / frameCount, 2),
+                              boneCount * frameCount,
+                              [&]
+                              {
+                                  AnimInstance instance(graph);
+                                  const AnimationClip clip = AnimGraphBaker::bake(instance, context, settings);
+                                  benchmarkSink = clip.duration;
+                              }));
+
+    AnimInstance bakeInstance(graph);
+    const AnimationClip baked = AnimGraphBaker::bake(bakeInstance, context, settings);
+    const AnimationClipBinding bakedBinding = AnimationsUtils::bindClipToSkeleton(baked, skeletonData);
+
+    AnimInstance liveInstance(graph);
+    AnimationScratch scratch;
+    context.scratch = &scratch;
+
+    std::vector<AnimationChannelCursor> bakedCursors;
+    Pose livePose;
+    Pose bakedPose;
+
+    // key times of the baked clip are frame numbers
+    for (size_t frame = 0; frame <= static_cast<size_t>(baked.duration); ++frame)
+    {
+        const float time = static_cast<float>(frame) / settings.sampleRate;
+
+        AnimGraphBaker::applyParameterTracks(liveInstance, settings.parameterTracks, time);
+        context.deltaTime = frame == 0 ? 0.f : 1.f / settings.sampleRate;
+        liveInstance.evaluate(context, livePose);
+
+        Animator::sampleClip(baked, bakedBinding, static_cast<float>(frame), skeletonData, bakedCursors, bakedPose);
+
+        for (size_t bone = 0; bone < boneCount; ++bone)
+        {
+            outChecks.bakeMaxPositionError = std::max(
+                outChecks.bakeMaxPositionError, glm::distance(livePose.positions[bone], bakedPose.positions[bone]));
+
+            const float dot = std::min(std::abs(glm::dot(livePose.rotations[bone], bakedPose.rotations[bone])), 1.f);
+            outChecks.bakeMaxRotationError = std::max(outChecks.bakeMaxRotationError, 2.f * std::acos(dot));
+        }
+    }
+
+    results.push_back(measure("evaluateAnimGraph", options.iterations, boneCount,
+                              [&]
+                              {
+                                  context.deltaTime = 1.f / 60.f;
+                                  liveInstance.evaluate(context, livePose);
+                                  benchmarkSink = livePose.positions[0].x;
+                              }));
+}
+
+// meshes are updated the way Animator does it, every mesh owns its instance and palette, every thread its scratch
+// palettes built with one thread have to equal the ones built on the pool matrix by matrix
+void runParallelPaletteCheck(const std::shared_ptr<AnimGraph>& graph, const AnimationContext& context,
+                             const BenchmarkOptions& options, std::vector<BenchmarkResult>& results,
+                             AnimGraphChecks& outChecks)
+{
+    constexpr size_t meshCount = 64;
+    constexpr size_t frameCount = 60;
+    constexpr AnimParamID run("run");
+
+    const Core::Resources::SkeletonData& skeletonData = *context.skeletonData;
+    const size_t boneCount = skeletonData.referencePose.size();
+
+    const auto updateMeshes = [&](Core::ThreadPool& threadPool, std::vector<std::unique_ptr<AnimInstance>>& instances,
+                                  std::vector<AnimationScratch>& scratches, std::vector<BonePalette>& palettes,
+                                  const size_t frame)
+    {
+        // meshes switch state at different frames, so states and transitions differ between them
+        for (size_t mesh = 0; mesh < meshCount; ++mesh)
+        {
+            instances[mesh]->setBool(run, (frame + mesh) % 40 < 20);
+        }
+
+        threadPool.parallelFor(meshCount,
+                               [&](const size_t mesh, const size_t threadIndex)
+                               {
+                                   AnimationContext meshContext = context;
+                                   meshContext.scratch = &scratches[threadIndex];
+                                   // different rates keep clip clocks of meshes apart
+                                   meshContext.deltaTime = (1.f + static_cast<float>(mesh % 4)) / 60.f;
+
+                                   instances[mesh]->evaluate(meshContext, scratches[threadIndex].pose);
+                                   Animator::buildGlobalTransforms(scratches[threadIndex].pose, skeletonData,
+                                                                   palettes[mesh]);
+                               });
+    };
+
+    const auto runMeshes = [&](const size_t threadCount, std::vector<BonePalette>& outPalettes)
+    {
+        Core::ThreadPool threadPool(threadCount);
+
+        std::vector<std::unique_ptr<AnimInstance>> instances;
+        for (size_t mesh = 0; mesh < meshCount; ++mesh)
+        {
+            instances.push_back(std::make_unique<AnimInstance>(graph));
+        }
+
+        std::vector<AnimationScratch> scratches(threadPool.getThreadCount());
+        outPalettes.assign(meshCount, {});
+
+        for (size_t frame = 0; frame < frameCount; ++frame)
+        {
+            updateMeshes(threadPool, instances, scratches, outPalettes, frame);
+        }
+
+        // timing continues from the checked frames on copies, so checked palettes stay as they are
+        std::vector<BonePalette> palettes = outPalettes;
+        size_t frame = frameCount;
+
+        // per bone cost is cost of one frame of all meshes per bone of one mesh
+        const std::string name = threadCount == 1 ? "updateMeshesSerial" : "updateMeshesParallel";
+        results.push_back(measure(name, std::max<size_t>(options.iterations / meshCount, 10), boneCount * meshCount,
+                                  [&]
+                                  {
+                                      updateMeshes(threadPool, instances, scratches, palettes, frame++);
+                                      benchmarkSink = palettes.back().globalTransforms.back()[3].x;
+                                  }));
+    };
+
+    std::vector<BonePalette> serialPalettes;
+    std::vector<BonePalette> parallelPalettes;
+
+    runMeshes(1, serialPalettes);
+    runMeshes(std::max<size_t>(std::thread::hardware_concurrency(), 4), parallelPalettes);
+
+    for (size_t mesh = 0; mesh < meshCount; ++mesh)
+    {
+        const std::vector<glm::mat4>& serial = serialPalettes[mesh].globalTransforms;
+        const std::vector<glm::mat4>& parallel = parallelPalettes[mesh].globalTransforms;
+
+        if (serial.size() != parallel.size())
+        {
+            outChecks.parallelPaletteMismatches += std::max(serial.size(), parallel.size());
+            continue;
+        }
+
+        for (size_t bone = 0; bone < serial.size(); ++bone)
+        {
+            if (serial[bone] != parallel[bone])
+            {
+                ++outChecks.parallelPaletteMismatches;
+            }
+        }
+    }
+}
+
+// first frames grow the pose pool and lay out runtimes, cursors and scratch, after that evaluation reuses them
+void runAllocationCheck(const std::shared_ptr<AnimGraph>& graph, AnimationContext context, AnimGraphChecks& outChecks)
+{
+    constexpr AnimParamID run("run");
+    constexpr size_t warmUpFrames = 80;
+    constexpr size_t checkedFrames = 240;
+
+    AnimInstance instance(graph);
+    AnimationScratch scratch;
+    context.scratch = &scratch;
+    context.deltaTime = 1.f / 60.f;
+
+    Pose pose;
+
+    // run toggles every 20 frames, so checked frames cover both states and both transitions
+    const auto update = [&](const size_t frame)
+    {
+        instance.setBool(run, frame % 40 < 20);
+        instance.evaluate(context, pose);
+    };
+
+    for (size_t frame = 0; frame < warmUpFrames; ++frame)
+    {
+        update(frame);
+    }
+
+    const size_t allocationsBefore = g_AllocationCount.load(std::memory_order_relaxed);
+
+    for (size_t frame = warmUpFrames; frame < warmUpFrames + checkedFrames; ++frame)
+    {
+        update(frame);
+    }
+
+    outChecks.steadyStateAllocations = g_AllocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+    benchmarkSink = pose.positions[0].x;
+}
+
+// random palettes and weights are skinned once the way primitive.vert did it with mat4 bones, and once with
+// vec4(p, 1) * mat3x4 over the rows Animator writes to PrimitiveData::bones
+SkinningChecks runSkinningCheck()
+{
+    constexpr size_t paletteCount = 32;
+    constexpr size_t boneCount = 48;
+    constexpr size_t vertexCount = 512;
+
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> unit(-1.f, 1.f);
+    std::uniform_int_distribution<int> boneIndex(0, static_cast<int>(boneCount) - 1);
+
+    const auto randomTransform = [&]
+    {
+        const glm::quat rotation = glm::normalize(glm::quat(unit(random), unit(random), unit(random), unit(random)));
+        const glm::vec3 scale(1.f + 0.5f * unit(random), 1.f + 0.5f * unit(random), 1.f + 0.5f * unit(random));
+
+        return glm::translate(glm::mat4(1.f), glm::vec3(unit(random), unit(random), unit(random)) * 5.f) *
+               glm::mat4_cast(rotation) * glm::scale(glm::mat4(1.f), scale);
+    };
+
+    const auto relativeError = [](const glm::vec3& expected, const glm::vec3& actual)
+    { return glm::length(expected - actual) / std::max(glm::length(expected), 1.f); };
+
+    SkinningChecks checks;
+
+    std::vector<Core::Renderer::Vertex> vertices(vertexCount);
+    std::vector<glm::vec3> kernelPositions(vertexCount);
+
+    for (size_t paletteIndex = 0; paletteIndex < paletteCount; ++paletteIndex)
+    {
+        BonePalette palette;
+        BonesInfo bonesInfo;
+
+        for (size_t bone = 0; bone < boneCount; ++bone)
+        {
+            palette.globalTransforms.push_back(randomTransform());
+            // primitive bones pick skeleton bones in a different order than they are stored
+            bonesInfo.bones.emplace_back(glm::inverse(randomTransform()), static_cast<int>(boneCount - 1 - bone));
+        }
+
+        Animator::buildSkinningTransforms(palette, bonesInfo);
+
+        for (Core::Renderer::Vertex& vertex : vertices)
+        {
+            vertex.position = glm::vec3(unit(random), unit(random), unit(random)) * 2.f;
+            vertex.normal = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)));
+
+            const glm::vec4 weights(std::abs(unit(random)), std::abs(unit(random)), std::abs(unit(random)),
+                                    std::abs(unit(random)));
+            vertex.weights = weights / (weights.x + weights.y + weights.z + weights.w);
+            vertex.boneID = glm::ivec4(boneIndex(random), boneIndex(random), boneIndex(random), boneIndex(random));
+        }
+
+        PoseKernels::skinPositions(vertices, bonesInfo.finalTransforms, kernelPositions.data());
+
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            const Core::Renderer::Vertex& vertex = vertices[i];
+
+            glm::mat4 oldTransform(0.f);
+            glm::mat3x4 newTransform(0.f);
+            for (int influence = 0; influence < 4; ++influence)
+            {
+                const Bone& bone = bonesInfo.bones[vertex.boneID[influence]];
+                oldTransform += palette.globalTransforms[bone.skeletonIndex] * bone.offset * vertex.weights[influence];
+                newTransform += bonesInfo.finalTransforms[vertex.boneID[influence]] * vertex.weights[influence];
+            }
+
+            const glm::vec3 oldPosition = glm::vec3(oldTransform * glm::vec4(vertex.position, 1.f));
+            const glm::vec3 newPosition = glm::vec4(vertex.position, 1.f) * newTransform;
+
+            const glm::vec3 oldNormal = glm::normalize(glm::mat3(oldTransform) * vertex.normal);
+            const glm::vec3 newNormal = glm::normalize(glm::vec4(vertex.normal, 0.f) * newTransform);
+
+            checks.maxPositionError = std::max(checks.maxPositionError, relativeError(oldPosition, newPosition));
+            checks.maxNormalError = std::max(checks.maxNormalError, relativeError(oldNormal, newNormal));
+            checks.maxKernelPositionError =
+                std::max(checks.maxKernelPositionError, relativeError(oldPosition, kernelPositions[i]));
+        }
+    }
+
+    return checks;
+}
+
+// graph checks run on clips registered in the database, the way meshes play them
+void runAnimGraphChecks(const BenchmarkRig& rig, const BenchmarkOptions& options,
+                        std::vector<BenchmarkResult>& results, AnimGraphChecks& outChecks)
+{
+    const Core::Resources::SkeletonData& skeletonData = rig.skeletonData;
+
+    if (rig.clips.empty() || skeletonData.referencePose.size() == 0)
+    {
+        return;
+    }
+
+    AnimationDatabase& database = AnimationDatabase::getInstance();
+
+    AnimationClip clipA = rig.clips.front();
+    clipA.name = rig.name + ":graphA";
+    AnimationClip clipB = rig.clips.size() > 1 ? rig.clips[1] : rig.clips.front();
+    clipB.name = rig.name + ":graphB";
+
+    const AnimationClipHandle handleA = database.add(std::move(clipA), skeletonData);
+    const AnimationClipHandle handleB = database.add(std::move(clipB), skeletonData);
+
+    const std::shared_ptr<AnimGraph> graph = buildSwitchGraph(handleA, handleB);
+
+    AnimationContext context;
+    context.skeletonData = &skeletonData;
+    context.database = &database;
+
+    runBakeCheck(graph, context, rig, options, results, outChecks);
+    runParallelPaletteCheck(graph, context, options, results, outChecks);
+    runAllocationCheck(graph, context, outChecks);
+
+    database.release(handleA, skeletonData);
+    database.release(handleB, skeletonData);
+}
+
+void printRig(const BenchmarkRig& rig, const std::vector<BenchmarkResult>& results, const AnimGraphChecks& checks,
+              const bool isLast)
+{
+    std::printf("    {\n");
+    std::printf("      \"name\": \"%s\",\n", rig.name.c_str());
+    std::printf("      \"bones\": %zu,\n", rig.skeletonData.referencePose.size());
+    std::printf("      \"clips\": %zu,\n", rig.clips.size());
+    std::printf("      \"ikChainLength\": %zu,\n", rig.ikChain.size());
+    std::printf("      \"bakeMaxPositionError\": %g,\n", checks.bakeMaxPositionError);
+    std::printf("      \"bakeMaxRotationError\": %g,\n", checks.bakeMaxRotationError);
+    std::printf("      \"parallelPaletteMismatches\": %zu,\n", checks.parallelPaletteMismatches);
+    std::printf("      \"steadyStateAllocations\": %zu,\n", checks.steadyStateAllocations);
+    std::printf("      \"results\": [\n");
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const BenchmarkResult& result = results[i];
+        std::printf("        {\"name\": \"%s\", \"nsPerCall\": %.1f, \"nsPerBone\": %.2f}%s\n", result.name.c_str(),
+                    result.nanosecondsPerCall, result.nanosecondsPerBone, i + 1 < results.size() ? "," : "");
+    }
+
+    std::printf("      ]\n");
+    std::printf("    }%s\n", isLast ? "" : ",");
+}
+
+bool loadMixamoRig(const BenchmarkOptions& options, BenchmarkRig& outRig)
+{
+    namespace fs = std::filesystem;
+
+    const fs::path modelsDirectory = fs::path(options.assetsDirectory) / "models";
+    const fs::path animationsDirectory = fs::path(options.assetsDirectory) / "animations";
+
+    std::error_code error;
+    if (!fs::is_directory(modelsDirectory, error) || !fs::is_directory(animationsDirectory, error))
+    {
+        return false;
+    }
+
+    for (const fs::directory_entry& entry : fs::directory_iterator(modelsDirectory, error))
+    {
+        if (entry.path().extension() == ".fbx")
+        {
+            outRig.name = entry.path().stem().string();
+            outRig.skeletonData = Core::Assets::ModelLoader::loadSkeletonFromFile(entry.path().string());
+            break;
+        }
+    }
+
+    if (outRig.skeletonData.referencePose.size() == 0)
+    {
+        return false;
+    }
+
+    for (const fs::directory_entry& entry : fs::directory_iterator(animationsDirectory, error))
+    {
+        if (entry.path().extension() == ".fbx")
+        {
+            std::vector<AnimationClip> clips = AnimationsUtils::loadAnimationsFromFile(entry.path().string());
+            outRig.clips.insert(outRig.clips.end(), std::make_move_iterator(clips.begin()),
+                                std::make_move_iterator(clips.end()));
+        }
+    }
+
+    outRig.ikChain = findDeepestChain(outRig.skeletonData, 4);
+
+    return !outRig.clips.empty();
+}
+
+bool parseOptions(const int argc, char** argv, BenchmarkOptions& outOptions)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* argument = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (!value)
+        {
+            std::fprintf(stderr, "missing value for %s\n", argument);
+            return false;
+        }
+
+        if (std::strcmp(argument, "--bones") == 0)
+        {
+            outOptions.boneCount = std::max<size_t>(std::strtoull(value, nullptr, 10), 1);
+        }
+        else if (std::strcmp(argument, "--depth") == 0)
+        {
+            outOptions.depth = std::max<size_t>(std::strtoull(value, nullptr, 10), 1);
+        }
+        else if (std::strcmp(argument, "--keys") == 0)
+        {
+            outOptions.keysPerSecond = std::max<size_t>(std::strtoull(value, nullptr, 10), 1);
+        }
+        else if (std::strcmp(argument, "--iterations") == 0)
+        {
+            outOptions.iterations = std::max<size_t>(std::strtoull(value, nullptr, 10), 1);
+        }
+        else if (std::strcmp(argument, "--assets") == 0)
+        {
+            outOptions.assetsDirectory = value;
+        }
+        else
+        {
+            std::fprintf(stderr, "unknown argument %s\n", argument);
+            return false;
+        }
+
+        ++i;
+    }
+
+    return true;
+}
+} // namespace
+
+int main(const int argc, char** argv)
+{
+    BenchmarkOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        return 1;
+    }
+
+    // importer logs would break json output
+    Logger::setLogLevel(0);
+
+    std::vector<BenchmarkRig> rigs;
+
+    BenchmarkRig& synthetic = rigs.emplace_back();
+    synthetic.name = "synthetic";
+    synthetic.skeletonData = buildSyntheticSkeleton(options.boneCount, options.depth);
+    synthetic.clips.push_back(buildSyntheticClip(synthetic.skeletonData, options.keysPerSecond, options.clipSeconds));
+    synthetic.clips.push_back(
+        buildSyntheticClip(synthetic.skeletonData, options.keysPerSecond * 2, options.clipSeconds * 0.5f));
+    synthetic.ikChain = findDeepestChain(synthetic.skeletonData, 4);
+
+    if (BenchmarkRig mixamo; loadMixamoRig(options, mixamo))
+    {
+        rigs.push_back(std::move(mixamo));
+    }
+
+    std::printf("{\n");
+    std::printf("  \"instructionSet\": \"%s\",\n",
+                PoseKernels::getInstructionSetName(PoseKernels::getInstructionSet()));
+    std::printf("  \"iterations\": %zu,\n", options.iterations);
+    std::printf("  \"depth\": %zu,\n", options.depth);
+    std::printf("  \"keysPerSecond\": %zu,\n", options.keysPerSecond);
+
+    const SkinningChecks skinningChecks = runSkinningCheck();
+    std::printf("  \"skinningMaxPositionError\": %g,\n", skinningChecks.maxPositionError);
+    std::printf("  \"skinningMaxNormalError\": %g,\n", skinningChecks.maxNormalError);
+    std::printf("  \"skinningMaxKernelPositionError\": %g,\n", skinningChecks.maxKernelPositionError);
+
+    std::printf("  \"rigs\": [\n");
+
+    bool isPassing = skinningChecks.isPassing();
+
+    for (size_t i = 0; i < rigs.size(); ++i)
+    {
+        std::vector<BenchmarkResult> results = runRig(rigs[i], options);
+
+        // synthetic rig comes first, its clips can be built at any length
+        if (i == 0)
+        {
+            runClipLengthSweep(rigs[i].skeletonData, options, results);
+        }
+
+        AnimGraphChecks checks;
+        runAnimGraphChecks(rigs[i], options, results, checks);
+        isPassing = isPassing && checks.isPassing();
+
+        printRig(rigs[i], results, checks, i + 1 == rigs.size());
+    }
+
+    std::printf("  ]\n");
+    std::printf("}\n");
+
+    if (!isPassing)
+    {
+        std::fprintf(stderr, "benchmark checks failed, see skinning fields and check fields of the rigs\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -20,7 +20,7 @@ const int MAX_BONES = 200;
 layout (set = 1, binding = 0) uniform PrimitiveData
 {
     mat4 model;
-    mat4 bones[MAX_BONES];
+    mat3x4 bones[MAX_BONES];
 } primitiveData;
 
 layout (set = 2, binding = 0) uniform sampler2D albedoMap;
@@ -22,7 +22,8 @@ const int MAX_BONES = 200;
 layout (set = 1, binding = 0) uniform PrimitiveData
 {
     mat4 model;
-    mat4 bones[MAX_BONES];
+    // columns hold rows of affine bone matrices, so vec4 * bone applies the transform
+    mat3x4 bones[MAX_BONES];
 } primitiveData;
 
 layout (push_constant) uniform PrimitiveFlagsPushConstants
@@ -32,7 +33,7 @@ layout (push_constant) uniform PrimitiveFlagsPushConstants
 
 void main()
 {
-    mat4 boneTransform = mat4(1.0f);
+    mat3x4 boneTransform = mat3x4(1.0f);
 
     if (pushConstants.useSkinning == 1)
     {
@@ -42,14 +43,14 @@ void main()
         boneTransform += primitiveData.bones[aBoneIDs[3]] * aWeights[3];
     }
 
-    vec4 animPos = boneTransform * vec4(aPos, 1.0);
+    vec4 animPos = vec4(vec4(aPos, 1.0) * boneTransform, 1.0);
 
     vec4 worldPosition = primitiveData.model * animPos;
     worldPos = worldPosition.xyz;
 
-    normal = normalize(mat3(primitiveData.model) * mat3(boneTransform) * aNormal);
+    normal = normalize(mat3(primitiveData.model) * (vec4(aNormal, 0.0) * boneTransform));
 
-    vec3 worldTangent = mat3(primitiveData.model) * mat3(boneTransform) * aTangent.xyz;
+    vec3 worldTangent = mat3(primitiveData.model) * (vec4(aTangent.xyz, 0.0) * boneTransform);
     tangent.xyz = normalize(worldTangent);
     tangent.w = aTangent.w;
 
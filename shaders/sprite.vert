@@ -16,7 +16,7 @@ layout (set = 1, binding = 0) uniform PrimitiveData
     mat4 model;
     // TODO
     // replace it with SpriteData and remove unused fields
-    mat4 bones[200];
+    mat3x4 bones[200];
 } primitiveData;
 
 void main() {
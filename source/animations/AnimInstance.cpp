@@ -2,74 +2,316 @@
 
 #include "AnimParamID.h"
 #include "AnimationsData.h"
+#include "AnimationsUtils.h"
 #include "anim-graph/AnimationContext.h"
+#include "core/Assertion.h"
 
-Core::Animations::Pose Core::Animations::AnimInstance::evaluate(AnimationContext& context)
+#include <algorithm>
+
+void Core::Animations::AnimInstance::evaluate(AnimationContext& context, Pose& outPose)
 {
+    SE_ASSERT(!mGraph->isPlanDirty(), "AnimGraph plan has to be compiled before evaluation");
+
     context.instance = this;
+    context.graph = mGraph.get();
+    context.posePool = &mPosePool;
+
+    syncRuntimes(*mGraph);
+    syncParameters();
+
+    const AnimGraphPlan& plan = mGraph->getPlan();
+    if (plan.isEmpty())
+    {
+        outPose = context.skeletonData->referencePose;
+        return;
+    }
+
+    const auto& instructions = plan.getInstructions();
+    const auto& inputSlots = plan.getInputSlots();
+
+    const size_t boneCount = context.skeletonData->referencePose.size();
+
+    const uint32_t prunedCount = updateNodeWeights(context);
+    if (context.scratch)
+    {
+        context.scratch->prunedSubgraphCount += prunedCount;
+    }
+
+    mSlotPoses.resize(plan.getPoseSlotCount());
+    for (Pose*& slotPose : mSlotPoses)
+    {
+        slotPose = &mPosePool.acquire(boneCount);
+    }
+
+    for (size_t i = 0; i < instructions.size(); ++i)
+    {
+        const AnimGraphPlan::Instruction& instruction = instructions[i];
+
+        // readers of a pruned node ignore its pose, so only its clock keeps running
+        if (mNodeRuntimes[i].weight < prunedInputWeight)
+        {
+            instruction.node->advanceTime(context, mNodeRuntimes[i]);
+            continue;
+        }
+
+        mInputPoses.clear();
+        for (uint32_t input = 0; input < instruction.inputCount; ++input)
+        {
+            const int slot = inputSlots[instruction.firstInput + input];
+            mInputPoses.push_back(slot >= 0 ? mSlotPoses[slot] : nullptr);
+        }
+
+        Pose& target = instruction.poseSlot >= 0 ? *mSlotPoses[instruction.poseSlot] : outPose;
+
+        instruction.node->evaluate(context, mInputPoses, mNodeRuntimes[i], target);
+    }
+
+    for (size_t slot = 0; slot < mSlotPoses.size(); ++slot)
+    {
+        mPosePool.release();
+    }
 
-    return mGraph->evaluate(context);
+    SE_ASSERT(mPosePool.getUsedCount() == 0, "Anim graph evaluation leaked pooled poses");
 }
 
-void Core::Animations::AnimInstance::setFloat(const std::string& name, float value)
+void Core::Animations::AnimInstance::advanceTime(AnimationContext& context)
 {
-    const uint32_t id = AnimParamID(name.c_str()).id;
-    mFloatParameters[id] = value;
+    SE_ASSERT(!mGraph->isPlanDirty(), "AnimGraph plan has to be compiled before evaluation");
+
+    context.instance = this;
+    context.graph = mGraph.get();
+    context.posePool = &mPosePool;
+
+    syncRuntimes(*mGraph);
+    syncParameters();
+
+    const auto& instructions = mGraph->getPlan().getInstructions();
+    for (size_t i = 0; i < instructions.size(); ++i)
+    {
+        instructions[i].node->advanceTime(context, mNodeRuntimes[i]);
+    }
 }
 
-void Core::Animations::AnimInstance::setBool(const std::string& name, bool value)
+size_t Core::Animations::AnimInstance::getSharingKey(const AnimationContext& context, const float timeQuantum) const
 {
-    const uint32_t id = AnimParamID(name.c_str()).id;
-    mBoolParameters[id] = value;
+    SE_ASSERT(mPlanVersion == mGraph->getPlanVersion(), "Node runtimes are not synced with AnimGraph plan");
+
+    const AnimGraphPlan& plan = mGraph->getPlan();
+
+    size_t key = plan.getStructureHash();
+
+    const auto& instructions = plan.getInstructions();
+    for (size_t i = 0; i < instructions.size(); ++i)
+    {
+        AnimationsUtils::hashCombine(key, instructions[i].node->getPropertiesHash());
+        AnimationsUtils::hashCombine(key, instructions[i].node->getStateHash(context, mNodeRuntimes[i], timeQuantum));
+    }
+
+    syncParameters();
+
+    // slot order follows declaration order, so equal graphs hash parameters in the same order
+    for (const float value : mFloatParameters)
+    {
+        AnimationsUtils::hashCombine(key, std::hash<float>{}(value));
+    }
+    for (const uint8_t value : mBoolParameters)
+    {
+        AnimationsUtils::hashCombine(key, std::hash<uint8_t>{}(value));
+    }
+
+    return key;
 }
 
-float Core::Animations::AnimInstance::getFloat(const std::string& name) const
+uint32_t Core::Animations::AnimInstance::updateNodeWeights(AnimationContext& context)
 {
-    const uint32_t id = AnimParamID(name.c_str()).id;
+    const AnimGraphPlan& plan = mGraph->getPlan();
+    const auto& instructions = plan.getInstructions();
+    const auto& inputInstructions = plan.getInputInstructions();
 
-    if (const auto it = mFloatParameters.find(id); it != mFloatParameters.end())
+    for (AnimGraphNodeRuntime& runtime : mNodeRuntimes)
     {
-        return it->second;
+        runtime.weight = 0.f;
     }
 
-    return 0.0f;
+    // output node is compiled last and passes the whole pose on
+    mNodeRuntimes.back().weight = 1.f;
+
+    // readers always come after their inputs, so walking backwards finishes every weight before it is read
+    for (size_t i = instructions.size(); i-- > 0;)
+    {
+        const AnimGraphPlan::Instruction& instruction = instructions[i];
+
+        const float weight = mNodeRuntimes[i].weight;
+        if (weight < prunedInputWeight)
+        {
+            continue;
+        }
+
+        mInputWeights.assign(instruction.inputCount, 1.f);
+        instruction.node->updateInputWeights(context, mNodeRuntimes[i], mInputWeights);
+
+        for (uint32_t input = 0; input < instruction.inputCount; ++input)
+        {
+            if (const int source = inputInstructions[instruction.firstInput + input]; source >= 0)
+            {
+                float& sourceWeight = mNodeRuntimes[source].weight;
+                sourceWeight = std::max(sourceWeight, weight * mInputWeights[input]);
+            }
+        }
+    }
+
+    uint32_t prunedCount = 0;
+    for (size_t i = 0; i < instructions.size(); ++i)
+    {
+        const AnimGraphPlan::Instruction& instruction = instructions[i];
+        if (mNodeRuntimes[i].weight < prunedInputWeight)
+        {
+            continue;
+        }
+
+        for (uint32_t input = 0; input < instruction.inputCount; ++input)
+        {
+            const int source = inputInstructions[instruction.firstInput + input];
+            if (source >= 0 && mNodeRuntimes[source].weight < prunedInputWeight)
+            {
+                ++prunedCount;
+            }
+        }
+    }
+
+    return prunedCount;
+}
+
+void Core::Animations::AnimInstance::syncRuntimes(const AnimGraph& graph)
+{
+    if (mPlanVersion == graph.getPlanVersion())
+    {
+        return;
+    }
+
+    const std::vector<AnimGraph::NodeID>& nodeIDs = graph.getPlan().getNodeIDs();
+
+    std::vector<AnimGraphNodeRuntime> runtimes(nodeIDs.size());
+    for (size_t i = 0; i < nodeIDs.size(); ++i)
+    {
+        if (const auto it = std::ranges::find(mRuntimeNodeIDs, nodeIDs[i]); it != mRuntimeNodeIDs.end())
+        {
+            runtimes[i] = std::move(mNodeRuntimes[it - mRuntimeNodeIDs.begin()]);
+        }
+    }
+
+    mNodeRuntimes = std::move(runtimes);
+    mRuntimeNodeIDs = nodeIDs;
+    mPlanVersion = graph.getPlanVersion();
 }
 
-bool Core::Animations::AnimInstance::getBool(const std::string& name) const
+void Core::Animations::AnimInstance::syncParameters() const
 {
-    const uint32_t id = AnimParamID(name.c_str()).id;
+    if (mParametersPlanVersion == mGraph->getPlanVersion())
+    {
+        return;
+    }
+
+    const AnimGraphPlan& plan = mGraph->getPlan();
 
-    if (const auto it = mBoolParameters.find(id); it != mBoolParameters.end())
+    std::vector<float> floatParameters = plan.getFloatParameterDefaults();
+    std::vector<uint8_t> boolParameters = plan.getBoolParameterDefaults();
+
+    // plan the old layout was built for is gone, so values are carried over by ids of their old slots
+    for (size_t slot = 0; slot < mFloatParameters.size() && slot < mFloatParameterIDs.size(); ++slot)
+    {
+        if (const AnimParamSlot newSlot = plan.findParameterSlot(mFloatParameterIDs[slot], AnimParamType::Float);
+            newSlot.isValid())
+        {
+            floatParameters[newSlot.index] = mFloatParameters[slot];
+        }
+    }
+
+    for (size_t slot = 0; slot < mBoolParameters.size() && slot < mBoolParameterIDs.size(); ++slot)
     {
-        return it->second;
+        if (const AnimParamSlot newSlot = plan.findParameterSlot(mBoolParameterIDs[slot], AnimParamType::Bool);
+            newSlot.isValid())
+        {
+            boolParameters[newSlot.index] = mBoolParameters[slot];
+        }
     }
 
-    return false;
+    mFloatParameters = std::move(floatParameters);
+    mBoolParameters = std::move(boolParameters);
+    mFloatParameterIDs = plan.getFloatParameterIDs();
+    mBoolParameterIDs = plan.getBoolParameterIDs();
+    mParametersPlanVersion = mGraph->getPlanVersion();
 }
 
 void Core::Animations::AnimInstance::setFloat(const AnimParamID id, const float value)
 {
-    mFloatParameters[id.id] = value;
+    // parameters declared a moment ago can be set right away
+    mGraph->compilePlanIfDirty();
+
+    setFloat(findFloatSlot(id), value);
 }
 
-void Core::Animations::AnimInstance::setBool(const AnimParamID id, const bool value) { mBoolParameters[id.id] = value; }
+void Core::Animations::AnimInstance::setBool(const AnimParamID id, const bool value)
+{
+    mGraph->compilePlanIfDirty();
+
+    setBool(findBoolSlot(id), value);
+}
 
 float Core::Animations::AnimInstance::getFloat(const AnimParamID id) const
 {
-    if (const auto it = mFloatParameters.find(id.id); it != mFloatParameters.end())
+    return getFloat(findFloatSlot(id));
+}
+
+bool Core::Animations::AnimInstance::getBool(const AnimParamID id) const
+{
+    return getBool(findBoolSlot(id));
+}
+
+Core::Animations::AnimParamSlot Core::Animations::AnimInstance::findSlot(AnimParamSlotCache& cache,
+                                                                        const AnimParamID id,
+                                                                        const AnimParamType type) const
+{
+    const uint32_t planVersion = mGraph->getPlanVersion();
+    if (cache.planVersion != planVersion || cache.id != id || cache.type != type)
     {
-        return it->second;
+        cache = {id, type, mGraph->getPlan().findParameterSlot(id, type), planVersion};
     }
 
-    return 0.0f;
+    return cache.slot;
 }
 
-bool Core::Animations::AnimInstance::getBool(AnimParamID id) const
+void Core::Animations::AnimInstance::setFloat(const AnimParamSlot slot, const float value)
 {
-    if (const auto it = mBoolParameters.find(id.id); it != mBoolParameters.end())
+    syncParameters();
+
+    if (slot.isValid() && slot.index < static_cast<int>(mFloatParameters.size()))
     {
-        return it->second;
+        mFloatParameters[slot.index] = value;
     }
+}
+
+void Core::Animations::AnimInstance::setBool(const AnimParamSlot slot, const bool value)
+{
+    syncParameters();
 
-    return false;
-}
\ No newline at end of file
+    if (slot.isValid() && slot.index < static_cast<int>(mBoolParameters.size()))
+    {
+        mBoolParameters[slot.index] = value;
+    }
+}
+
+float Core::Animations::AnimInstance::getFloat(const AnimParamSlot slot) const
+{
+    syncParameters();
+
+    return slot.isValid() && slot.index < static_cast<int>(mFloatParameters.size()) ? mFloatParameters[slot.index]
+                                                                                     : 0.f;
+}
+
+bool Core::Animations::AnimInstance::getBool(const AnimParamSlot slot) const
+{
+    syncParameters();
+
+    return slot.isValid() && slot.index < static_cast<int>(mBoolParameters.size()) && mBoolParameters[slot.index];
+}
@@ -1,42 +1,96 @@
 #pragma once
 
+#include "AnimParamID.h"
 #include "anim-graph/AnimGraph.h"
 #include "anim-graph/nodes/AnimGraphNodeRuntime.h"
+#include "PosePool.h"
 
-#include <string>
-#include <unordered_map>
+#include <string_view>
 
 namespace Core::Animations
 {
-struct AnimParamID;
 class AnimInstance
 {
 public:
     explicit AnimInstance(std::shared_ptr<AnimGraph> graph) : mGraph(std::move(graph)) {}
 
-    Pose evaluate(AnimationContext& context);
+    // executes compiled plan of the graph, graph plan has to be compiled beforehand
+    void evaluate(AnimationContext& context, Pose& outPose);
 
-    void setFloat(const std::string& name, float value);
-    void setBool(const std::string& name, bool value);
+    // advances time of every node without evaluating poses
+    void advanceTime(AnimationContext& context);
 
-    [[nodiscard]] float getFloat(const std::string& name) const;
-    [[nodiscard]] bool getBool(const std::string& name) const;
+    // instances with equal keys evaluate to the same pose, node times are snapped to timeQuantum seconds
+    // only meaningful for graphs whose plan can share poses
+    [[nodiscard]] size_t getSharingKey(const AnimationContext& context, float timeQuantum) const;
 
+    // parameters have to be declared on the graph, values of undeclared ones are dropped and read as 0
+    // names are hashed on every call, ids built from literals are hashed at compile time
+    void setFloat(std::string_view name, float value) { setFloat(AnimParamID(name), value); }
+    void setBool(std::string_view name, bool value) { setBool(AnimParamID(name), value); }
+
+    [[nodiscard]] float getFloat(std::string_view name) const { return getFloat(AnimParamID(name)); }
+    [[nodiscard]] bool getBool(std::string_view name) const { return getBool(AnimParamID(name)); }
+
+    // binary search over declared parameters of the compiled plan, setters compile a dirty plan first,
+    // so they have to run on the thread editing the graph
     void setFloat(AnimParamID id, float value);
     void setBool(AnimParamID id, bool value);
 
     [[nodiscard]] float getFloat(AnimParamID id) const;
     [[nodiscard]] bool getBool(AnimParamID id) const;
 
-    [[nodiscard]] AnimGraphNodeRuntime& getRuntime(const AnimGraph::NodeID id) { return mNodeRuntime[id]; }
+    // slots let code setting parameters every frame skip the lookup, they change only when graph is recompiled
+    [[nodiscard]] AnimParamSlot findFloatSlot(const AnimParamID id) const
+    {
+        return mGraph->getPlan().findParameterSlot(id, AnimParamType::Float);
+    }
+
+    [[nodiscard]] AnimParamSlot findBoolSlot(const AnimParamID id) const
+    {
+        return mGraph->getPlan().findParameterSlot(id, AnimParamType::Bool);
+    }
+
+    // slot of cache is reused while the plan and the parameter stay the same, for nodes reading parameters every frame
+    [[nodiscard]] AnimParamSlot findSlot(AnimParamSlotCache& cache, AnimParamID id, AnimParamType type) const;
+
+    void setFloat(AnimParamSlot slot, float value);
+    void setBool(AnimParamSlot slot, bool value);
+
+    [[nodiscard]] float getFloat(AnimParamSlot slot) const;
+    [[nodiscard]] bool getBool(AnimParamSlot slot) const;
 
 private:
     std::shared_ptr<AnimGraph> mGraph;
 
-    std::unordered_map<uint32_t, float> mFloatParameters;
-    std::unordered_map<uint32_t, bool> mBoolParameters;
+    // indexed by parameter slot of the plan with mParametersPlanVersion
+    // laid out lazily, so reads after a recompile already see the new slots
+    mutable std::vector<float> mFloatParameters;
+    mutable std::vector<uint8_t> mBoolParameters;
+    mutable std::vector<AnimParamID> mFloatParameterIDs;
+    mutable std::vector<AnimParamID> mBoolParameterIDs;
+    mutable uint32_t mParametersPlanVersion = 0;
+
+    // indexed by plan instruction, laid out for plan with mPlanVersion
+    std::vector<AnimGraphNodeRuntime> mNodeRuntimes;
+    std::vector<AnimGraph::NodeID> mRuntimeNodeIDs;
+    uint32_t mPlanVersion = 0;
+
+    // temporaries of graph nodes, reused every evaluation
+    PosePool mPosePool;
+
+    std::vector<Pose*> mSlotPoses;
+    std::vector<const Pose*> mInputPoses;
+    std::vector<float> mInputWeights;
+
+    // moves runtimes of nodes that survived a graph edit to their new plan index
+    void syncRuntimes(const AnimGraph& graph);
+
+    // lays parameter values out for the current plan, values of parameters still declared are kept
+    void syncParameters() const;
 
-    std::unordered_map<AnimGraph::NodeID, AnimGraphNodeRuntime> mNodeRuntime;
+    // fills weights of node runtimes from output down, returns number of inputs pruned by evaluated nodes
+    uint32_t updateNodeWeights(AnimationContext& context);
 };
 
 } // namespace Core::Animations
\ No newline at end of file
@@ -1,15 +1,77 @@
 #pragma once
 
+#include <compare>
+#include <cstddef>
 #include <cstdint>
-#include <functional>
+#include <string>
 #include <string_view>
 
 namespace Core::Animations
 {
+// 32-bit fnv-1a, constexpr so ids of literal names are folded at compile time
+[[nodiscard]] constexpr uint32_t hashAnimParamName(const std::string_view name)
+{
+    uint32_t hash = 2166136261u;
+    for (const char character : name)
+    {
+        hash = (hash ^ static_cast<uint8_t>(character)) * 16777619u;
+    }
+    return hash;
+}
+
 struct AnimParamID
 {
-    uint32_t id;
+    uint32_t id = 0;
+
+    constexpr AnimParamID() = default;
 
-    explicit AnimParamID(const char* string) : id(std::hash<std::string_view>{}(string)) {}
+    constexpr explicit AnimParamID(const std::string_view name) : id(hashAnimParamName(name)) {}
+
+    constexpr explicit AnimParamID(const char* name) : AnimParamID(std::string_view(name)) {}
+
+    friend constexpr auto operator<=>(AnimParamID, AnimParamID) = default;
+};
+
+enum class AnimParamType : uint8_t
+{
+    Float,
+    Bool
+};
+
+// parameter graph nodes read, instances hold its value in a flat array at the slot assigned on plan compile
+struct AnimParamDeclaration
+{
+    std::string name;
+    AnimParamID id;
+    AnimParamType type = AnimParamType::Float;
+    // bools use 0 and 1
+    float defaultValue = 0.f;
 };
+
+// index of a parameter in value arrays of AnimInstance, valid until graph plan is recompiled
+struct AnimParamSlot
+{
+    int index = -1;
+
+    [[nodiscard]] constexpr bool isValid() const { return index >= 0; }
+};
+
+// slot of a parameter a node reads every frame, searched again only after a recompile or a change of the parameter
+struct AnimParamSlotCache
+{
+    AnimParamID id;
+    AnimParamType type = AnimParamType::Float;
+    AnimParamSlot slot;
+    // plan version the slot was found in, compiled plans start at 1
+    uint32_t planVersion = 0;
+};
+
+namespace Literals
+{
+// "speed"_param is hashed by the compiler
+consteval AnimParamID operator""_param(const char* name, const size_t length)
+{
+    return AnimParamID(std::string_view(name, length));
+}
+} // namespace Literals
 } // namespace Core::Animations
@@ -0,0 +1,348 @@
+#include "AnimationClipCache.h"
+
+#include "core/MappedFile.h"
+#include "tools/Logger.h"
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <type_traits>
+
+namespace
+{
+using namespace Core::Animations;
+
+static_assert(std::is_trivially_copyable_v<KeyframeVec3> && std::is_trivially_copyable_v<KeyframeQuat>,
+              "Keyframes are stored in the cache in their memory layout");
+
+constexpr uint32_t cacheMagic = 0x4D494E41; // "ANIM"
+
+// sections start at this alignment, so key arrays can be used in place
+constexpr uint64_t sectionAlignment = 16;
+
+struct CacheHeader
+{
+    uint32_t magic = cacheMagic;
+    uint32_t version = AnimationClipCache::version;
+
+    // identity of the source file the cache was built from
+    uint64_t sourceSize = 0;
+    int64_t sourceWriteTime = 0;
+    uint64_t sourceHash = 0;
+
+    uint32_t clipCount = 0;
+    uint32_t channelCount = 0;
+
+    uint64_t clipsOffset = 0;
+    uint64_t channelsOffset = 0;
+    uint64_t vec3KeysOffset = 0;
+    uint64_t vec3KeyCount = 0;
+    uint64_t quatKeysOffset = 0;
+    uint64_t quatKeyCount = 0;
+    uint64_t stringsOffset = 0;
+    uint64_t stringsSize = 0;
+};
+
+struct CacheClip
+{
+    uint32_t nameOffset = 0;
+    uint32_t nameSize = 0;
+    float duration = 0.f;
+    float ticksPerSecond = 0.f;
+    uint32_t firstChannel = 0;
+    uint32_t channelCount = 0;
+};
+
+// key ranges index the vec3 and quat key sections
+struct CacheChannel
+{
+    uint32_t nameOffset = 0;
+    uint32_t nameSize = 0;
+    uint32_t firstPosition = 0;
+    uint32_t positionCount = 0;
+    uint32_t firstRotation = 0;
+    uint32_t rotationCount = 0;
+    uint32_t firstScaling = 0;
+    uint32_t scalingCount = 0;
+};
+
+struct SourceFileInfo
+{
+    uint64_t size = 0;
+    int64_t writeTime = 0;
+};
+
+bool getSourceFileInfo(const std::string& path, SourceFileInfo& outInfo)
+{
+    std::error_code error;
+
+    outInfo.size = std::filesystem::file_size(path, error);
+    if (error)
+    {
+        return false;
+    }
+
+    outInfo.writeTime = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+
+    return !error;
+}
+
+// FNV-1a over the whole file, only needed when write time doesn't match anymore
+uint64_t hashFile(const std::string& path)
+{
+    Core::MappedFile file;
+    if (!file.open(path))
+    {
+        return 0;
+    }
+
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < file.getSize(); ++i)
+    {
+        hash ^= static_cast<uint64_t>(file.getData()[i]);
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+uint64_t alignOffset(const uint64_t offset) { return (offset + sectionAlignment - 1) & ~(sectionAlignment - 1); }
+
+bool isRangeInFile(const uint64_t offset, const uint64_t size, const size_t fileSize)
+{
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+template <typename T> const T* getSection(const Core::MappedFile& file, const uint64_t offset, const uint64_t count)
+{
+    if (offset % alignof(T) != 0 || count > file.getSize() / sizeof(T) ||
+        !isRangeInFile(offset, count * sizeof(T), file.getSize()))
+    {
+        return nullptr;
+    }
+
+    return reinterpret_cast<const T*>(file.getData() + offset);
+}
+} // namespace
+
+std::string Core::Animations::AnimationClipCache::getCachePath(const std::string& sourcePath)
+{
+    return sourcePath + ".seanim";
+}
+
+bool Core::Animations::AnimationClipCache::load(const std::string& sourcePath, std::vector<AnimationClip>& outClips)
+{
+    SourceFileInfo sourceInfo;
+    if (!getSourceFileInfo(sourcePath, sourceInfo))
+    {
+        return false;
+    }
+
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(getCachePath(sourcePath)))
+    {
+        return false;
+    }
+
+    const auto* header = getSection<CacheHeader>(*file, 0, 1);
+    if (!header || header->magic != cacheMagic || header->version != version)
+    {
+        return false;
+    }
+
+    if (header->sourceSize != sourceInfo.size)
+    {
+        return false;
+    }
+
+    // touched but unchanged sources, e.g. after a checkout, keep their cache
+    const bool isWriteTimeStale = header->sourceWriteTime != sourceInfo.writeTime;
+    if (isWriteTimeStale && header->sourceHash != hashFile(sourcePath))
+    {
+        return false;
+    }
+
+    const auto* clips = getSection<CacheClip>(*file, header->clipsOffset, header->clipCount);
+    const auto* channels = getSection<CacheChannel>(*file, header->channelsOffset, header->channelCount);
+    const auto* vec3Keys = getSection<KeyframeVec3>(*file, header->vec3KeysOffset, header->vec3KeyCount);
+    const auto* quatKeys = getSection<KeyframeQuat>(*file, header->quatKeysOffset, header->quatKeyCount);
+    const auto* strings = getSection<char>(*file, header->stringsOffset, header->stringsSize);
+
+    if (!clips || !channels || !vec3Keys || !quatKeys || !strings)
+    {
+        Logger::log(1, "Animation cache of %s is corrupted\n", sourcePath.c_str());
+        return false;
+    }
+
+    auto getString = [strings, header](const uint32_t offset, const uint32_t size, std::string& outString)
+    {
+        if (!isRangeInFile(offset, size, header->stringsSize))
+        {
+            return false;
+        }
+
+        outString.assign(strings + offset, size);
+        return true;
+    };
+
+    std::vector<AnimationClip> loadedClips(header->clipCount);
+
+    for (uint32_t clipIndex = 0; clipIndex < header->clipCount; ++clipIndex)
+    {
+        const CacheClip& cacheClip = clips[clipIndex];
+        AnimationClip& clip = loadedClips[clipIndex];
+
+        if (!getString(cacheClip.nameOffset, cacheClip.nameSize, clip.name) ||
+            !isRangeInFile(cacheClip.firstChannel, cacheClip.channelCount, header->channelCount))
+        {
+            Logger::log(1, "Animation cache of %s is corrupted\n", sourcePath.c_str());
+            return false;
+        }
+
+        clip.duration = cacheClip.duration;
+        clip.ticksPerSecond = cacheClip.ticksPerSecond;
+        clip.keyStorage = file;
+        clip.channels.resize(cacheClip.channelCount);
+
+        for (uint32_t i = 0; i < cacheClip.channelCount; ++i)
+        {
+            const CacheChannel& cacheChannel = channels[cacheClip.firstChannel + i];
+            AnimationChannel& channel = clip.channels[i];
+
+            if (!getString(cacheChannel.nameOffset, cacheChannel.nameSize, channel.boneName) ||
+                !isRangeInFile(cacheChannel.firstPosition, cacheChannel.positionCount, header->vec3KeyCount) ||
+                !isRangeInFile(cacheChannel.firstRotation, cacheChannel.rotationCount, header->quatKeyCount) ||
+                !isRangeInFile(cacheChannel.firstScaling, cacheChannel.scalingCount, header->vec3KeyCount))
+            {
+                Logger::log(1, "Animation cache of %s is corrupted\n", sourcePath.c_str());
+                return false;
+            }
+
+            channel.positions = {vec3Keys + cacheChannel.firstPosition, cacheChannel.positionCount};
+            channel.rotations = {quatKeys + cacheChannel.firstRotation, cacheChannel.rotationCount};
+            channel.scalings = {vec3Keys + cacheChannel.firstScaling, cacheChannel.scalingCount};
+        }
+    }
+
+    outClips = std::move(loadedClips);
+
+    // cache is rewritten with the new write time, so later loads don't hash the source again
+    // loaded clips keep the old mapping, it stays valid after the cache file is replaced
+    if (isWriteTimeStale)
+    {
+        save(sourcePath, outClips);
+    }
+
+    return true;
+}
+
+bool Core::Animations::AnimationClipCache::save(const std::string& sourcePath, const std::vector<AnimationClip>& clips)
+{
+    SourceFileInfo sourceInfo;
+    if (!getSourceFileInfo(sourcePath, sourceInfo))
+    {
+        return false;
+    }
+
+    CacheHeader header;
+    header.sourceSize = sourceInfo.size;
+    header.sourceWriteTime = sourceInfo.writeTime;
+    header.sourceHash = hashFile(sourcePath);
+
+    std::vector<CacheClip> cacheClips;
+    std::vector<CacheChannel> cacheChannels;
+    std::vector<KeyframeVec3> vec3Keys;
+    std::vector<KeyframeQuat> quatKeys;
+    std::string strings;
+
+    auto addString = [&strings](const std::string& string, uint32_t& outOffset, uint32_t& outSize)
+    {
+        outOffset = static_cast<uint32_t>(strings.size());
+        outSize = static_cast<uint32_t>(string.size());
+        strings += string;
+    };
+
+    for (const AnimationClip& clip : clips)
+    {
+        CacheClip& cacheClip = cacheClips.emplace_back();
+        addString(clip.name, cacheClip.nameOffset, cacheClip.nameSize);
+        cacheClip.duration = clip.duration;
+        cacheClip.ticksPerSecond = clip.ticksPerSecond;
+        cacheClip.firstChannel = static_cast<uint32_t>(cacheChannels.size());
+        cacheClip.channelCount = static_cast<uint32_t>(clip.channels.size());
+
+        for (const AnimationChannel& channel : clip.channels)
+        {
+            CacheChannel& cacheChannel = cacheChannels.emplace_back();
+            addString(channel.boneName, cacheChannel.nameOffset, cacheChannel.nameSize);
+
+            cacheChannel.firstPosition = static_cast<uint32_t>(vec3Keys.size());
+            cacheChannel.positionCount = static_cast<uint32_t>(channel.positions.size());
+            vec3Keys.insert(vec3Keys.end(), channel.positions.begin(), channel.positions.end());
+
+            cacheChannel.firstRotation = static_cast<uint32_t>(quatKeys.size());
+            cacheChannel.rotationCount = static_cast<uint32_t>(channel.rotations.size());
+            quatKeys.insert(quatKeys.end(), channel.rotations.begin(), channel.rotations.end());
+
+            cacheChannel.firstScaling = static_cast<uint32_t>(vec3Keys.size());
+            cacheChannel.scalingCount = static_cast<uint32_t>(channel.scalings.size());
+            vec3Keys.insert(vec3Keys.end(), channel.scalings.begin(), channel.scalings.end());
+        }
+    }
+
+    header.clipCount = static_cast<uint32_t>(cacheClips.size());
+    header.channelCount = static_cast<uint32_t>(cacheChannels.size());
+    header.vec3KeyCount = vec3Keys.size();
+    header.quatKeyCount = quatKeys.size();
+    header.stringsSize = strings.size();
+
+    header.clipsOffset = alignOffset(sizeof(CacheHeader));
+    header.channelsOffset = alignOffset(header.clipsOffset + cacheClips.size() * sizeof(CacheClip));
+    header.vec3KeysOffset = alignOffset(header.channelsOffset + cacheChannels.size() * sizeof(CacheChannel));
+    header.quatKeysOffset = alignOffset(header.vec3KeysOffset + vec3Keys.size() * sizeof(KeyframeVec3));
+    header.stringsOffset = alignOffset(header.quatKeysOffset + quatKeys.size() * sizeof(KeyframeQuat));
+
+    // written next to the cache first, so a failed write never leaves a truncated cache behind
+    const std::string cachePath = getCachePath(sourcePath);
+    const std::string temporaryPath = cachePath + ".tmp";
+
+    {
+        std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!stream)
+        {
+            Logger::log(1, "Failed to write animation cache %s\n", cachePath.c_str());
+            return false;
+        }
+
+        auto writeSection = [&stream](const uint64_t offset, const void* data, const size_t size)
+        {
+            static constexpr char padding[sectionAlignment] = {};
+            stream.write(padding, static_cast<std::streamsize>(offset - static_cast<uint64_t>(stream.tellp())));
+            stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        };
+
+        writeSection(0, &header, sizeof(CacheHeader));
+        writeSection(header.clipsOffset, cacheClips.data(), cacheClips.size() * sizeof(CacheClip));
+        writeSection(header.channelsOffset, cacheChannels.data(), cacheChannels.size() * sizeof(CacheChannel));
+        writeSection(header.vec3KeysOffset, vec3Keys.data(), vec3Keys.size() * sizeof(KeyframeVec3));
+        writeSection(header.quatKeysOffset, quatKeys.data(), quatKeys.size() * sizeof(KeyframeQuat));
+        writeSection(header.stringsOffset, strings.data(), strings.size());
+
+        if (!stream)
+        {
+            Logger::log(1, "Failed to write animation cache %s\n", cachePath.c_str());
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, cachePath, error);
+    if (error)
+    {
+        std::filesystem::remove(temporaryPath, error);
+        Logger::log(1, "Failed to write animation cache %s\n", cachePath.c_str());
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "AnimationsData.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Core::Animations
+{
+// binary cache of all clips imported from one source file, kept next to it as <source>.seanim
+// key arrays are stored in memory layout, so loaded clips point straight into the mapped cache file
+class AnimationClipCache
+{
+public:
+    // bump on any change of the file layout or of the imported data
+    static constexpr uint32_t version = 1;
+
+    // returns false if cache is missing, has another version or was built from a different source file
+    [[nodiscard]] static bool load(const std::string& sourcePath, std::vector<AnimationClip>& outClips);
+
+    static bool save(const std::string& sourcePath, const std::vector<AnimationClip>& clips);
+
+    [[nodiscard]] static std::string getCachePath(const std::string& sourcePath);
+};
+} // namespace Core::Animations
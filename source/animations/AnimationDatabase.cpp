@@ -0,0 +1,154 @@
+#include "AnimationDatabase.h"
+
+#include "AnimationsUtils.h"
+#include "asset-manager/assets/AnimationAsset.h"
+#include "compression/AnimationCompression.h"
+#include "core/Assertion.h"
+#include "tools/Logger.h"
+#include "utils/FileUtils.h"
+
+#include <algorithm>
+
+Core::Animations::AnimationClipHandle
+Core::Animations::AnimationDatabase::acquire(const std::string& path, const Resources::SkeletonData& skeletonData,
+                                             const AnimationCompressionSettings& compressionSettings)
+{
+    const std::string key = Utils::FileUtils::getRelativePath(path);
+
+    AnimationClipHandle handle;
+
+    if (const auto it = mEntryByPath.find(key); it != mEntryByPath.end())
+    {
+        handle.id = it->second;
+    }
+    else
+    {
+        // asset is not cached in AssetManager, so once the clip is compressed or released nothing keeps its keys alive
+        const Assets::AnimationAsset asset(key);
+        if (asset.getClips().empty() || asset.getClips().front().channels.empty())
+        {
+            return {};
+        }
+
+        // copy only owns channel names, keys storage is the last thing left of the asset
+        auto clip = std::make_shared<AnimationClip>(asset.getClips().front());
+
+        if (compressionSettings.enabled)
+        {
+            const size_t uncompressedSize = AnimationCompression::getUncompressedMemoryUsage(*clip);
+
+            AnimationCompression::compressInPlace(*clip, &skeletonData, compressionSettings);
+
+            Logger::log(1, "Animation %s compressed from %zu to %zu bytes", path.c_str(), uncompressedSize,
+                        clip->compressed->getMemoryUsage());
+        }
+
+        handle.id = static_cast<uint32_t>(mEntries.size());
+
+        Entry& entry = mEntries.emplace_back();
+        entry.path = key;
+        entry.clip = std::move(clip);
+
+        mEntryByPath.emplace(key, handle.id);
+    }
+
+    Entry& entry = mEntries[handle.id];
+    ++entry.refCount;
+
+    const auto binding = std::ranges::find(entry.bindings, &skeletonData, &SkeletonBinding::skeleton);
+    if (binding != entry.bindings.end())
+    {
+        ++binding->refCount;
+    }
+    else
+    {
+        entry.bindings.push_back({&skeletonData, AnimationsUtils::bindClipToSkeleton(*entry.clip, skeletonData), 1});
+    }
+
+    return handle;
+}
+
+Core::Animations::AnimationClipHandle
+Core::Animations::AnimationDatabase::add(AnimationClip clip, const Resources::SkeletonData& skeletonData)
+{
+    if (clip.channels.empty() || mEntryByPath.contains(clip.name))
+    {
+        Logger::log(1, "Animation %s can't be added to the database", clip.name.c_str());
+        return {};
+    }
+
+    AnimationClipHandle handle;
+    handle.id = static_cast<uint32_t>(mEntries.size());
+
+    Entry& entry = mEntries.emplace_back();
+    entry.path = clip.name;
+    entry.bindings.push_back({&skeletonData, AnimationsUtils::bindClipToSkeleton(clip, skeletonData), 1});
+    entry.clip = std::make_shared<AnimationClip>(std::move(clip));
+    entry.refCount = 1;
+
+    mEntryByPath.emplace(entry.path, handle.id);
+
+    return handle;
+}
+
+void Core::Animations::AnimationDatabase::release(const AnimationClipHandle handle,
+                                                  const Resources::SkeletonData& skeletonData)
+{
+    if (!handle.isValid() || handle.id >= mEntries.size())
+    {
+        return;
+    }
+
+    Entry& entry = mEntries[handle.id];
+    SE_ASSERT(entry.refCount > 0, "Animation clip released more times than acquired");
+
+    const auto binding = std::ranges::find(entry.bindings, &skeletonData, &SkeletonBinding::skeleton);
+    SE_ASSERT(binding != entry.bindings.end(), "Animation clip released with a skeleton it was not acquired with");
+
+    if (binding != entry.bindings.end() && --binding->refCount == 0)
+    {
+        entry.bindings.erase(binding);
+    }
+
+    if (--entry.refCount > 0)
+    {
+        return;
+    }
+
+    mEntryByPath.erase(entry.path);
+
+    entry.clip.reset();
+    entry.bindings = {};
+    entry.path = {};
+}
+
+const Core::Animations::AnimationClip*
+Core::Animations::AnimationDatabase::getClip(const AnimationClipHandle handle) const
+{
+    if (!handle.isValid() || handle.id >= mEntries.size())
+    {
+        return nullptr;
+    }
+
+    return mEntries[handle.id].clip.get();
+}
+
+const Core::Animations::AnimationClipBinding*
+Core::Animations::AnimationDatabase::getBinding(const AnimationClipHandle handle,
+                                                const Resources::SkeletonData& skeletonData) const
+{
+    if (!handle.isValid() || handle.id >= mEntries.size())
+    {
+        return nullptr;
+    }
+
+    for (const SkeletonBinding& binding : mEntries[handle.id].bindings)
+    {
+        if (binding.skeleton == &skeletonData)
+        {
+            return &binding.binding;
+        }
+    }
+
+    return nullptr;
+}
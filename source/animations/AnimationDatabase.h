@@ -0,0 +1,93 @@
+#pragma once
+
+#include "AnimationsData.h"
+#include "core/Singleton.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Core::Resources
+{
+struct SkeletonData;
+}
+
+namespace Core::Animations
+{
+struct AnimationCompressionSettings;
+
+// stable for the whole process lifetime, ids of released clips are never reused
+struct AnimationClipHandle
+{
+    static constexpr uint32_t invalidID = UINT32_MAX;
+
+    uint32_t id = invalidID;
+
+    [[nodiscard]] bool isValid() const { return id != invalidID; }
+
+    bool operator==(const AnimationClipHandle&) const = default;
+};
+
+// process-wide store of immutable clips keyed by asset path, every mesh playing a clip shares one copy of it
+// mutated on the main thread only, graph evaluation on workers only reads it
+class AnimationDatabase final : public Singleton<AnimationDatabase>
+{
+    friend class Singleton;
+
+public:
+    // loads first clip of the file on first request and binds it to skeletonData, the file is loaded by the
+    // database itself, so keys of released or compressed clips are freed instead of staying in AssetManager
+    // every successful acquire has to be paired with release of the same skeleton
+    // compression tolerances come from the skeleton of the first acquire, later skeletons play the same keys
+    [[nodiscard]] AnimationClipHandle acquire(const std::string& path, const Resources::SkeletonData& skeletonData,
+                                              const AnimationCompressionSettings& compressionSettings);
+
+    // registers a clip built at runtime, such as a baked graph, under clip name and binds it to skeletonData
+    // returned handle holds one reference, invalid if the name is already taken
+    [[nodiscard]] AnimationClipHandle add(AnimationClip clip, const Resources::SkeletonData& skeletonData);
+
+    // binding of skeletonData is dropped once its last user released it, so a skeleton allocated later
+    // at the same address never sees it, clip is freed once its last user released it
+    void release(AnimationClipHandle handle, const Resources::SkeletonData& skeletonData);
+
+    // nullptr for invalid or released handles
+    [[nodiscard]] const AnimationClip* getClip(AnimationClipHandle handle) const;
+
+    // nullptr if no mesh with this skeleton acquired the clip
+    [[nodiscard]] const AnimationClipBinding* getBinding(AnimationClipHandle handle,
+                                                         const Resources::SkeletonData& skeletonData) const;
+
+    [[nodiscard]] size_t getLoadedClipCount() const { return mEntryByPath.size(); }
+
+private:
+    AnimationDatabase() = default;
+
+    struct SkeletonBinding
+    {
+        const Resources::SkeletonData* skeleton = nullptr;
+        AnimationClipBinding binding;
+        // acquires made with this skeleton that were not released yet
+        uint32_t refCount = 0;
+    };
+
+    struct Entry
+    {
+        std::string path;
+
+        std::shared_ptr<const AnimationClip> clip;
+
+        // skeletons are few, so a linear search beats hashing
+        std::vector<SkeletonBinding> bindings;
+
+        uint32_t refCount = 0;
+    };
+
+    // indexed by handle id
+    std::vector<Entry> mEntries;
+
+    std::unordered_map<std::string, uint32_t> mEntryByPath;
+};
+} // namespace Core::Animations
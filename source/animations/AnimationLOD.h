@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace Core::Animations
+{
+// LOD 0 is evaluated every frame, every next LOD less often
+inline constexpr size_t animationLODCount = 4;
+
+// meshes outside of the view only advance their clip times, their pose is evaluated once they are visible again
+inline constexpr size_t offScreenAnimationLOD = animationLODCount;
+
+struct AnimationLODSettings
+{
+    bool enabled = true;
+
+    // projected bounding sphere radius relative to half of viewport height
+    // mesh takes the first LOD whose minimum it reaches, smaller meshes take the last LOD
+    std::array<float, animationLODCount - 1> minScreenSizes = {0.25f, 0.1f, 0.04f};
+
+    // frames between pose evaluations, skipped frames hold the last pose
+    std::array<uint32_t, animationLODCount> updateIntervals = {1, 2, 4, 8};
+
+    // sphere around mesh origin used for culling and screen size of meshes without geometry, in mesh local units
+    // meshes with geometry use a sphere around their animated bounds
+    float boundingRadius = 1.f;
+
+    // wall time spent on pose evaluation per frame, updates over budget are deferred to next frames. 0 disables it
+    float budgetMilliseconds = 2.f;
+};
+
+// scheduling state of a single mesh
+struct AnimationLODState
+{
+    uint32_t lod = 0;
+
+    // spreads meshes of the same LOD across frames
+    uint32_t phase = 0;
+
+    uint32_t framesSinceUpdate = 0;
+
+    // time not consumed by evaluation yet, skipped frames are caught up by the next evaluation
+    float pendingDeltaTime = 0.f;
+
+    // pose was not evaluated since mesh got visible
+    bool isPoseStale = true;
+};
+} // namespace Core::Animations
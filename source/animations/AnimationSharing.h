@@ -0,0 +1,15 @@
+#pragma once
+
+namespace Core::Animations
+{
+// instances with the same skeleton, graph, parameters and node times evaluate one pose per frame
+// and every other instance copies it
+struct AnimationSharingSettings
+{
+    bool enabled = false;
+
+    // node times are snapped to this many seconds when instances are matched
+    // bigger quantum shares more poses, but instances get up to one quantum out of their own phase
+    float timeQuantum = 1.f / 30.f;
+};
+} // namespace Core::Animations
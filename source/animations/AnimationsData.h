@@ -3,16 +3,26 @@
 #include "glm/glm.hpp"
 #include "glm/detail/type_quat.hpp"
 #include <vector>
+#include <limits>
 #include <map>
 #include <string>
 #include <memory>
+#include <span>
+#include <utility>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/matrix_decompose.hpp>
 
 constexpr size_t maxNumberOfBonesPerVertex = 4;
 
+namespace Core::Resources
+{
+struct SkeletonData;
+}
+
 namespace Core::Animations
 {
+struct CompressedAnimationClip;
+
 struct VertexBoneData
 {
     unsigned int boneIDs[maxNumberOfBonesPerVertex] = {};
@@ -21,20 +31,132 @@ struct VertexBoneData
     VertexBoneData() = default;
 };
 
+// axis aligned box, empty until first point is added
+struct BoundingBox
+{
+    glm::vec3 min{std::numeric_limits<float>::max()};
+    glm::vec3 max{std::numeric_limits<float>::lowest()};
+
+    [[nodiscard]] bool isEmpty() const { return min.x > max.x; }
+
+    void extend(const glm::vec3& point)
+    {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    void extend(const BoundingBox& box)
+    {
+        if (!box.isEmpty())
+        {
+            extend(box.min);
+            extend(box.max);
+        }
+    }
+
+    // box around this box transformed by rows of an affine matrix
+    [[nodiscard]] BoundingBox transformed(const glm::mat3x4& rows) const
+    {
+        if (isEmpty())
+        {
+            return {};
+        }
+
+        const glm::vec3 center = (min + max) * 0.5f;
+        const glm::vec3 extents = (max - min) * 0.5f;
+
+        BoundingBox result;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const glm::vec4& row = rows[axis];
+            const float newCenter = glm::dot(glm::vec3(row), center) + row.w;
+            const float newExtent = glm::dot(glm::abs(glm::vec3(row)), extents);
+
+            result.min[axis] = newCenter - newExtent;
+            result.max[axis] = newCenter + newExtent;
+        }
+
+        return result;
+    }
+
+    // slab test, distance along direction to the entry point is 0 for origins inside the box
+    [[nodiscard]] bool intersectRay(const glm::vec3& origin, const glm::vec3& direction, float& outDistance) const
+    {
+        if (isEmpty())
+        {
+            return false;
+        }
+
+        float nearDistance = 0.f;
+        float farDistance = std::numeric_limits<float>::max();
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (glm::abs(direction[axis]) < std::numeric_limits<float>::epsilon())
+            {
+                if (origin[axis] < min[axis] || origin[axis] > max[axis])
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            const float invDirection = 1.f / direction[axis];
+            float t0 = (min[axis] - origin[axis]) * invDirection;
+            float t1 = (max[axis] - origin[axis]) * invDirection;
+            if (t0 > t1)
+            {
+                std::swap(t0, t1);
+            }
+
+            nearDistance = glm::max(nearDistance, t0);
+            farDistance = glm::min(farDistance, t1);
+            if (nearDistance > farDistance)
+            {
+                return false;
+            }
+        }
+
+        outDistance = nearDistance;
+        return true;
+    }
+};
+
+// bone skinning a single primitive
 struct Bone
 {
-    glm::mat4 offset{};
-    glm::mat4 animatedGlobalTransform{};
+    glm::mat4 offset{1.f};
+    // selects animated transform from the mesh bone palette
+    int skeletonIndex = -1;
 
     Bone() = default;
-    explicit Bone(const glm::mat4& inOffset) : offset(inOffset), animatedGlobalTransform(glm::mat4(0.0)) {}
+    explicit Bone(const glm::mat4& inOffset, const int inSkeletonIndex)
+        : offset(inOffset), skeletonIndex(inSkeletonIndex)
+    {
+    }
 };
 
 struct BonesInfo
 {
     std::vector<VertexBoneData> vertexToBone;
+    // only bones the primitive is skinned to, vertex bone ids index this remap table
     std::vector<Bone> bones;
-    std::vector<glm::mat4> finalTransforms;
+    // skinning matrices uploaded for the primitive, parallel to bones
+    // stored as three rows of the affine matrix, same as in the uniform buffer
+    std::vector<glm::mat3x4> finalTransforms;
+    // set when finalTransforms change, uniform buffer is written only then
+    bool finalTransformsDirty = true;
+    // bind pose box of vertices every bone influences, parallel to bones
+    // skinned vertex is a weighted average of its bones, so union of transformed boxes always holds it
+    std::vector<BoundingBox> boneBounds;
+};
+
+// animated transforms of the whole skeleton, built once per mesh and shared by all of its primitives
+struct BonePalette
+{
+    // model space transforms indexed by skeleton bone index
+    std::vector<glm::mat4> globalTransforms;
+    // pose composed into matrices, scratch for building globalTransforms
     std::vector<glm::mat4> localTransforms;
 };
 
@@ -83,12 +205,13 @@ struct Node
     std::vector<std::shared_ptr<Node>> children;
 };
 
+// keys are views into AnimationClip::keyStorage
 struct AnimationChannel
 {
     std::string boneName;
-    std::vector<KeyframeVec3> positions;
-    std::vector<KeyframeQuat> rotations;
-    std::vector<KeyframeVec3> scalings;
+    std::span<const KeyframeVec3> positions;
+    std::span<const KeyframeQuat> rotations;
+    std::span<const KeyframeVec3> scalings;
 };
 
 struct AnimationClip
@@ -97,6 +220,26 @@ struct AnimationClip
     float duration;
     float ticksPerSecond;
     std::vector<AnimationChannel> channels;
+    // owns memory channel keys point into, either keys imported from source file or a mapped clip cache,
+    // shared between copies of the clip
+    std::shared_ptr<const void> keyStorage;
+    // set when keys were moved to compressed storage, channels then only keep bone names
+    std::shared_ptr<const CompressedAnimationClip> compressed;
+};
+
+// last sampled key index of every channel track, owned by whoever plays the clip
+struct AnimationChannelCursor
+{
+    uint32_t position = 0;
+    uint32_t rotation = 0;
+    uint32_t scale = 0;
+};
+
+// maps skeleton bones to clip channels, built once when clip is attached to a skeleton
+struct AnimationClipBinding
+{
+    // channel index for every bone index, -1 if clip does not animate the bone
+    std::vector<int> boneToChannel;
 };
 
 struct BoneNode
@@ -106,14 +249,52 @@ struct BoneNode
     std::vector<BoneNode> children;
 };
 
+// skeleton hierarchy flattened into parent-before-child order, built once on import
+// non-bone nodes are folded into parentOffsets, so a single forward pass over slots builds the whole model space pose
+struct FlatSkeleton
+{
+    // bone index stored in every slot
+    std::vector<int> boneIndices;
+    // bone index of nearest bone ancestor for every slot, -1 for root bones
+    std::vector<int> parentBoneIndices;
+    // product of non-bone node transforms between parent bone (or scene root) and the bone in this slot
+    std::vector<glm::mat4> parentOffsets;
+    // bind pose local transform of the bone in this slot
+    std::vector<glm::mat4> bindLocalTransforms;
+    // slot of every bone index, -1 if bone is not part of the hierarchy
+    std::vector<int> boneSlots;
+
+    [[nodiscard]] size_t size() const { return boneIndices.size(); }
+};
+
 struct AnimationMask
 {
     std::string name;
+    // authored weights by node name, nodes without a weight inherit weight of their parent
+    // edit through setWeight, so compiled weights get rebuilt
     std::map<std::string, float> boneWeights;
+    // boneWeights resolved for every bone index of compiledSkeleton, see AnimationsUtils::compileMask
+    std::vector<float> compiledWeights;
+    // range of compiledWeights, tells blends which of their inputs the mask ignores
+    float compiledMinWeight = 0.f;
+    float compiledMaxWeight = 0.f;
+    const Resources::SkeletonData* compiledSkeleton = nullptr;
+
+    [[nodiscard]] const float* findWeight(const std::string& nodeName) const
+    {
+        const auto it = boneWeights.find(nodeName);
+        return it != boneWeights.end() ? &it->second : nullptr;
+    }
+
+    void setWeight(const std::string& nodeName, const float weight)
+    {
+        boneWeights[nodeName] = weight;
+        compiledSkeleton = nullptr;
+    }
 
     void setWeightRecursively(const BoneNode& node, float weight, bool includeChildren = true)
     {
-        boneWeights[node.name] = weight;
+        setWeight(node.name, weight);
 
         if (!includeChildren)
         {
@@ -136,12 +317,37 @@ enum class AnimationBlendingMode : uint8_t
 enum class AnimationSolverType : uint8_t
 {
     CCD,
-    FABRIK
+    FABRIK,
+    TwoBone
 };
 
+// local bone transforms stored as separate streams, so pose kernels process several bones per instruction
 struct Pose
 {
-    std::vector<BoneTransform> localTransforms;
+    std::vector<glm::vec3> positions;
+    std::vector<glm::quat> rotations;
+    std::vector<glm::vec3> scales;
+
+    [[nodiscard]] size_t size() const { return positions.size(); }
+
+    void resize(const size_t boneCount)
+    {
+        positions.resize(boneCount, glm::vec3(0.f));
+        rotations.resize(boneCount, glm::quat(1.f, 0.f, 0.f, 0.f));
+        scales.resize(boneCount, glm::vec3(1.f));
+    }
+
+    [[nodiscard]] BoneTransform getTransform(const size_t boneIndex) const
+    {
+        return BoneTransform{positions[boneIndex], rotations[boneIndex], scales[boneIndex]};
+    }
+
+    void setTransform(const size_t boneIndex, const BoneTransform& transform)
+    {
+        positions[boneIndex] = transform.position;
+        rotations[boneIndex] = transform.rotation;
+        scales[boneIndex] = transform.scale;
+    }
 };
 
 struct PoseGlobalData
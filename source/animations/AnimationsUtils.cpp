@@ -4,15 +4,39 @@
 #include "assimp/postprocess.h"
 #include "assimp/scene.h"
 #include "Animator.h"
+#include "simd/PoseKernels.h"
 #include "glm/gtc/type_ptr.hpp"
 #include "engine/Engine.h"
 #include "tools/Logger.h"
+#include "core/Assertion.h"
 
-Core::Animations::AnimationClip
-Core::Animations::AnimationsUtils::loadAnimationFromFile(const std::string_view& filePath)
+#include <algorithm>
+
+namespace
+{
+struct ImportedAnimationKeys
+{
+    std::vector<Core::Animations::KeyframeVec3> vec3Keys;
+    std::vector<Core::Animations::KeyframeQuat> quatKeys;
+};
+
+struct ImportedKeyRanges
+{
+    size_t firstPosition = 0;
+    size_t positionCount = 0;
+    size_t firstRotation = 0;
+    size_t rotationCount = 0;
+    size_t firstScaling = 0;
+    size_t scalingCount = 0;
+};
+} // namespace
+
+std::vector<Core::Animations::AnimationClip>
+Core::Animations::AnimationsUtils::loadAnimationsFromFile(const std::string_view& filePath)
 {
+    // only animations are read, so no mesh post processing
     Assimp::Importer importer{};
-    const aiScene* scene = importer.ReadFile(filePath.data(), aiProcess_Triangulate | aiProcess_GlobalScale);
+    const aiScene* scene = importer.ReadFile(filePath.data(), aiProcess_GlobalScale);
 
     if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->HasAnimations())
     {
@@ -20,49 +44,79 @@ Core::Animations::AnimationsUtils::loadAnimationFromFile(const std::string_view&
         return {};
     }
 
-    aiAnimation* aiAnim = scene->mAnimations[0];
-    if (!aiAnim)
-    {
-        Logger::log(1, "No animation found in file: %s\n", filePath.data());
-        return {};
-    }
+    auto keys = std::make_shared<ImportedAnimationKeys>();
 
-    AnimationClip clip;
-    clip.name = filePath;
-    clip.duration = static_cast<float>(aiAnim->mDuration);
-    clip.ticksPerSecond = aiAnim->mTicksPerSecond != 0.0 ? static_cast<float>(aiAnim->mTicksPerSecond) : 25.0f;
+    std::vector<AnimationClip> clips;
+    // parallel to channels of all clips, spans are set once key arrays stop growing
+    std::vector<ImportedKeyRanges> keyRanges;
 
-    for (unsigned int i = 0; i < aiAnim->mNumChannels; i++)
+    for (unsigned int animationIndex = 0; animationIndex < scene->mNumAnimations; ++animationIndex)
     {
-        aiNodeAnim* channel = aiAnim->mChannels[i];
-        AnimationChannel animChannel;
-        animChannel.boneName = channel->mNodeName.C_Str();
-
-        for (unsigned int j = 0; j < channel->mNumPositionKeys; j++)
+        const aiAnimation* aiAnim = scene->mAnimations[animationIndex];
+        if (!aiAnim)
         {
-            const auto& key = channel->mPositionKeys[j];
-            auto convertedPosition = convertVectorToGlm(key.mValue);
-            animChannel.positions.push_back({static_cast<float>(key.mTime), convertedPosition});
+            continue;
         }
 
-        for (unsigned int j = 0; j < channel->mNumRotationKeys; j++)
+        AnimationClip& clip = clips.emplace_back();
+        // first clip keeps the file name, which is what meshes show for their clips
+        clip.name = animationIndex == 0 ? std::string(filePath)
+                                        : std::string(filePath) + ":" + aiAnim->mName.C_Str();
+        clip.duration = static_cast<float>(aiAnim->mDuration);
+        clip.ticksPerSecond =
+            aiAnim->mTicksPerSecond != 0.0 ? static_cast<float>(aiAnim->mTicksPerSecond) : 25.0f;
+
+        for (unsigned int i = 0; i < aiAnim->mNumChannels; i++)
         {
-            const auto& key = channel->mRotationKeys[j];
-            auto convertedRotation = convertQuaternionToGlm(key.mValue);
-            animChannel.rotations.push_back({static_cast<float>(key.mTime), convertedRotation});
+            const aiNodeAnim* channel = aiAnim->mChannels[i];
+            AnimationChannel& animChannel = clip.channels.emplace_back();
+            animChannel.boneName = channel->mNodeName.C_Str();
+
+            ImportedKeyRanges& ranges = keyRanges.emplace_back();
+
+            ranges.firstPosition = keys->vec3Keys.size();
+            ranges.positionCount = channel->mNumPositionKeys;
+            for (unsigned int j = 0; j < channel->mNumPositionKeys; j++)
+            {
+                const auto& key = channel->mPositionKeys[j];
+                keys->vec3Keys.push_back({static_cast<float>(key.mTime), convertVectorToGlm(key.mValue)});
+            }
+
+            ranges.firstRotation = keys->quatKeys.size();
+            ranges.rotationCount = channel->mNumRotationKeys;
+            for (unsigned int j = 0; j < channel->mNumRotationKeys; j++)
+            {
+                const auto& key = channel->mRotationKeys[j];
+                keys->quatKeys.push_back({static_cast<float>(key.mTime), convertQuaternionToGlm(key.mValue)});
+            }
+
+            ranges.firstScaling = keys->vec3Keys.size();
+            ranges.scalingCount = channel->mNumScalingKeys;
+            for (unsigned int j = 0; j < channel->mNumScalingKeys; j++)
+            {
+                const auto& key = channel->mScalingKeys[j];
+                keys->vec3Keys.push_back(
+                    {static_cast<float>(key.mTime), glm::vec3(key.mValue.x, key.mValue.y, key.mValue.z)});
+            }
         }
+    }
 
-        for (unsigned int j = 0; j < channel->mNumScalingKeys; j++)
+    size_t rangeIndex = 0;
+    for (AnimationClip& clip : clips)
+    {
+        clip.keyStorage = keys;
+
+        for (AnimationChannel& channel : clip.channels)
         {
-            const auto& key = channel->mScalingKeys[j];
-            animChannel.scalings.push_back(
-                {static_cast<float>(key.mTime), glm::vec3(key.mValue.x, key.mValue.y, key.mValue.z)});
-        }
+            const ImportedKeyRanges& ranges = keyRanges[rangeIndex++];
 
-        clip.channels.push_back(animChannel);
+            channel.positions = {keys->vec3Keys.data() + ranges.firstPosition, ranges.positionCount};
+            channel.rotations = {keys->quatKeys.data() + ranges.firstRotation, ranges.rotationCount};
+            channel.scalings = {keys->vec3Keys.data() + ranges.firstScaling, ranges.scalingCount};
+        }
     }
 
-    return clip;
+    return clips;
 }
 
 Core::Animations::BoneNode Core::Animations::AnimationsUtils::buildBoneHierarchy(const aiNode* node)
@@ -79,70 +133,197 @@ Core::Animations::BoneNode Core::Animations::AnimationsUtils::buildBoneHierarchy
     return boneNode;
 }
 
-void Core::Animations::AnimationsUtils::buildPoseGlobalTransforms(const Pose& pose, const BoneNode& rootNode,
-                                                                  const Resources::SkeletonData& skeletonData,
-                                                                  PoseGlobalData& outData)
+Core::Animations::AnimationClipBinding
+Core::Animations::AnimationsUtils::bindClipToSkeleton(const AnimationClip& clip,
+                                                      const Resources::SkeletonData& skeletonData)
 {
-    buildPoseGlobalTransformsRecursive(pose, rootNode, glm::mat4(1.0f), skeletonData, outData);
+    AnimationClipBinding binding;
+    binding.boneToChannel.resize(skeletonData.boneNameToIndexMap.size(), -1);
+
+    for (size_t channelIndex = 0; channelIndex < clip.channels.size(); ++channelIndex)
+    {
+        if (const auto it = skeletonData.boneNameToIndexMap.find(clip.channels[channelIndex].boneName);
+            it != skeletonData.boneNameToIndexMap.end())
+        {
+            binding.boneToChannel[it->second] = static_cast<int>(channelIndex);
+        }
+    }
+
+    return binding;
 }
 
-void Core::Animations::AnimationsUtils::buildPoseGlobalTransformsRecursive(const Pose& pose, const BoneNode& node,
-                                                                           const glm::mat4& parentTransform,
-                                                                           const Resources::SkeletonData& skeletonData,
-                                                                           PoseGlobalData& outData)
+void Core::Animations::AnimationsUtils::buildFlatSkeleton(
+    const BoneNode& rootNode, const std::unordered_map<std::string, int>& boneNameToIndexMap, FlatSkeleton& outSkeleton)
 {
-    glm::mat4 localTransform = node.localTransform;
-    glm::mat4 globalTransform;
+    outSkeleton = {};
+    outSkeleton.boneSlots.resize(boneNameToIndexMap.size(), -1);
 
-    if (const auto it = skeletonData.boneNameToIndexMap.find(node.name); it != skeletonData.boneNameToIndexMap.end())
+    buildFlatSkeletonRecursive(rootNode, -1, glm::mat4(1.0f), boneNameToIndexMap, outSkeleton);
+}
+
+void Core::Animations::AnimationsUtils::buildFlatSkeletonRecursive(
+    const BoneNode& node, const int parentBoneIndex, const glm::mat4& parentOffset,
+    const std::unordered_map<std::string, int>& boneNameToIndexMap, FlatSkeleton& outSkeleton)
+{
+    int childParentBoneIndex = parentBoneIndex;
+    glm::mat4 childParentOffset;
+
+    if (const auto it = boneNameToIndexMap.find(node.name); it != boneNameToIndexMap.end())
     {
         const int boneIndex = it->second;
 
-        localTransform = pose.localTransforms[boneIndex].toMatrix();
+        outSkeleton.boneSlots[boneIndex] = static_cast<int>(outSkeleton.boneIndices.size());
+        outSkeleton.boneIndices.push_back(boneIndex);
+        outSkeleton.parentBoneIndices.push_back(parentBoneIndex);
+        outSkeleton.parentOffsets.push_back(parentOffset);
+        outSkeleton.bindLocalTransforms.push_back(node.localTransform);
 
-        globalTransform = parentTransform * localTransform;
-
-        outData.globalTransforms[boneIndex] = globalTransform;
+        childParentBoneIndex = boneIndex;
+        childParentOffset = glm::mat4(1.0f);
     }
     else
     {
-        globalTransform = parentTransform * localTransform;
+        // non-bone nodes never get animated, so their transforms are baked into the offset of the next bone below
+        childParentOffset = parentOffset * node.localTransform;
     }
 
     for (const auto& child : node.children)
     {
-        buildPoseGlobalTransformsRecursive(pose, child, globalTransform, skeletonData, outData);
+        buildFlatSkeletonRecursive(child, childParentBoneIndex, childParentOffset, boneNameToIndexMap, outSkeleton);
+    }
+}
+
+void Core::Animations::AnimationsUtils::buildPoseGlobalTransforms(const Pose& pose,
+                                                                  const Resources::SkeletonData& skeletonData,
+                                                                  PoseGlobalData& outData)
+{
+    const FlatSkeleton& flatSkeleton = skeletonData.flatSkeleton;
+
+    outData.globalTransforms.resize(pose.size());
+
+    // local matrices are composed in one batch and then turned into globals in place,
+    // parents come first in slot order so every bone still holds its local matrix when visited
+    PoseKernels::composeMatrices(pose, outData.globalTransforms.data());
+
+    for (size_t slot = 0; slot < flatSkeleton.size(); ++slot)
+    {
+        const int boneIndex = flatSkeleton.boneIndices[slot];
+        const int parentIndex = flatSkeleton.parentBoneIndices[slot];
+
+        const glm::mat4 parentTransform = parentIndex >= 0
+                                              ? outData.globalTransforms[parentIndex] * flatSkeleton.parentOffsets[slot]
+                                              : flatSkeleton.parentOffsets[slot];
+
+        outData.globalTransforms[boneIndex] = parentTransform * outData.globalTransforms[boneIndex];
+    }
+}
+
+namespace
+{
+// local bone transform including non-bone nodes between the bone and its parent bone
+glm::mat4 getBoneToParentTransform(const Core::Animations::Pose& pose,
+                                   const Core::Resources::SkeletonData& skeletonData, const int boneIndex)
+{
+    const Core::Animations::FlatSkeleton& flatSkeleton = skeletonData.flatSkeleton;
+
+    const int slot = flatSkeleton.boneSlots[boneIndex];
+    const glm::mat4 localTransform = pose.getTransform(boneIndex).toMatrix();
+
+    return slot >= 0 ? flatSkeleton.parentOffsets[slot] * localTransform : localTransform;
+}
+} // namespace
+
+glm::mat4 Core::Animations::AnimationsUtils::buildParentGlobalTransform(const Pose& pose,
+                                                                        const Resources::SkeletonData& skeletonData,
+                                                                        const int boneIndex)
+{
+    glm::mat4 transform(1.0f);
+
+    for (int ancestor = skeletonData.boneParents[boneIndex]; ancestor >= 0;
+         ancestor = skeletonData.boneParents[ancestor])
+    {
+        transform = getBoneToParentTransform(pose, skeletonData, ancestor) * transform;
+    }
+
+    return transform;
+}
+
+void Core::Animations::AnimationsUtils::updateChainGlobalTransforms(const Pose& pose,
+                                                                    const Resources::SkeletonData& skeletonData,
+                                                                    const std::span<const int> chain,
+                                                                    const glm::mat4& rootParentTransform,
+                                                                    const size_t fromChainIndex,
+                                                                    std::vector<glm::mat4>& outGlobals)
+{
+    outGlobals.resize(chain.size());
+
+    for (size_t i = fromChainIndex + 1; i-- > 0;)
+    {
+        SE_ASSERT(i + 1 == chain.size() || skeletonData.boneParents[chain[i]] == chain[i + 1],
+                  "IK chain bones have to be ordered from effector to root");
+
+        const glm::mat4& parentTransform = i + 1 < chain.size() ? outGlobals[i + 1] : rootParentTransform;
+        outGlobals[i] = parentTransform * getBoneToParentTransform(pose, skeletonData, chain[i]);
     }
 }
 
 Core::Animations::Pose
-Core::Animations::AnimationsUtils::createReferencePose(const Resources::SkeletonData& skeletonData,
-                                                       const BoneNode& rootNode)
+Core::Animations::AnimationsUtils::createReferencePose(const Resources::SkeletonData& skeletonData)
 {
     Pose pose;
 
     const size_t boneCount = skeletonData.boneNameToIndexMap.size();
 
-    pose.localTransforms.resize(boneCount);
+    pose.resize(boneCount);
+
+    const FlatSkeleton& flatSkeleton = skeletonData.flatSkeleton;
 
-    buildReferencePoseRecursive(rootNode, skeletonData, pose);
+    for (size_t slot = 0; slot < flatSkeleton.size(); ++slot)
+    {
+        pose.setTransform(flatSkeleton.boneIndices[slot], BoneTransform{flatSkeleton.bindLocalTransforms[slot]});
+    }
 
     return pose;
 }
 
-void Core::Animations::AnimationsUtils::buildReferencePoseRecursive(const BoneNode& node,
-                                                                    const Resources::SkeletonData& skeletonData,
-                                                                    Pose& pose)
+void Core::Animations::AnimationsUtils::compileMask(AnimationMask& mask, const Resources::SkeletonData& skeletonData)
 {
-    if (const auto it = skeletonData.boneNameToIndexMap.find(node.name); it != skeletonData.boneNameToIndexMap.end())
+    const size_t boneCount = skeletonData.boneNameToIndexMap.size();
+    if (mask.compiledSkeleton == &skeletonData && mask.compiledWeights.size() == boneCount)
     {
-        const int boneIndex = it->second;
+        return;
+    }
+
+    // bones outside of the hierarchy keep the first pose
+    mask.compiledWeights.assign(boneCount, 0.f);
+    compileMaskRecursive(skeletonData.rootNode, 0.f, skeletonData, mask);
 
-        pose.localTransforms[boneIndex] = BoneTransform{node.localTransform};
+    mask.compiledMinWeight = 0.f;
+    mask.compiledMaxWeight = 0.f;
+    if (!mask.compiledWeights.empty())
+    {
+        const auto [minWeight, maxWeight] = std::ranges::minmax(mask.compiledWeights);
+        mask.compiledMinWeight = minWeight;
+        mask.compiledMaxWeight = maxWeight;
+    }
+
+    mask.compiledSkeleton = &skeletonData;
+}
+
+void Core::Animations::AnimationsUtils::compileMaskRecursive(const BoneNode& node, const float inheritedWeight,
+                                                             const Resources::SkeletonData& skeletonData,
+                                                             AnimationMask& mask)
+{
+    const float* authoredWeight = mask.findWeight(node.name);
+    const float weight = authoredWeight ? glm::clamp(*authoredWeight, 0.f, 1.f) : inheritedWeight;
+
+    if (const auto it = skeletonData.boneNameToIndexMap.find(node.name); it != skeletonData.boneNameToIndexMap.end())
+    {
+        mask.compiledWeights[it->second] = weight;
     }
 
     for (const auto& child : node.children)
     {
-        buildReferencePoseRecursive(child, skeletonData, pose);
+        compileMaskRecursive(child, weight, skeletonData, mask);
     }
-}
\ No newline at end of file
+}
@@ -5,6 +5,7 @@
 #include "assimp/quaternion.h"
 #include "assimp/scene.h"
 #include <glm/glm.hpp>
+#include <unordered_map>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/quaternion.hpp>
 
@@ -17,6 +18,11 @@ namespace Core::Animations
 class AnimationsUtils
 {
 public:
+    static void hashCombine(size_t& seed, const size_t value)
+    {
+        seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
     static inline glm::mat4 convertMatrixToGlm(aiMatrix4x4 from)
     {
         glm::mat4 to;
@@ -55,23 +61,91 @@ public:
         return {pOrientation.w, pOrientation.x, pOrientation.y, pOrientation.z};
     }
 
-    static AnimationClip loadAnimationFromFile(const std::string_view& filePath);
+    // returns index of the key starting the segment that contains time, or keyCount - 1 past the last key
+    // cursor keeps the previous result, so forward playback steps over a few keys instead of searching
+    template <typename GetKeyTime>
+    static size_t findKeyIndex(const size_t keyCount, const float time, uint32_t& cursor, GetKeyTime getKeyTime)
+    {
+        const size_t lastIndex = keyCount - 1;
+
+        size_t index = cursor;
+
+        if (index <= lastIndex && time >= getKeyTime(index))
+        {
+            for (size_t step = 0; step < maxCursorLinearSteps; ++step)
+            {
+                if (index == lastIndex || time < getKeyTime(index + 1))
+                {
+                    cursor = static_cast<uint32_t>(index);
+                    return index;
+                }
+
+                ++index;
+            }
+        }
+
+        // first key with time greater than requested one
+        size_t low = 1;
+        size_t high = keyCount;
+        while (low < high)
+        {
+            const size_t middle = low + (high - low) / 2;
+            if (time < getKeyTime(middle))
+            {
+                high = middle;
+            }
+            else
+            {
+                low = middle + 1;
+            }
+        }
+
+        index = low == keyCount ? lastIndex : low - 1;
+
+        cursor = static_cast<uint32_t>(index);
+        return index;
+    }
+
+    // imports every clip of the file in one pass, clips share one key storage
+    static std::vector<AnimationClip> loadAnimationsFromFile(const std::string_view& filePath);
 
     static BoneNode buildBoneHierarchy(const aiNode* node);
 
-    static void buildPoseGlobalTransforms(const Pose& pose, const BoneNode& rootNode,
-                                          const Resources::SkeletonData& skeletonData, PoseGlobalData& outData);
+    [[nodiscard]] static AnimationClipBinding bindClipToSkeleton(const AnimationClip& clip,
+                                                                 const Resources::SkeletonData& skeletonData);
+
+    static void buildFlatSkeleton(const BoneNode& rootNode,
+                                  const std::unordered_map<std::string, int>& boneNameToIndexMap,
+                                  FlatSkeleton& outSkeleton);
+
+    static void buildPoseGlobalTransforms(const Pose& pose, const Resources::SkeletonData& skeletonData,
+                                          PoseGlobalData& outData);
 
-    static void buildPoseGlobalTransformsRecursive(const Pose& pose, const BoneNode& node,
-                                                   const glm::mat4& parentTransform,
-                                                   const Resources::SkeletonData& skeletonData,
-                                                   PoseGlobalData& outData);
+    // model space transform of the parent bone, walks only ancestors of the bone, identity for root bones
+    [[nodiscard]] static glm::mat4 buildParentGlobalTransform(const Pose& pose,
+                                                              const Resources::SkeletonData& skeletonData,
+                                                              int boneIndex);
 
-    [[nodiscard]] static Pose createReferencePose(const Resources::SkeletonData& skeletonData,
-                                                  const BoneNode& rootNode);
+    // chain is ordered effector first with every bone being child of the next one, outGlobals is parallel to it
+    // rebuilds globals of chain bones from fromChainIndex down to the effector, bones above it are left as they are
+    static void updateChainGlobalTransforms(const Pose& pose, const Resources::SkeletonData& skeletonData,
+                                            std::span<const int> chain, const glm::mat4& rootParentTransform,
+                                            size_t fromChainIndex, std::vector<glm::mat4>& outGlobals);
+
+    [[nodiscard]] static Pose createReferencePose(const Resources::SkeletonData& skeletonData);
+
+    // resolves mask weights into one clamped weight per bone index, does nothing if mask is already compiled
+    static void compileMask(AnimationMask& mask, const Resources::SkeletonData& skeletonData);
 
 private:
-    static void buildReferencePoseRecursive(const BoneNode& node, const Resources::SkeletonData& skeletonData,
-                                            Pose& pose);
+    // forward playback rarely moves more than a couple of keys per frame, anything further is treated as a seek
+    static constexpr size_t maxCursorLinearSteps = 4;
+
+    static void compileMaskRecursive(const BoneNode& node, float inheritedWeight,
+                                     const Resources::SkeletonData& skeletonData, AnimationMask& mask);
+
+    static void buildFlatSkeletonRecursive(const BoneNode& node, int parentBoneIndex, const glm::mat4& parentOffset,
+                                           const std::unordered_map<std::string, int>& boneNameToIndexMap,
+                                           FlatSkeleton& outSkeleton);
 };
 } // namespace Core::Animations
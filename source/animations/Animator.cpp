@@ -1,14 +1,35 @@
 #include "Animator.h"
 
 #include "AnimInstance.h"
+#include "AnimationDatabase.h"
+#include "core/Assertion.h"
 #include "AnimationsUtils.h"
 #include "anim-graph/AnimationContext.h"
+#include "compression/AnimationCompression.h"
+#include "simd/PoseKernels.h"
+#include "components/TransformComponent.h"
+#include "engine/Engine.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <ranges>
 
 void Core::Animations::Animator::update(Renderer::VkRenderData& renderData, const float deltaTime)
 {
     mAnimationBonesTransformCalculationTimer.start();
-    for (Component::MeshComponent* mesh : mMeshes)
+
+    // resolved once per frame, workers only read it
+    mScene = Engine::getInstance().getSystem<Scene::Scene>();
+
+    renderData.rdAnimationLODMeshCounts.fill(0);
+    mDueMeshes.clear();
+
+    mThreadScratch.resize(mThreadPool.getThreadCount());
+
+    for (size_t index = 0; index < mMeshes.size(); ++index)
     {
+        Component::MeshComponent* mesh = mMeshes[index];
         if (mesh->getAnimInstance() == nullptr || mesh->getAnimGraph()->getOutputNode().is_nil())
         {
             continue;
@@ -19,250 +40,606 @@ void Core::Animations::Animator::update(Renderer::VkRenderData& renderData, cons
             continue;
         }
 
-        updateBonesTransform(mesh, deltaTime);
+        // graphs are edited on the main thread, so plans are recompiled here before workers read them
+        mesh->getAnimGraph()->compilePlanIfDirty();
+
+        AnimationLODState& state = mLODStates[index];
+        state.lod = selectLOD(mesh, renderData);
+        ++renderData.rdAnimationLODMeshCounts[state.lod];
+
+        if (state.lod == offScreenAnimationLOD)
+        {
+            // time advance is cheap, so it runs on the main thread
+            AnimationContext context = createContext(mesh, state.pendingDeltaTime + deltaTime, mThreadScratch[0]);
+            mesh->getAnimInstance()->advanceTime(context);
+
+            state.pendingDeltaTime = 0.f;
+            state.isPoseStale = true;
+            continue;
+        }
+
+        state.pendingDeltaTime += deltaTime;
+        ++state.framesSinceUpdate;
+
+        const uint32_t interval = std::max(mLODSettings.updateIntervals[state.lod], 1u);
+        const bool isScheduled = (mFrameIndex + state.phase) % interval == 0;
+
+        if (state.isPoseStale || isScheduled || state.framesSinceUpdate >= interval)
+        {
+            // stale poses go first, the rest by how late they are relative to their LOD
+            const float priority = state.isPoseStale ? std::numeric_limits<float>::max()
+                                                     : static_cast<float>(state.framesSinceUpdate) / interval;
+            mDueMeshes.emplace_back(priority, index);
+        }
     }
 
+    scheduleDueMeshes(renderData);
+
+    mSharedPoseSlots.assign(mActiveMeshes.size(), -1);
+    mPoseFollowers.clear();
+
+    if (mSharingSettings.enabled)
+    {
+        groupSharedMeshes();
+    }
+
+    renderData.rdAnimationSharedMeshCount = static_cast<uint32_t>(mPoseFollowers.size());
+
+    assignDeferredPoses();
+
+    for (AnimationScratch& scratch : mThreadScratch)
+    {
+        scratch.twoBoneIKRequests.clear();
+        scratch.prunedSubgraphCount = 0;
+    }
+
+    Timer evaluationTimer;
+    evaluationTimer.start();
+
+    // meshes only share read-only clip and skeleton data, so every mesh is updated independently
+    mThreadPool.parallelFor(mActiveMeshes.size(),
+                            [this](const size_t index, const size_t threadIndex)
+                            {
+                                const size_t meshIndex = mActiveMeshes[index];
+                                AnimationScratch& scratch = mThreadScratch[threadIndex];
+
+                                const bool isPoseDeferred = mDeferredPoseSlots[index] >= 0;
+
+                                Pose* pose = &scratch.pose;
+                                if (mSharedPoseSlots[index] >= 0)
+                                {
+                                    pose = &mSharedPoses[mSharedPoseSlots[index]];
+                                }
+                                else if (isPoseDeferred)
+                                {
+                                    pose = &mDeferredPoses[mDeferredPoseSlots[index]];
+                                }
+
+                                updateBonesTransform(mMeshes[meshIndex], mLODStates[meshIndex].pendingDeltaTime,
+                                                     scratch, *pose, isPoseDeferred);
+                            });
+
+    solveTwoBoneIKBatch();
+
+    mThreadPool.parallelFor(mDeferredMeshes.size(),
+                            [this](const size_t index, size_t)
+                            {
+                                const size_t activeIndex = mDeferredMeshes[index];
+                                applyPose(mMeshes[mActiveMeshes[activeIndex]],
+                                          mDeferredPoses[mDeferredPoseSlots[activeIndex]]);
+                            });
+
+    mThreadPool.parallelFor(mPoseFollowers.size(),
+                            [this](const size_t index, size_t)
+                            {
+                                const PoseFollower& follower = mPoseFollowers[index];
+                                applySharedPose(mMeshes[follower.meshIndex], mMeshes[follower.leaderMeshIndex],
+                                                mSharedPoses[follower.poseSlot]);
+                            });
+
+    const float evaluationTime = evaluationTimer.stop();
+
+    renderData.rdAnimationPrunedSubgraphCount = 0;
+    for (const AnimationScratch& scratch : mThreadScratch)
+    {
+        renderData.rdAnimationPrunedSubgraphCount += scratch.prunedSubgraphCount;
+    }
+
+    size_t evaluatedBones = 0;
+    for (const size_t meshIndex : mActiveMeshes)
+    {
+        evaluatedBones += mMeshes[meshIndex]->getSkeleton().getSkeletonData()->referencePose.size();
+    }
+
+    for (const size_t meshIndex : mActiveMeshes)
+    {
+        AnimationLODState& state = mLODStates[meshIndex];
+        state.pendingDeltaTime = 0.f;
+        state.framesSinceUpdate = 0;
+        state.isPoseStale = false;
+    }
+
+    for (const PoseFollower& follower : mPoseFollowers)
+    {
+        AnimationLODState& state = mLODStates[follower.meshIndex];
+        state.pendingDeltaTime = 0.f;
+        state.framesSinceUpdate = 0;
+        state.isPoseStale = false;
+    }
+
+    if (evaluatedBones > 0)
+    {
+        const float costPerBone = evaluationTime / static_cast<float>(evaluatedBones);
+        mEvaluationCostPerBone =
+            mEvaluationCostPerBone > 0.f ? glm::mix(mEvaluationCostPerBone, costPerBone, 0.1f) : costPerBone;
+    }
+
+    ++mFrameIndex;
+
     renderData.rdAnimationBonesTransformCalculationTime = mAnimationBonesTransformCalculationTimer.stop();
 }
 
-void Core::Animations::Animator::updateBonesTransform(Component::MeshComponent* mesh, const float deltaTime)
+void Core::Animations::Animator::scheduleDueMeshes(Renderer::VkRenderData& renderData)
 {
-    const Skeleton& skeleton = mesh->getSkeleton();
+    mActiveMeshes.clear();
+    renderData.rdAnimationDeferredMeshCount = 0;
 
-    AnimationContext context;
-    context.deltaTime = deltaTime;
-    context.skeletonData = skeleton.getSkeletonData();
-    context.meshComponent = mesh;
-    context.animations = &mesh->getAnimations();
+    const float budget = mLODSettings.enabled ? mLODSettings.budgetMilliseconds : 0.f;
+    if (budget <= 0.f || mEvaluationCostPerBone <= 0.f)
+    {
+        for (const size_t index : mDueMeshes | std::views::values)
+        {
+            mActiveMeshes.push_back(index);
+        }
+        return;
+    }
 
-    const Pose pose = mesh->getAnimInstance()->evaluate(context);
+    std::ranges::sort(mDueMeshes, std::greater{}, &std::pair<float, size_t>::first);
 
-    for (Renderer::Primitive& primitive : mesh->getPrimitives())
+    // deferred meshes keep their pending time and get a higher priority next frame
+    float spentBudget = 0.f;
+    for (const size_t index : mDueMeshes | std::views::values)
     {
-        BonesInfo& bonesInfo = primitive.getBonesInfo();
-        const size_t bonesInfoSize = bonesInfo.bones.size();
-        bonesInfo.finalTransforms.resize(bonesInfoSize, glm::mat4(1.0));
-        bonesInfo.localTransforms.resize(bonesInfoSize, glm::mat4(1.0f));
-
-        buildGlobalTransforms(pose, skeleton.getRootNode(), *skeleton.getSkeletonData(), bonesInfo);
+        const size_t boneCount = mMeshes[index]->getSkeleton().getSkeletonData()->referencePose.size();
+        const float cost = static_cast<float>(boneCount) * mEvaluationCostPerBone;
 
-        for (size_t i = 0; i < bonesInfoSize; ++i)
+        // at least one mesh is evaluated every frame, so a single expensive mesh can't stall forever
+        if (!mActiveMeshes.empty() && spentBudget + cost > budget)
         {
-            bonesInfo.finalTransforms[i] = bonesInfo.bones[i].animatedGlobalTransform * bonesInfo.bones[i].offset;
+            ++renderData.rdAnimationDeferredMeshCount;
+            continue;
         }
+
+        spentBudget += cost;
+        mActiveMeshes.push_back(index);
     }
 }
 
-void Core::Animations::Animator::buildGlobalTransforms(const Pose& pose, const BoneNode& rootNode,
-                                                       const Resources::SkeletonData& skeletonData,
-                                                       BonesInfo& bonesInfo)
+void Core::Animations::Animator::groupSharedMeshes()
 {
-    buildGlobalTransformsRecursive(pose, rootNode, glm::mat4(1.0f), skeletonData, bonesInfo);
-}
+    mSharingLeaders.clear();
 
-void Core::Animations::Animator::buildGlobalTransformsRecursive(const Pose& pose, const BoneNode& node,
-                                                                const glm::mat4& parentTransform,
-                                                                const Resources::SkeletonData& skeletonData,
-                                                                BonesInfo& bonesInfo)
-{
-    glm::mat4 localMatrix = node.localTransform;
-    glm::mat4 globalTransform;
+    size_t sharedPoseCount = 0;
+    size_t evaluatedCount = 0;
 
-    if (const auto it = skeletonData.boneNameToIndexMap.find(node.name); it != skeletonData.boneNameToIndexMap.end())
+    // mActiveMeshes is compacted in place, leaders and meshes which can't share stay in it
+    for (size_t index = 0; index < mActiveMeshes.size(); ++index)
     {
-        const int boneIndex = it->second;
+        const size_t meshIndex = mActiveMeshes[index];
+        Component::MeshComponent* mesh = mMeshes[meshIndex];
 
-        localMatrix = pose.localTransforms[boneIndex].toMatrix();
+        if (!mesh->getAnimGraph()->getPlan().canSharePose())
+        {
+            mSharedPoseSlots[evaluatedCount] = -1;
+            mActiveMeshes[evaluatedCount++] = meshIndex;
+            continue;
+        }
 
-        bonesInfo.localTransforms[boneIndex] = localMatrix;
+        // key depends on node times, so time is advanced up front and evaluation only samples
+        AnimationLODState& state = mLODStates[meshIndex];
+        AnimationContext context = createContext(mesh, state.pendingDeltaTime, mThreadScratch[0]);
+        mesh->getAnimInstance()->advanceTime(context);
+        state.pendingDeltaTime = 0.f;
 
-        globalTransform = parentTransform * localMatrix;
+        size_t key = mesh->getAnimInstance()->getSharingKey(context, mSharingSettings.timeQuantum);
+        AnimationsUtils::hashCombine(key, std::hash<const void*>{}(context.skeletonData));
+        AnimationsUtils::hashCombine(key, getMasksHash(mesh));
 
-        bonesInfo.bones[boneIndex].animatedGlobalTransform = globalTransform;
-    }
-    else
-    {
-        globalTransform = parentTransform * localMatrix;
+        if (const auto it = mSharingLeaders.find(key); it != mSharingLeaders.end())
+        {
+            const size_t leaderIndex = it->second;
+            mPoseFollowers.push_back({meshIndex, mActiveMeshes[leaderIndex],
+                                      static_cast<size_t>(mSharedPoseSlots[leaderIndex])});
+            continue;
+        }
+
+        mSharingLeaders.emplace(key, evaluatedCount);
+        mSharedPoseSlots[evaluatedCount] = static_cast<int>(sharedPoseCount++);
+        mActiveMeshes[evaluatedCount++] = meshIndex;
     }
 
-    for (const auto& child : node.children)
+    mActiveMeshes.resize(evaluatedCount);
+    mSharedPoseSlots.resize(evaluatedCount);
+
+    if (mSharedPoses.size() < sharedPoseCount)
     {
-        buildGlobalTransformsRecursive(pose, child, globalTransform, skeletonData, bonesInfo);
+        mSharedPoses.resize(sharedPoseCount);
     }
 }
 
-const Core::Animations::AnimationChannel* findChannel(const Core::Animations::AnimationClip& clip,
-                                                      const std::string& boneName)
+void Core::Animations::Animator::assignDeferredPoses()
 {
-    for (const auto& channel : clip.channels)
+    mDeferredPoseSlots.assign(mActiveMeshes.size(), -1);
+    mDeferredMeshes.clear();
+
+    for (size_t index = 0; index < mActiveMeshes.size(); ++index)
     {
-        if (channel.boneName == boneName)
+        // ik nodes never share their pose, so shared slots and deferred slots don't meet
+        if (mSharedPoseSlots[index] >= 0 || !mMeshes[mActiveMeshes[index]]->getAnimGraph()->getPlan().defersFinalPose())
         {
-            return &channel;
+            continue;
         }
+
+        mDeferredPoseSlots[index] = static_cast<int>(mDeferredMeshes.size());
+        mDeferredMeshes.push_back(index);
+    }
+
+    if (mDeferredPoses.size() < mDeferredMeshes.size())
+    {
+        mDeferredPoses.resize(mDeferredMeshes.size());
     }
-    return nullptr;
 }
 
-Core::Animations::Pose Core::Animations::Animator::sampleClip(const AnimationClip& clip, const float time,
-                                                              const Resources::SkeletonData& skeletonData,
-                                                              const BoneNode& rootNode)
+void Core::Animations::Animator::solveTwoBoneIKBatch()
 {
-    Pose pose;
-
-    const size_t boneCount = skeletonData.boneNameToIndexMap.size();
+    mTwoBoneIKRequests.clear();
+    for (const AnimationScratch& scratch : mThreadScratch)
+    {
+        mTwoBoneIKRequests.insert(mTwoBoneIKRequests.end(), scratch.twoBoneIKRequests.begin(),
+                                  scratch.twoBoneIKRequests.end());
+    }
 
-    pose.localTransforms.resize(boneCount);
+    // chunks are big enough to fill kernel lanes and keep dispatch cost low, chains of one pose are independent,
+    // so chunks may split a pose between threads
+    const size_t chunkCount = (mTwoBoneIKRequests.size() + twoBoneIKChunkSize - 1) / twoBoneIKChunkSize;
 
-    sampleClipRecursive(clip, time, rootNode, skeletonData, pose);
+    mThreadPool.parallelFor(chunkCount,
+                            [this](const size_t chunk, const size_t threadIndex)
+                            {
+                                const size_t first = chunk * twoBoneIKChunkSize;
+                                const size_t count = std::min(twoBoneIKChunkSize, mTwoBoneIKRequests.size() - first);
 
-    return pose;
+                                TwoBoneIKBatch::solve(std::span(mTwoBoneIKRequests).subspan(first, count),
+                                                      mThreadScratch[threadIndex].twoBoneIK);
+                            });
 }
 
-Core::Animations::Pose Core::Animations::Animator::blendPoses(const Pose& poseA, const Pose& poseB,
-                                                              const float blendFactor)
+size_t Core::Animations::Animator::getMasksHash(Component::MeshComponent* mesh)
 {
-    Pose result;
-
-    const size_t boneCount = poseA.localTransforms.size();
-
-    result.localTransforms.resize(boneCount);
+    size_t hash = 0;
 
-    for (size_t i = 0; i < boneCount; ++i)
+    for (size_t i = 0; i < mesh->getMasksCount(); ++i)
     {
-        result.localTransforms[i] = blendTransforms(poseA.localTransforms[i], poseB.localTransforms[i], blendFactor);
+        for (const float weight : mesh->getMaskWeights(static_cast<int>(i)))
+        {
+            AnimationsUtils::hashCombine(hash, std::hash<float>{}(weight));
+        }
     }
 
-    return result;
+    return hash;
 }
 
-Core::Animations::Pose Core::Animations::Animator::blendMaskedPoses(const Pose& poseA, const Pose& poseB,
-                                                                    const Resources::SkeletonData& skeletonData,
-                                                                    const AnimationMask& mask, const float alpha)
+uint32_t Core::Animations::Animator::selectLOD(Component::MeshComponent* mesh,
+                                               const Renderer::VkRenderData& renderData) const
 {
-    Pose result;
+    if (!mLODSettings.enabled)
+    {
+        return 0;
+    }
 
-    const size_t boneCount = poseA.localTransforms.size();
+    auto* transformComponent = mesh->getOwner()->getComponent<Component::TransformComponent>();
+    if (!transformComponent)
+    {
+        return 0;
+    }
 
-    result.localTransforms.resize(boneCount);
+    const glm::mat4 world = transformComponent->getWorldMatrix();
+    const float scale = glm::max(glm::length(glm::vec3(world[0])),
+                                 glm::max(glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2]))));
 
-    for (size_t i = 0; i < boneCount; ++i)
+    // sphere around the last animated box, off screen meshes keep the box of their last evaluated pose
+    glm::vec3 center = glm::vec3(world[3]);
+    float radius = mLODSettings.boundingRadius * scale;
+    if (const BoundingBox bounds = mesh->getBounds(); !bounds.isEmpty())
     {
-        result.localTransforms[i] = poseA.localTransforms[i];
+        center = glm::vec3(world * glm::vec4((bounds.min + bounds.max) * 0.5f, 1.f));
+        radius = glm::length(bounds.max - bounds.min) * 0.5f * scale;
     }
 
-    for (const auto& [boneName, weight] : mask.boneWeights)
-    {
-        auto boneIt = skeletonData.boneNameToIndexMap.find(boneName);
+    const glm::mat4& projection = renderData.rdGlobalSceneData.projection;
+    const glm::mat4 viewProjection = projection * renderData.rdGlobalSceneData.view;
 
-        if (boneIt == skeletonData.boneNameToIndexMap.end())
+    // frustum planes are combinations of view projection rows
+    const glm::mat4 rows = glm::transpose(viewProjection);
+    for (int plane = 0; plane < 6; ++plane)
+    {
+        const glm::vec4 coefficients = rows[3] + (plane % 2 == 0 ? 1.f : -1.f) * rows[plane / 2];
+        const float normalLength = glm::length(glm::vec3(coefficients));
+        if (normalLength <= 0.f)
         {
             continue;
         }
 
-        const int boneIndex = boneIt->second;
+        if ((glm::dot(glm::vec3(coefficients), center) + coefficients.w) / normalLength < -radius)
+        {
+            return offScreenAnimationLOD;
+        }
+    }
+
+    const float depth = glm::max(-(renderData.rdGlobalSceneData.view * glm::vec4(center, 1.f)).z, 0.001f);
+    const float screenSize = radius * glm::abs(projection[1][1]) / depth;
+
+    for (uint32_t lod = 0; lod < mLODSettings.minScreenSizes.size(); ++lod)
+    {
+        if (screenSize >= mLODSettings.minScreenSizes[lod])
+        {
+            return lod;
+        }
+    }
+
+    return animationLODCount - 1;
+}
+
+void Core::Animations::Animator::setThreadCount(const size_t threadCount)
+{
+    mThreadPool.setThreadCount(threadCount);
+    mThreadScratch.resize(mThreadPool.getThreadCount());
+}
 
-        const float finalWeight = glm::clamp(weight * alpha, 0.f, 1.f);
+void Core::Animations::Animator::updateBonesTransform(Component::MeshComponent* mesh, const float deltaTime,
+                                                      AnimationScratch& scratch, Pose& pose, const bool isPoseDeferred)
+{
+    AnimationContext context = createContext(mesh, deltaTime, scratch);
 
-        result.localTransforms[boneIndex] =
-            blendTransforms(poseA.localTransforms[boneIndex], poseB.localTransforms[boneIndex], finalWeight);
+    if (!isPoseDeferred)
+    {
+        mesh->getAnimInstance()->evaluate(context, pose);
+        applyPose(mesh, pose);
+        return;
     }
 
-    return result;
+    const size_t firstRequest = scratch.twoBoneIKRequests.size();
+    context.twoBoneIKRequests = &scratch.twoBoneIKRequests;
+
+    mesh->getAnimInstance()->evaluate(context, pose);
+
+    for (size_t i = firstRequest; i < scratch.twoBoneIKRequests.size(); ++i)
+    {
+        scratch.twoBoneIKRequests[i].pose = &pose;
+    }
 }
 
-void Core::Animations::Animator::sampleClipRecursive(const AnimationClip& clip, const float time, const BoneNode& node,
-                                                     const Resources::SkeletonData& skeletonData, Pose& pose)
+void Core::Animations::Animator::applyPose(Component::MeshComponent* mesh, const Pose& pose)
 {
-    BoneTransform localTransform;
+    BonePalette& palette = mesh->getBonePalette();
+
+    buildGlobalTransforms(pose, *mesh->getSkeleton().getSkeletonData(), palette);
 
-    if (const AnimationChannel* channel = findChannel(clip, node.name))
+    for (Renderer::Primitive& primitive : mesh->getPrimitives())
     {
-        localTransform = getBoneTransform(channel, time);
+        buildSkinningTransforms(palette, primitive.getBonesInfo());
     }
-    else
+
+    updateAnimatedBounds(mesh);
+}
+
+void Core::Animations::Animator::applySharedPose(Component::MeshComponent* mesh, Component::MeshComponent* leader,
+                                                 const Pose& pose)
+{
+    std::vector<Renderer::Primitive>& primitives = mesh->getPrimitives();
+    std::vector<Renderer::Primitive>& leaderPrimitives = leader->getPrimitives();
+
+    const bool isSameSource = !mesh->getMeshFilePath().empty() &&
+                              mesh->getMeshFilePath() == leader->getMeshFilePath() &&
+                              mesh->getPrimitiveIndex() == leader->getPrimitiveIndex() &&
+                              primitives.size() == leaderPrimitives.size();
+    if (!isSameSource)
     {
-        localTransform = BoneTransform{node.localTransform};
+        applyPose(mesh, pose);
+        return;
     }
 
-    if (const auto it = skeletonData.boneNameToIndexMap.find(node.name); it != skeletonData.boneNameToIndexMap.end())
+    mesh->getBonePalette().globalTransforms = leader->getBonePalette().globalTransforms;
+
+    // same primitives, so bone offsets match and skinning matrices are equal too
+    for (size_t i = 0; i < primitives.size(); ++i)
     {
-        const int boneIndex = it->second;
+        BonesInfo& bonesInfo = primitives[i].getBonesInfo();
+        bonesInfo.finalTransforms = leaderPrimitives[i].getBonesInfo().finalTransforms;
+        bonesInfo.finalTransformsDirty = true;
+    }
+
+    mesh->setAnimatedBounds(leader->getBounds());
+}
+
+Core::Animations::AnimationContext Core::Animations::Animator::createContext(Component::MeshComponent* mesh,
+                                                                           const float deltaTime,
+                                                                           AnimationScratch& scratch) const
+{
+    AnimationContext context;
+    context.deltaTime = deltaTime;
+    context.skeletonData = mesh->getSkeleton().getSkeletonData();
+    context.meshComponent = mesh;
+    context.database = &AnimationDatabase::getInstance();
+    context.scene = mScene;
+    context.scratch = &scratch;
+
+    return context;
+}
+
+void Core::Animations::Animator::buildGlobalTransforms(const Pose& pose, const Resources::SkeletonData& skeletonData,
+                                                       BonePalette& palette)
+{
+    const FlatSkeleton& flatSkeleton = skeletonData.flatSkeleton;
+
+    palette.localTransforms.resize(pose.size());
+    palette.globalTransforms.resize(pose.size());
+
+    PoseKernels::composeMatrices(pose, palette.localTransforms.data());
+
+    for (size_t slot = 0; slot < flatSkeleton.size(); ++slot)
+    {
+        const int boneIndex = flatSkeleton.boneIndices[slot];
+        const int parentIndex = flatSkeleton.parentBoneIndices[slot];
+
+        const glm::mat4 parentTransform =
+            parentIndex >= 0 ? palette.globalTransforms[parentIndex] * flatSkeleton.parentOffsets[slot]
+                             : flatSkeleton.parentOffsets[slot];
+
+        palette.globalTransforms[boneIndex] = parentTransform * palette.localTransforms[boneIndex];
+    }
+}
+
+void Core::Animations::Animator::buildSkinningTransforms(const BonePalette& palette, BonesInfo& bonesInfo)
+{
+    bonesInfo.finalTransforms.resize(bonesInfo.bones.size());
 
-        pose.localTransforms[boneIndex] = localTransform;
+    for (size_t i = 0; i < bonesInfo.bones.size(); ++i)
+    {
+        const Bone& bone = bonesInfo.bones[i];
+        const glm::mat4 skinningTransform = palette.globalTransforms[bone.skeletonIndex] * bone.offset;
+        // transposed, so the three stored columns hold rows of the affine matrix
+        bonesInfo.finalTransforms[i] = glm::mat3x4(glm::transpose(skinningTransform));
     }
 
-    for (const BoneNode& child : node.children)
+    bonesInfo.finalTransformsDirty = true;
+}
+
+void Core::Animations::Animator::updateAnimatedBounds(Component::MeshComponent* mesh)
+{
+    BoundingBox bounds;
+
+    for (const Renderer::Primitive& primitive : mesh->getPrimitives())
     {
-        sampleClipRecursive(clip, time, child, skeletonData, pose);
+        const BonesInfo& bonesInfo = primitive.getBonesInfo();
+        if (bonesInfo.bones.empty())
+        {
+            bounds.extend(primitive.getBounds());
+            continue;
+        }
+
+        for (size_t i = 0; i < bonesInfo.bones.size(); ++i)
+        {
+            bounds.extend(bonesInfo.boneBounds[i].transformed(bonesInfo.finalTransforms[i]));
+        }
     }
+
+    mesh->setAnimatedBounds(bounds);
 }
 
-glm::vec3 Core::Animations::Animator::interpolatePositionClip(const std::vector<KeyframeVec3>& keyframes,
-                                                              float animationTime)
+void Core::Animations::Animator::sampleClip(const AnimationClip& clip, const AnimationClipBinding& binding,
+                                            const float time, const Resources::SkeletonData& skeletonData,
+                                            std::vector<AnimationChannelCursor>& cursors, Pose& outPose)
 {
-    if (keyframes.size() == 1)
+    if (cursors.size() != clip.channels.size())
     {
-        return keyframes[0].value;
+        cursors.assign(clip.channels.size(), AnimationChannelCursor{});
     }
 
-    for (size_t i = 0; i < keyframes.size() - 1; ++i)
+    const size_t boneCount = binding.boneToChannel.size();
+
+    outPose.resize(boneCount);
+
+    const float normalizedTime =
+        clip.compressed && clip.duration > 0.f ? time / clip.duration * AnimationCompression::maxQuantizedTime : 0.f;
+
+    for (size_t boneIndex = 0; boneIndex < boneCount; ++boneIndex)
     {
-        if (animationTime < keyframes[i + 1].time)
+        if (const int channelIndex = binding.boneToChannel[boneIndex]; channelIndex >= 0)
         {
-            float t = (animationTime - keyframes[i].time) / (keyframes[i + 1].time - keyframes[i].time);
+            AnimationChannelCursor& cursor = cursors[channelIndex];
 
-            glm::vec3 start = keyframes[i].value;
-            glm::vec3 end = keyframes[i + 1].value;
+            const BoneTransform transform =
+                clip.compressed
+                    ? AnimationCompression::sampleChannel(*clip.compressed, channelIndex, normalizedTime, cursor)
+                    : getBoneTransform(clip.channels[channelIndex], time, cursor);
 
-            return glm::mix(start, end, t);
+            outPose.setTransform(boneIndex, transform);
+        }
+        else
+        {
+            outPose.setTransform(boneIndex, skeletonData.referencePose.getTransform(boneIndex));
         }
     }
-    return keyframes.back().value;
 }
 
-glm::quat Core::Animations::Animator::interpolateRotationClip(const std::vector<KeyframeQuat>& keyframes,
-                                                              float animationTime)
+void Core::Animations::Animator::blendPoses(const Pose& poseA, const Pose& poseB, const float blendFactor,
+                                            Pose& outPose)
+{
+    PoseKernels::blend(poseA, poseB, blendFactor, outPose);
+}
+
+void Core::Animations::Animator::blendMaskedPoses(const Pose& poseA, const Pose& poseB,
+                                                  const std::span<const float> boneWeights, const float alpha,
+                                                  Pose& outPose)
+{
+    SE_ASSERT(boneWeights.size() == poseA.size(), "Mask is not compiled for the blended skeleton");
+
+    // compiled weights are already clamped, so clamping alpha keeps every product in range
+    PoseKernels::blendWeighted(poseA, poseB, boneWeights.data(), glm::clamp(alpha, 0.f, 1.f), outPose);
+}
+
+glm::vec3 Core::Animations::Animator::interpolatePositionClip(std::span<const KeyframeVec3> keyframes,
+                                                              const float animationTime, uint32_t& cursor)
 {
     if (keyframes.size() == 1)
     {
         return keyframes[0].value;
     }
 
-    for (size_t i = 0; i < keyframes.size() - 1; ++i)
+    const size_t i = AnimationsUtils::findKeyIndex(keyframes.size(), animationTime, cursor,
+                                                   [&keyframes](const size_t index) { return keyframes[index].time; });
+    if (i == keyframes.size() - 1)
     {
-        if (animationTime < keyframes[i + 1].time)
-        {
-            float t = (animationTime - keyframes[i].time) / (keyframes[i + 1].time - keyframes[i].time);
+        return keyframes.back().value;
+    }
 
-            glm::quat start = keyframes[i].value;
-            glm::quat end = keyframes[i + 1].value;
+    const float t = (animationTime - keyframes[i].time) / (keyframes[i + 1].time - keyframes[i].time);
 
-            return glm::slerp(start, end, t);
-        }
-    }
-    return keyframes.back().value;
+    return glm::mix(keyframes[i].value, keyframes[i + 1].value, t);
 }
 
-glm::vec3 Core::Animations::Animator::interpolateScaleClip(const std::vector<KeyframeVec3>& keyframes,
-                                                           float animationTime)
+glm::quat Core::Animations::Animator::interpolateRotationClip(std::span<const KeyframeQuat> keyframes,
+                                                              const float animationTime, uint32_t& cursor)
 {
-    return interpolatePositionClip(keyframes, animationTime);
+    if (keyframes.size() == 1)
+    {
+        return keyframes[0].value;
+    }
+
+    const size_t i = AnimationsUtils::findKeyIndex(keyframes.size(), animationTime, cursor,
+                                                   [&keyframes](const size_t index) { return keyframes[index].time; });
+    if (i == keyframes.size() - 1)
+    {
+        return keyframes.back().value;
+    }
+
+    const float t = (animationTime - keyframes[i].time) / (keyframes[i + 1].time - keyframes[i].time);
+
+    return glm::slerp(keyframes[i].value, keyframes[i + 1].value, t);
 }
 
-Core::Animations::BoneTransform Core::Animations::Animator::getBoneTransform(const AnimationChannel* channel,
-                                                                             float time)
+glm::vec3 Core::Animations::Animator::interpolateScaleClip(std::span<const KeyframeVec3> keyframes,
+                                                           const float animationTime, uint32_t& cursor)
 {
-    return BoneTransform{interpolatePositionClip(channel->positions, time),
-                         interpolateRotationClip(channel->rotations, time),
-                         interpolateScaleClip(channel->scalings, time)};
+    return interpolatePositionClip(keyframes, animationTime, cursor);
 }
 
-Core::Animations::BoneTransform Core::Animations::Animator::blendTransforms(const BoneTransform& transformA,
-                                                                            const BoneTransform& transformB,
-                                                                            float blendFactor)
+Core::Animations::BoneTransform Core::Animations::Animator::getBoneTransform(const AnimationChannel& channel,
+                                                                             const float time,
+                                                                             AnimationChannelCursor& cursor)
 {
-    return BoneTransform{glm::mix(transformA.position, transformB.position, blendFactor),
-                         glm::slerp(transformA.rotation, transformB.rotation, blendFactor),
-                         glm::mix(transformA.scale, transformB.scale, blendFactor)};
+    return BoneTransform{interpolatePositionClip(channel.positions, time, cursor.position),
+                         interpolateRotationClip(channel.rotations, time, cursor.rotation),
+                         interpolateScaleClip(channel.scalings, time, cursor.scale)};
 }
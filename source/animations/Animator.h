@@ -1,11 +1,18 @@
 #pragma once
 
 #include "vk-renderer/VkRenderData.h"
+#include "animations/AnimationLOD.h"
+#include "animations/AnimationSharing.h"
+#include "animations/anim-graph/AnimationContext.h"
 #include "components/MeshComponent.h"
+#include "core/ThreadPool.h"
+#include "animations/compression/AnimationCompression.h"
 #include "system/System.h"
 #include "system/Updatable.h"
 #include "tools/Timer.h"
 
+#include <unordered_map>
+
 namespace Core::Animations
 {
 class Animator : public System::ISystem, public System::IUpdatable
@@ -13,49 +20,158 @@ class Animator : public System::ISystem, public System::IUpdatable
 public:
     void update(Renderer::VkRenderData& renderData, float deltaTime) override;
 
-    void addMesh(Component::MeshComponent* mesh) { mMeshes.push_back(mesh); }
+    void addMesh(Component::MeshComponent* mesh)
+    {
+        mMeshes.push_back(mesh);
+        mLODStates.push_back({.phase = mNextLODPhase++});
+    }
 
     void removeMesh(Component::MeshComponent* mesh)
     {
         if (auto it = std::find(mMeshes.begin(), mMeshes.end(), mesh); it != mMeshes.end())
         {
+            mLODStates.erase(mLODStates.begin() + (it - mMeshes.begin()));
             mMeshes.erase(it);
         }
     }
 
-    [[nodiscard]] static Pose sampleClip(const AnimationClip& clip, float time,
-                                         const Resources::SkeletonData& skeletonData, const BoneNode& rootNode);
+    // total number of threads updating meshes, including main thread, 0 picks hardware concurrency
+    void setThreadCount(size_t threadCount);
+
+    [[nodiscard]] size_t getThreadCount() const { return mThreadPool.getThreadCount(); }
+
+    [[nodiscard]] AnimationCompressionSettings& getCompressionSettings() { return mCompressionSettings; }
+
+    [[nodiscard]] AnimationLODSettings& getLODSettings() { return mLODSettings; }
+
+    [[nodiscard]] AnimationSharingSettings& getSharingSettings() { return mSharingSettings; }
+
+    // cursors keep last sampled key per channel track, so forward playback doesn't search keys from the start
+    static void sampleClip(const AnimationClip& clip, const AnimationClipBinding& binding, float time,
+                           const Resources::SkeletonData& skeletonData, std::vector<AnimationChannelCursor>& cursors,
+                           Pose& outPose);
+
+    static void blendPoses(const Pose& poseA, const Pose& poseB, float blendFactor, Pose& outPose);
+
+    // boneWeights are compiled mask weights, one per bone, alpha scales all of them
+    static void blendMaskedPoses(const Pose& poseA, const Pose& poseB, std::span<const float> boneWeights, float alpha,
+                                 Pose& outPose);
 
-    [[nodiscard]] static Pose blendPoses(const Pose& poseA, const Pose& poseB, float blendFactor);
+    // hierarchy walk runs once per mesh, primitives only pick their bones from the palette
+    static void buildGlobalTransforms(const Pose& pose, const Resources::SkeletonData& skeletonData,
+                                      BonePalette& palette);
 
-    [[nodiscard]] static Pose blendMaskedPoses(const Pose& poseA, const Pose& poseB,
-                                               const Resources::SkeletonData& skeletonData, const AnimationMask& mask,
-                                               float alpha);
+    // rows of skinning matrices of the primitive bones, in the layout primitive.vert reads them
+    static void buildSkinningTransforms(const BonePalette& palette, BonesInfo& bonesInfo);
 
 private:
+    // chains solved by one task of the ik batch
+    static constexpr size_t twoBoneIKChunkSize = 64;
+
     std::vector<Component::MeshComponent*> mMeshes;
 
-    void updateBonesTransform(Component::MeshComponent* mesh, float deltaTime);
+    // parallel to mMeshes
+    std::vector<AnimationLODState> mLODStates;
+
+    uint32_t mNextLODPhase = 0;
+
+    uint32_t mFrameIndex = 0;
+
+    // indices of meshes due for evaluation this frame with their priority, rebuilt every frame
+    std::vector<std::pair<float, size_t>> mDueMeshes;
+
+    // indices of meshes evaluated this frame
+    std::vector<size_t> mActiveMeshes;
+
+    struct PoseFollower
+    {
+        size_t meshIndex = 0;
+        size_t leaderMeshIndex = 0;
+        size_t poseSlot = 0;
+    };
+
+    // parallel to mActiveMeshes, slot in mSharedPoses the evaluated pose is kept in, -1 if it isn't shared
+    std::vector<int> mSharedPoseSlots;
+
+    std::vector<Pose> mSharedPoses;
+
+    // parallel to mActiveMeshes, slot in mDeferredPoses for meshes whose final pose is finished by the ik batch, -1 if
+    // the pose is applied right after evaluation
+    std::vector<int> mDeferredPoseSlots;
+
+    std::vector<Pose> mDeferredPoses;
+
+    // indices in mActiveMeshes of meshes with a deferred pose
+    std::vector<size_t> mDeferredMeshes;
+
+    // two bone chains queued by all threads this frame
+    std::vector<TwoBoneIKRequest> mTwoBoneIKRequests;
+
+    // meshes copying pose of an evaluated mesh with the same sharing key this frame
+    std::vector<PoseFollower> mPoseFollowers;
+
+    // sharing key to index in mActiveMeshes
+    std::unordered_map<size_t, size_t> mSharingLeaders;
+
+    // smoothed evaluation wall time per bone in milliseconds, used to fit evaluations into the budget
+    float mEvaluationCostPerBone = 0.f;
+
+    ThreadPool mThreadPool;
+
+    // scene of the current frame, handed to graph nodes through AnimationContext
+    Scene::Scene* mScene = nullptr;
+
+    // indexed by pool thread index
+    std::vector<AnimationScratch> mThreadScratch;
+
+    AnimationCompressionSettings mCompressionSettings;
+
+    AnimationLODSettings mLODSettings;
+
+    AnimationSharingSettings mSharingSettings;
+
+    // returns offScreenAnimationLOD for meshes outside of the view
+    [[nodiscard]] uint32_t selectLOD(Component::MeshComponent* mesh, const Renderer::VkRenderData& renderData) const;
+
+    // picks meshes evaluated this frame by priority until the budget is spent
+    void scheduleDueMeshes(Renderer::VkRenderData& renderData);
+
+    // leaves in mActiveMeshes only one mesh per sharing key, the rest becomes followers of it
+    void groupSharedMeshes();
+
+    // assigns pose slots to meshes whose graph leaves work to the ik batch
+    void assignDeferredPoses();
+
+    // solves chains queued by ik nodes of all meshes together, split into chunks between threads
+    void solveTwoBoneIKBatch();
+
+    // deferred meshes only evaluate their graph here and queue their ik chains, their pose is applied later
+    void updateBonesTransform(Component::MeshComponent* mesh, float deltaTime, AnimationScratch& scratch, Pose& pose,
+                              bool isPoseDeferred);
+
+    static void applyPose(Component::MeshComponent* mesh, const Pose& pose);
 
-    void buildGlobalTransforms(const Pose& pose, const BoneNode& rootNode, const Resources::SkeletonData& skeletonData,
-                               BonesInfo& bonesInfo);
+    // copies palettes of the leader when both meshes come from the same primitive, builds them from pose otherwise
+    static void applySharedPose(Component::MeshComponent* mesh, Component::MeshComponent* leader, const Pose& pose);
 
-    void buildGlobalTransformsRecursive(const Pose& pose, const BoneNode& node, const glm::mat4& parentTransform,
-                                        const Resources::SkeletonData& skeletonData, BonesInfo& bonesInfo);
+    static size_t getMasksHash(Component::MeshComponent* mesh);
 
-    static void sampleClipRecursive(const AnimationClip& clip, float time, const BoneNode& node,
-                                    const Resources::SkeletonData& skeletonData, Pose& pose);
+    [[nodiscard]] AnimationContext createContext(Component::MeshComponent* mesh, float deltaTime,
+                                                 AnimationScratch& scratch) const;
 
-    static glm::vec3 interpolatePositionClip(const std::vector<KeyframeVec3>& keyframes, float animationTime);
+    // union of per-bone bind boxes moved by their skinning matrices, conservative without touching vertices
+    static void updateAnimatedBounds(Component::MeshComponent* mesh);
 
-    static glm::quat interpolateRotationClip(const std::vector<KeyframeQuat>& keyframes, float animationTime);
+    static glm::vec3 interpolatePositionClip(std::span<const KeyframeVec3> keyframes, float animationTime,
+                                             uint32_t& cursor);
 
-    static glm::vec3 interpolateScaleClip(const std::vector<KeyframeVec3>& keyframes, float animationTime);
+    static glm::quat interpolateRotationClip(std::span<const KeyframeQuat> keyframes, float animationTime,
+                                             uint32_t& cursor);
 
-    static BoneTransform getBoneTransform(const AnimationChannel* channel, float time);
+    static glm::vec3 interpolateScaleClip(std::span<const KeyframeVec3> keyframes, float animationTime,
+                                          uint32_t& cursor);
 
-    static BoneTransform blendTransforms(const BoneTransform& transformA, const BoneTransform& transformB,
-                                         float blendFactor);
+    static BoneTransform getBoneTransform(const AnimationChannel& channel, float time, AnimationChannelCursor& cursor);
 
     Timer mAnimationBonesTransformCalculationTimer;
 };
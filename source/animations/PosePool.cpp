@@ -0,0 +1,23 @@
+#include "PosePool.h"
+
+#include "core/Assertion.h"
+
+Core::Animations::Pose& Core::Animations::PosePool::acquire(const size_t boneCount)
+{
+    if (mUsedCount == mPoses.size())
+    {
+        mPoses.push_back(std::make_unique<Pose>());
+    }
+
+    Pose& pose = *mPoses[mUsedCount++];
+    pose.resize(boneCount);
+
+    return pose;
+}
+
+void Core::Animations::PosePool::release()
+{
+    SE_ASSERT(mUsedCount > 0, "Pose pool released more poses than were acquired");
+
+    --mUsedCount;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "AnimationsData.h"
+
+#include <memory>
+#include <vector>
+
+namespace Core::Animations
+{
+// stack of pose buffers kept between frames, graph nodes take temporaries for their inputs
+// and give them back in reverse order, so after the first frames evaluation stops allocating
+class PosePool
+{
+public:
+    // pose is resized to boneCount, its contents are whatever previous user left there
+    [[nodiscard]] Pose& acquire(size_t boneCount);
+
+    // releases the most recently acquired pose
+    void release();
+
+    [[nodiscard]] size_t getUsedCount() const { return mUsedCount; }
+
+    [[nodiscard]] size_t getCapacity() const { return mPoses.size(); }
+
+private:
+    // poses are kept behind pointers so references stay valid while the pool grows
+    std::vector<std::unique_ptr<Pose>> mPoses;
+
+    size_t mUsedCount = 0;
+};
+
+// acquires a pose for the lifetime of the scope
+class ScopedPose
+{
+public:
+    ScopedPose(PosePool& pool, const size_t boneCount) : mPool(pool), mPose(pool.acquire(boneCount)) {}
+
+    ~ScopedPose() { mPool.release(); }
+
+    ScopedPose(const ScopedPose&) = delete;
+    ScopedPose& operator=(const ScopedPose&) = delete;
+
+    [[nodiscard]] Pose& get() { return mPose; }
+
+private:
+    PosePool& mPool;
+    Pose& mPose;
+};
+} // namespace Core::Animations
@@ -1,9 +1,8 @@
 #include "AnimGraph.h"
 
 #include "AnimGraphLink.h"
-#include "AnimationContext.h"
-#include "animations/AnimationsData.h"
-#include "nodes/AnimGraphOutputPoseNode.h"
+
+#include <algorithm>
 
 Core::Animations::AnimGraphNode* Core::Animations::AnimGraph::getNode(const NodeID& id)
 {
@@ -58,18 +57,42 @@ void Core::Animations::AnimGraph::removeLinksByPin(PinID pinId)
 {
     std::erase_if(mLinks,
                   [pinId](const AnimGraphLink& link) { return link.startPin == pinId || link.endPin == pinId; });
+    mIsPlanDirty = true;
 }
 
-Core::Animations::Pose Core::Animations::AnimGraph::evaluate(AnimationContext& context) const
+void Core::Animations::AnimGraph::declareParameter(const std::string& name, const AnimParamType type,
+                                                  const float defaultValue)
 {
-    const auto* output = dynamic_cast<const AnimGraphOutputPoseNode*>(getNode(mOutputNode));
+    const AnimParamID id(name);
 
-    if (!output)
+    if (const auto it = std::ranges::find(mParameters, id, &AnimParamDeclaration::id); it != mParameters.end())
+    {
+        it->type = type;
+        it->defaultValue = defaultValue;
+    }
+    else
     {
-        return {};
+        mParameters.push_back({name, id, type, defaultValue});
     }
 
-    context.graph = this;
+    mIsPlanDirty = true;
+}
+
+void Core::Animations::AnimGraph::removeParameter(const std::string& name)
+{
+    std::erase_if(mParameters, [id = AnimParamID(name)](const AnimParamDeclaration& parameter)
+                  { return parameter.id == id; });
+    mIsPlanDirty = true;
+}
+
+void Core::Animations::AnimGraph::compilePlanIfDirty()
+{
+    if (!mIsPlanDirty)
+    {
+        return;
+    }
 
-    return output->evaluate(context);
-}
\ No newline at end of file
+    mPlan = AnimGraphPlan::compile(*this);
+    ++mPlanVersion;
+    mIsPlanDirty = false;
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "AnimGraphLink.h"
+#include "AnimGraphPlan.h"
+#include "animations/AnimParamID.h"
 #include "nodes/AnimGraphNode.h"
 #include <memory>
 #include "uuid.h"
@@ -17,11 +19,16 @@ public:
         auto node = std::make_shared<T>(std::forward<Args>(args)...);
 
         mNodes[node->getUUID()] = node;
+        mIsPlanDirty = true;
 
         return node;
     }
 
-    void removeNode(const NodeID& id) { mNodes.erase(id); }
+    void removeNode(const NodeID& id)
+    {
+        mNodes.erase(id);
+        mIsPlanDirty = true;
+    }
 
     [[nodiscard]] AnimGraphNode* getNode(const NodeID& id);
 
@@ -29,7 +36,11 @@ public:
 
     [[nodiscard]] const std::unordered_map<NodeID, std::shared_ptr<AnimGraphNode>>& getNodes() const { return mNodes; }
 
-    void addLink(const AnimGraphLink& link) { mLinks.push_back(link); }
+    void addLink(const AnimGraphLink& link)
+    {
+        mLinks.push_back(link);
+        mIsPlanDirty = true;
+    }
 
     [[nodiscard]] const std::vector<AnimGraphLink>& getLinks() const { return mLinks; }
 
@@ -39,11 +50,33 @@ public:
 
     void removeLinksByPin(PinID pinId);
 
-    void setOutputNode(const NodeID& id) { mOutputNode = id; }
+    void setOutputNode(const NodeID& id)
+    {
+        mOutputNode = id;
+        mIsPlanDirty = true;
+    }
 
     [[nodiscard]] const NodeID& getOutputNode() const { return mOutputNode; }
 
-    Pose evaluate(AnimationContext& context) const;
+    // redeclaring a name changes its type and default value, slots are assigned on next plan compile
+    void declareParameter(const std::string& name, AnimParamType type, float defaultValue = 0.f);
+
+    void removeParameter(const std::string& name);
+
+    [[nodiscard]] const std::vector<AnimParamDeclaration>& getParameters() const { return mParameters; }
+
+    // nodes adding or removing pins after creation have to be followed by this
+    void markPlanDirty() { mIsPlanDirty = true; }
+
+    // recompiles the plan after structural edits, has to run on the thread editing the graph
+    void compilePlanIfDirty();
+
+    [[nodiscard]] bool isPlanDirty() const { return mIsPlanDirty; }
+
+    [[nodiscard]] const AnimGraphPlan& getPlan() const { return mPlan; }
+
+    // bumped on every compile, so instances know when their node runtimes have to be remapped
+    [[nodiscard]] uint32_t getPlanVersion() const { return mPlanVersion; }
 
 private:
     NodeID mOutputNode;
@@ -51,6 +84,12 @@ private:
     std::unordered_map<NodeID, std::shared_ptr<AnimGraphNode>> mNodes;
 
     std::vector<AnimGraphLink> mLinks;
+
+    std::vector<AnimParamDeclaration> mParameters;
+
+    AnimGraphPlan mPlan;
+    uint32_t mPlanVersion = 0;
+    bool mIsPlanDirty = true;
 };
 
 } // namespace Core::Animations
\ No newline at end of file
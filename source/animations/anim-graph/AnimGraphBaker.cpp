@@ -0,0 +1,167 @@
+#include "AnimGraphBaker.h"
+
+#include "AnimationContext.h"
+#include "animations/AnimInstance.h"
+#include "core/Assertion.h"
+#include "resources/Mesh.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+struct BakedAnimationKeys
+{
+    std::vector<Core::Animations::KeyframeVec3> vec3Keys;
+    std::vector<Core::Animations::KeyframeQuat> quatKeys;
+};
+} // namespace
+
+Core::Animations::AnimationClip Core::Animations::AnimGraphBaker::bake(AnimInstance& instance,
+                                                                       const AnimationContext& context,
+                                                                       const AnimGraphBakeSettings& settings)
+{
+    SE_ASSERT(context.skeletonData, "AnimGraph can't be baked without skeleton");
+    SE_ASSERT(settings.sampleRate > 0.f, "AnimGraph bake sample rate has to be positive");
+
+    const Resources::SkeletonData& skeletonData = *context.skeletonData;
+    const size_t boneCount = skeletonData.referencePose.size();
+
+    const float frameTime = 1.f / settings.sampleRate;
+
+    // range snaps to whole frames, clip nodes wrap at duration, so a clip needs at least two keys
+    const size_t startFrame = static_cast<size_t>(std::lround(std::max(settings.startTime, 0.f) * settings.sampleRate));
+    const size_t endFrame = std::max(
+        static_cast<size_t>(std::lround(std::max(settings.endTime, 0.f) * settings.sampleRate)), startFrame + 1);
+    const size_t frameCount = endFrame - startFrame + 1;
+
+    // bone order, names of bones missing from the map stay empty and get no channel
+    std::vector<std::string> boneNames(boneCount);
+    for (const auto& [name, boneIndex] : skeletonData.boneNameToIndexMap)
+    {
+        if (boneIndex >= 0 && static_cast<size_t>(boneIndex) < boneCount)
+        {
+            boneNames[boneIndex] = name;
+        }
+    }
+
+    // keys of bone are contiguous, positions and scales of bone share vec3Keys
+    auto keys = std::make_shared<BakedAnimationKeys>();
+    keys->vec3Keys.resize(boneCount * frameCount * 2);
+    keys->quatKeys.resize(boneCount * frameCount);
+
+    // own scratch keeps pruned counts and ik buffers of the bake away from the caller
+    AnimationScratch scratch;
+
+    AnimationContext frameContext = context;
+    frameContext.scratch = &scratch;
+    frameContext.twoBoneIKRequests = nullptr;
+
+    Pose pose;
+
+    for (size_t frame = 0; frame <= endFrame; ++frame)
+    {
+        const float time = static_cast<float>(frame) / settings.sampleRate;
+
+        applyParameterTracks(instance, settings.parameterTracks, time);
+
+        frameContext.deltaTime = frame == 0 ? 0.f : frameTime;
+        instance.evaluate(frameContext, pose);
+
+        if (frame < startFrame)
+        {
+            continue;
+        }
+
+        const size_t key = frame - startFrame;
+        const float keyTime = static_cast<float>(key);
+
+        for (size_t bone = 0; bone < boneCount; ++bone)
+        {
+            const size_t first = bone * frameCount;
+
+            // consecutive keys stay in one hemisphere, so quantized tracks of compressed clips don't jump
+            glm::quat rotation = pose.rotations[bone];
+            if (key > 0 && glm::dot(rotation, keys->quatKeys[first + key - 1].value) < 0.f)
+            {
+                rotation = -rotation;
+            }
+
+            keys->vec3Keys[first * 2 + key] = {keyTime, pose.positions[bone]};
+            keys->vec3Keys[first * 2 + frameCount + key] = {keyTime, pose.scales[bone]};
+            keys->quatKeys[first + key] = {keyTime, rotation};
+        }
+    }
+
+    // key times are in ticks, one tick per frame
+    AnimationClip clip;
+    clip.name = settings.clipName;
+    clip.ticksPerSecond = settings.sampleRate;
+    clip.duration = static_cast<float>(frameCount - 1);
+    clip.keyStorage = keys;
+
+    for (size_t bone = 0; bone < boneCount; ++bone)
+    {
+        if (boneNames[bone].empty())
+        {
+            continue;
+        }
+
+        const size_t first = bone * frameCount;
+
+        AnimationChannel& channel = clip.channels.emplace_back();
+        channel.boneName = boneNames[bone];
+        channel.positions = {keys->vec3Keys.data() + first * 2, frameCount};
+        channel.scalings = {keys->vec3Keys.data() + first * 2 + frameCount, frameCount};
+        channel.rotations = {keys->quatKeys.data() + first, frameCount};
+    }
+
+    return clip;
+}
+
+void Core::Animations::AnimGraphBaker::applyParameterTracks(AnimInstance& instance,
+                                                            const std::span<const AnimParamTrack> tracks,
+                                                            const float time)
+{
+    for (const AnimParamTrack& track : tracks)
+    {
+        if (track.keys.empty())
+        {
+            continue;
+        }
+
+        if (track.type == AnimParamType::Bool)
+        {
+            instance.setBool(track.parameter, sampleParameterTrack(track, time) != 0.f);
+        }
+        else
+        {
+            instance.setFloat(track.parameter, sampleParameterTrack(track, time));
+        }
+    }
+}
+
+float Core::Animations::AnimGraphBaker::sampleParameterTrack(const AnimParamTrack& track, const float time)
+{
+    if (track.keys.empty())
+    {
+        return 0.f;
+    }
+
+    // first key after time
+    const auto next = std::ranges::upper_bound(track.keys, time, {}, &AnimParamKey::time);
+    if (next == track.keys.begin())
+    {
+        return track.keys.front().value;
+    }
+
+    const AnimParamKey& previous = *(next - 1);
+    if (next == track.keys.end() || track.type == AnimParamType::Bool)
+    {
+        return previous.value;
+    }
+
+    const float t = (time - previous.time) / (next->time - previous.time);
+
+    return glm::mix(previous.value, next->value, t);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "animations/AnimParamID.h"
+#include "animations/AnimationsData.h"
+
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Core::Animations
+{
+class AnimInstance;
+struct AnimationContext;
+
+struct AnimParamKey
+{
+    // seconds from the start of the bake
+    float time = 0.f;
+    // bool parameters are set while value is not zero
+    float value = 0.f;
+};
+
+// keys are sorted by time, float values are interpolated between keys, bool values hold until the next key
+struct AnimParamTrack
+{
+    AnimParamID parameter;
+    AnimParamType type = AnimParamType::Float;
+    std::vector<AnimParamKey> keys;
+};
+
+struct AnimGraphBakeSettings
+{
+    std::string clipName;
+
+    // seconds, graph always runs from zero, frames before startTime only warm up clocks and transitions
+    float startTime = 0.f;
+    float endTime = 1.f;
+
+    // frames per second, every bone gets a key on every frame
+    float sampleRate = 30.f;
+
+    std::vector<AnimParamTrack> parameterTracks;
+};
+
+// evaluates an anim graph offline and stores the result as a regular clip, so background meshes
+// can play it through a single clip node instead of paying for the whole graph every frame
+class AnimGraphBaker
+{
+public:
+    // graph plan of instance has to be compiled beforehand, instance is advanced by the whole bake
+    // context supplies skeleton, clip database and scene read by graph nodes, ik is solved inline
+    [[nodiscard]] static AnimationClip bake(AnimInstance& instance, const AnimationContext& context,
+                                            const AnimGraphBakeSettings& settings);
+
+    // sets every tracked parameter of instance to its value at time
+    static void applyParameterTracks(AnimInstance& instance, std::span<const AnimParamTrack> tracks, float time);
+
+    // value of track at time, clamped to its first and last key, 0 for empty tracks
+    [[nodiscard]] static float sampleParameterTrack(const AnimParamTrack& track, float time);
+};
+} // namespace Core::Animations
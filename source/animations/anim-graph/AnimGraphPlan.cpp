@@ -0,0 +1,245 @@
+#include "AnimGraphPlan.h"
+
+#include "AnimGraph.h"
+#include "animations/AnimationsUtils.h"
+#include "tools/Logger.h"
+
+#include <algorithm>
+#include <ranges>
+#include <typeinfo>
+#include <unordered_map>
+
+namespace
+{
+using namespace Core::Animations;
+
+struct PlanCompileState
+{
+    std::unordered_map<PinID, const AnimGraphNode*> nodeByOutputPin;
+    std::unordered_map<PinID, PinID> sourcePinByInputPin;
+
+    // instruction index of every compiled node, -1 while node inputs are still being compiled
+    std::unordered_map<const AnimGraphNode*, int> instructionByNode;
+
+    std::vector<AnimGraphPlan::Instruction> instructions;
+    // instruction index feeding every input pin, -1 if not connected
+    std::vector<int> inputInstructions;
+};
+
+int compileNode(const AnimGraphNode* node, PlanCompileState& state)
+{
+    if (const auto it = state.instructionByNode.find(node); it != state.instructionByNode.end())
+    {
+        if (it->second < 0)
+        {
+            Logger::log(1, "AnimGraph has a cycle, link into node %s is ignored",
+                        uuids::to_string(node->getUUID()).c_str());
+        }
+
+        return it->second;
+    }
+
+    state.instructionByNode[node] = -1;
+
+    std::vector<int> inputs;
+    inputs.reserve(node->getInputs().size());
+
+    for (const AnimGraphPin& pin : node->getInputs())
+    {
+        int input = -1;
+
+        if (const auto link = state.sourcePinByInputPin.find(pin.id); link != state.sourcePinByInputPin.end())
+        {
+            if (const auto source = state.nodeByOutputPin.find(link->second); source != state.nodeByOutputPin.end())
+            {
+                input = compileNode(source->second, state);
+            }
+        }
+
+        inputs.push_back(input);
+    }
+
+    const int index = static_cast<int>(state.instructions.size());
+
+    AnimGraphPlan::Instruction instruction;
+    instruction.node = node;
+    instruction.firstInput = static_cast<uint32_t>(state.inputInstructions.size());
+    instruction.inputCount = static_cast<uint32_t>(inputs.size());
+
+    state.instructions.push_back(instruction);
+    state.inputInstructions.insert(state.inputInstructions.end(), inputs.begin(), inputs.end());
+
+    state.instructionByNode[node] = index;
+
+    return index;
+}
+} // namespace
+
+Core::Animations::AnimGraphPlan Core::Animations::AnimGraphPlan::compile(const AnimGraph& graph)
+{
+    AnimGraphPlan plan;
+
+    // parameters are declared on the graph, so they get slots even while output is not connected
+    plan.compileParameters(graph);
+
+    const AnimGraphNode* output = graph.getNode(graph.getOutputNode());
+    if (!output)
+    {
+        return plan;
+    }
+
+    PlanCompileState state;
+
+    for (const auto& node : graph.getNodes() | std::views::values)
+    {
+        for (const AnimGraphPin& pin : node->getOutputs())
+        {
+            state.nodeByOutputPin[pin.id] = node.get();
+        }
+    }
+
+    // first link wins, same as lookups by input pin did
+    for (const AnimGraphLink& link : graph.getLinks())
+    {
+        state.sourcePinByInputPin.emplace(link.endPin, link.startPin);
+    }
+
+    compileNode(output, state);
+
+    plan.mInstructions = std::move(state.instructions);
+
+    const size_t instructionCount = plan.mInstructions.size();
+
+    plan.mNodeIDs.reserve(instructionCount);
+    for (const Instruction& instruction : plan.mInstructions)
+    {
+        const AnimGraphNode& node = *instruction.node;
+
+        plan.mNodeIDs.push_back(node.getUUID());
+        plan.mCanSharePose = plan.mCanSharePose && node.canSharePose();
+
+        AnimationsUtils::hashCombine(plan.mStructureHash, typeid(node).hash_code());
+    }
+
+    for (const int source : state.inputInstructions)
+    {
+        AnimationsUtils::hashCombine(plan.mStructureHash, std::hash<int>{}(source));
+    }
+
+    // last instruction reading every instruction output, used to hand pose slots over to later nodes
+    std::vector<size_t> lastReader(instructionCount, 0);
+    for (size_t i = 0; i < instructionCount; ++i)
+    {
+        const Instruction& instruction = plan.mInstructions[i];
+        for (uint32_t input = 0; input < instruction.inputCount; ++input)
+        {
+            if (const int source = state.inputInstructions[instruction.firstInput + input]; source >= 0)
+            {
+                lastReader[source] = i;
+            }
+        }
+    }
+
+    std::vector<int> freeSlots;
+    for (size_t i = 0; i < instructionCount; ++i)
+    {
+        Instruction& instruction = plan.mInstructions[i];
+
+        // output node is compiled last
+        if (i + 1 < instructionCount)
+        {
+            if (freeSlots.empty())
+            {
+                instruction.poseSlot = static_cast<int>(plan.mPoseSlotCount++);
+            }
+            else
+            {
+                instruction.poseSlot = freeSlots.back();
+                freeSlots.pop_back();
+            }
+        }
+
+        // inputs are released after output slot is taken, so a node never writes into a pose it reads
+        for (uint32_t input = 0; input < instruction.inputCount; ++input)
+        {
+            const int source = state.inputInstructions[instruction.firstInput + input];
+            if (source < 0 || lastReader[source] != i)
+            {
+                continue;
+            }
+
+            const int sourceSlot = plan.mInstructions[source].poseSlot;
+            if (std::ranges::find(freeSlots, sourceSlot) == freeSlots.end())
+            {
+                freeSlots.push_back(sourceSlot);
+            }
+        }
+    }
+
+    // output node is compiled last and reads its only input
+    if (const Instruction& outputInstruction = plan.mInstructions.back(); outputInstruction.inputCount > 0)
+    {
+        if (const int source = state.inputInstructions[outputInstruction.firstInput]; source >= 0)
+        {
+            plan.mFinalPoseSource = plan.mInstructions[source].node;
+            plan.mDefersFinalPose = plan.mFinalPoseSource->canDeferToAnimator();
+        }
+    }
+
+    plan.mInputSlots.reserve(state.inputInstructions.size());
+    for (const int source : state.inputInstructions)
+    {
+        plan.mInputSlots.push_back(source >= 0 ? plan.mInstructions[source].poseSlot : -1);
+    }
+
+    plan.mInputInstructions = std::move(state.inputInstructions);
+
+    return plan;
+}
+
+Core::Animations::AnimParamSlot Core::Animations::AnimGraphPlan::findParameterSlot(const AnimParamID id,
+                                                                                  const AnimParamType type) const
+{
+    const auto it = std::ranges::lower_bound(mParameterLookups, id, {}, &ParameterLookup::id);
+    if (it == mParameterLookups.end() || it->id != id || it->type != type)
+    {
+        return {};
+    }
+
+    return {it->slot};
+}
+
+void Core::Animations::AnimGraphPlan::compileParameters(const AnimGraph& graph)
+{
+    for (const AnimParamDeclaration& parameter : graph.getParameters())
+    {
+        if (std::ranges::find(mParameterLookups, parameter.id, &ParameterLookup::id) != mParameterLookups.end())
+        {
+            Logger::log(1, "AnimGraph parameter %s has the same id as another parameter and is ignored",
+                        parameter.name.c_str());
+            continue;
+        }
+
+        int slot = -1;
+        if (parameter.type == AnimParamType::Float)
+        {
+            slot = static_cast<int>(mFloatParameterIDs.size());
+            mFloatParameterIDs.push_back(parameter.id);
+            mFloatParameterDefaults.push_back(parameter.defaultValue);
+        }
+        else
+        {
+            slot = static_cast<int>(mBoolParameterIDs.size());
+            mBoolParameterIDs.push_back(parameter.id);
+            mBoolParameterDefaults.push_back(parameter.defaultValue != 0.f);
+        }
+
+        mParameterLookups.push_back({parameter.id, parameter.type, slot});
+
+        // nodes read parameters by id, so graphs declaring different ones must not share poses
+        AnimationsUtils::hashCombine(mStructureHash, parameter.id.id);
+        AnimationsUtils::hashCombine(mStructureHash, static_cast<size_t>(parameter.type));
+    }
+
+    std::ranges::sort(mParameterLookups, {}, &ParameterLookup::id);
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "uuid.h"
+#include "animations/AnimParamID.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Core::Animations
+{
+class AnimGraph;
+class AnimGraphNode;
+
+// editor graph flattened into instructions in evaluation order, inputs always come before the nodes using them
+// links and pins are resolved once on compile, so execution only walks flat arrays
+class AnimGraphPlan
+{
+public:
+    struct Instruction
+    {
+        const AnimGraphNode* node = nullptr;
+
+        // range in input slots, one entry per node input pin
+        uint32_t firstInput = 0;
+        uint32_t inputCount = 0;
+
+        // pose slot the node writes to, -1 for the output node which writes straight into the final pose
+        int poseSlot = -1;
+    };
+
+    [[nodiscard]] static AnimGraphPlan compile(const AnimGraph& graph);
+
+    [[nodiscard]] bool isEmpty() const { return mInstructions.empty(); }
+
+    [[nodiscard]] const std::vector<Instruction>& getInstructions() const { return mInstructions; }
+
+    // pose slot of the node connected to every input pin, -1 if the pin is not connected
+    [[nodiscard]] const std::vector<int>& getInputSlots() const { return mInputSlots; }
+
+    // instruction connected to every input pin, -1 if the pin is not connected
+    [[nodiscard]] const std::vector<int>& getInputInstructions() const { return mInputInstructions; }
+
+    // instruction index doubles as node runtime index, this maps it back to the node
+    [[nodiscard]] const std::vector<uuids::uuid>& getNodeIDs() const { return mNodeIDs; }
+
+    // number of temporary poses needed at once, slots are reused once their last reader ran
+    [[nodiscard]] size_t getPoseSlotCount() const { return mPoseSlotCount; }
+
+    // built from node types and links only, so separately loaded copies of one graph hash equally
+    // properties are not part of it, they change without recompiling the plan
+    [[nodiscard]] size_t getStructureHash() const { return mStructureHash; }
+
+    [[nodiscard]] bool canSharePose() const { return mCanSharePose; }
+
+    // slot of a declared parameter, invalid if graph declares no parameter of this type with the id
+    [[nodiscard]] AnimParamSlot findParameterSlot(AnimParamID id, AnimParamType type) const;
+
+    // ids and defaults of parameters in slot order, floats and bools have separate slot ranges
+    [[nodiscard]] const std::vector<AnimParamID>& getFloatParameterIDs() const { return mFloatParameterIDs; }
+    [[nodiscard]] const std::vector<float>& getFloatParameterDefaults() const { return mFloatParameterDefaults; }
+    [[nodiscard]] const std::vector<AnimParamID>& getBoolParameterIDs() const { return mBoolParameterIDs; }
+    [[nodiscard]] const std::vector<uint8_t>& getBoolParameterDefaults() const { return mBoolParameterDefaults; }
+
+    // node whose pose the output node passes on, nullptr if output is not connected
+    [[nodiscard]] const AnimGraphNode* getFinalPoseSource() const { return mFinalPoseSource; }
+
+    // final pose has to outlive evaluation, so the animator can finish deferred work on it
+    [[nodiscard]] bool defersFinalPose() const { return mDefersFinalPose; }
+
+private:
+    std::vector<Instruction> mInstructions;
+    std::vector<int> mInputSlots;
+    std::vector<int> mInputInstructions;
+    std::vector<uuids::uuid> mNodeIDs;
+
+    size_t mPoseSlotCount = 0;
+
+    size_t mStructureHash = 0;
+
+    bool mCanSharePose = true;
+
+    const AnimGraphNode* mFinalPoseSource = nullptr;
+
+    bool mDefersFinalPose = false;
+
+    struct ParameterLookup
+    {
+        AnimParamID id;
+        AnimParamType type = AnimParamType::Float;
+        int slot = -1;
+    };
+
+    // sorted by id, so lookups are a binary search over a flat array
+    std::vector<ParameterLookup> mParameterLookups;
+
+    std::vector<AnimParamID> mFloatParameterIDs;
+    std::vector<float> mFloatParameterDefaults;
+    std::vector<AnimParamID> mBoolParameterIDs;
+    std::vector<uint8_t> mBoolParameterDefaults;
+
+    void compileParameters(const AnimGraph& graph);
+};
+} // namespace Core::Animations
@@ -1,5 +1,10 @@
 #pragma once
 
+#include "animations/AnimationsData.h"
+#include "animations/ik/TwoBoneIKBatch.h"
+
+#include <vector>
+
 namespace Core::Resources
 {
 struct SkeletonData;
@@ -10,11 +15,37 @@ namespace Core::Component
 class MeshComponent;
 }
 
+namespace Core::Scene
+{
+class Scene;
+}
+
 namespace Core::Animations
 {
 class AnimGraph;
 class AnimInstance;
-struct AnimationClip;
+class PosePool;
+class AnimationDatabase;
+
+// buffers reused by every evaluation running on the same thread, so per-frame work doesn't reallocate them
+struct AnimationScratch
+{
+    // graph output of the mesh being updated
+    Pose pose;
+
+    // ik solvers, globals of chain bones only
+    std::vector<glm::mat4> chainGlobals;
+    std::vector<glm::vec3> chainPositions;
+    std::vector<float> chainLengths;
+
+    TwoBoneIKBatchScratch twoBoneIK;
+
+    // two bone chains queued by meshes this thread evaluated, solved in one batch after all meshes are evaluated
+    std::vector<TwoBoneIKRequest> twoBoneIKRequests;
+
+    // graph inputs skipped this frame for contributing too little to the final pose
+    uint32_t prunedSubgraphCount = 0;
+};
 
 struct AnimationContext
 {
@@ -28,8 +59,19 @@ struct AnimationContext
     // I don't know do I like it here. probably not
     Component::MeshComponent* meshComponent = nullptr;
 
-    // TODO
-    // implement something like AnimationsDatabase and store only reference to it in context
-    const std::vector<AnimationClip>* animations = nullptr;
+    // clips played by graph nodes, shared by all instances
+    const AnimationDatabase* database = nullptr;
+
+    // resolves scene references of graph nodes, such as ik targets
+    Scene::Scene* scene = nullptr;
+
+    // owned by the thread evaluating the graph
+    AnimationScratch* scratch = nullptr;
+
+    // set when the caller solves two bone ik of the final pose in a batch, ik nodes then queue their chains here
+    std::vector<TwoBoneIKRequest>* twoBoneIKRequests = nullptr;
+
+    // owned by the instance, temporary poses of graph nodes
+    PosePool* posePool = nullptr;
 };
 } // namespace Core::Animations
\ No newline at end of file
@@ -2,7 +2,6 @@
 
 #include "animations/AnimationsData.h"
 #include "animations/Animator.h"
-#include "animations/anim-graph/AnimGraphLink.h"
 #include "animations/anim-graph/AnimationContext.h"
 
 Core::Animations::AnimGraphBlendNode::AnimGraphBlendNode()
@@ -14,36 +13,43 @@ Core::Animations::AnimGraphBlendNode::AnimGraphBlendNode()
     mOutputPin = createOutputPin(AnimGraphValueType::Pose);
 }
 
-Core::Animations::Pose Core::Animations::AnimGraphBlendNode::evaluate(AnimationContext& context) const
+void Core::Animations::AnimGraphBlendNode::evaluate(AnimationContext& context, std::span<const Pose* const> inputs,
+                                                    AnimGraphNodeRuntime& runtime, Pose& outPose) const
 {
-    const auto* graph = context.graph;
-    if (!graph)
+    const Pose* poseA = inputs[0];
+    const Pose* poseB = inputs[1];
+    if (!poseA || !poseB)
     {
-        return context.skeletonData->referencePose;
+        outPose = context.skeletonData->referencePose;
+        return;
     }
 
-    const auto* linkA = graph->findLinkByInputPin(mInputA);
-    const auto* linkB = graph->findLinkByInputPin(mInputB);
-    if (!linkA || !linkB)
+    if (isInputPruned(runtime, mAlpha))
     {
-        return context.skeletonData->referencePose;
+        outPose = *poseA;
+        return;
     }
 
-    const auto* nodeA = graph->findNodeByPin(linkA->startPin);
-    const auto* nodeB = graph->findNodeByPin(linkB->startPin);
-    if (!nodeA || !nodeB)
+    if (isInputPruned(runtime, 1.f - mAlpha))
     {
-        return context.skeletonData->referencePose;
+        outPose = *poseB;
+        return;
     }
 
-    const Pose poseA = nodeA->evaluate(context);
-    const Pose poseB = nodeB->evaluate(context);
+    Animator::blendPoses(*poseA, *poseB, mAlpha, outPose);
+}
+
+void Core::Animations::AnimGraphBlendNode::updateInputWeights(AnimationContext&, AnimGraphNodeRuntime&,
+                                                              std::span<float> outWeights) const
+{
+    outWeights[0] = 1.f - mAlpha;
+    outWeights[1] = mAlpha;
+}
 
-    float alpha = 0.5f;
-    if (const auto* property = getProperty("alpha"))
+void Core::Animations::AnimGraphBlendNode::onPropertyChanged(const std::string& name)
+{
+    if (name == "alpha")
     {
-        alpha = std::get<float>(*property);
+        mAlpha = std::get<float>(*getProperty(name));
     }
-
-    return Animator::blendPoses(poseA, poseB, alpha);
-}
\ No newline at end of file
+}
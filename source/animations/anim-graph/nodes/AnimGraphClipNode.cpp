@@ -1,36 +1,72 @@
 #include "AnimGraphClipNode.h"
 
+#include "AnimGraphNodeRuntime.h"
 #include "animations/Animator.h"
 #include "animations/anim-graph/AnimationContext.h"
 
 Core::Animations::AnimGraphClipNode::AnimGraphClipNode() { mOutputPin = createOutputPin(AnimGraphValueType::Pose); }
 
-Core::Animations::Pose Core::Animations::AnimGraphClipNode::evaluate(AnimationContext& context) const
+void Core::Animations::AnimGraphClipNode::evaluate(AnimationContext& context, std::span<const Pose* const>,
+                                                   AnimGraphNodeRuntime& runtime, Pose& outPose) const
 {
-    auto& runtime = context.instance->getRuntime(getUUID());
+    const AnimationClip* clip = findClip(context);
+    const AnimationClipBinding* binding = clip ? context.database->getBinding(mClip, *context.skeletonData) : nullptr;
 
-    if (!context.animations || context.animations->empty())
+    if (!binding)
     {
-        return context.skeletonData->referencePose;
+        outPose = context.skeletonData->referencePose;
+        return;
     }
 
-    int clipIndex = -1;
-    if (auto* property = getProperty("clipIndex"))
+    advanceTime(context, runtime);
+
+    Animator::sampleClip(*clip, *binding, runtime.time, *context.skeletonData, runtime.cursors, outPose);
+}
+
+void Core::Animations::AnimGraphClipNode::advanceTime(AnimationContext& context, AnimGraphNodeRuntime& runtime) const
+{
+    const AnimationClip* clip = findClip(context);
+    if (!clip)
     {
-        clipIndex = std::get<int>(*property);
+        return;
     }
 
-    if (clipIndex < 0 || clipIndex >= context.animations->size())
+    const float ticksPerSecond = clip->ticksPerSecond != 0 ? clip->ticksPerSecond : 30.f;
+
+    runtime.time += context.deltaTime * ticksPerSecond;
+    runtime.time = fmod(runtime.time, clip->duration);
+}
+
+size_t Core::Animations::AnimGraphClipNode::getStateHash(const AnimationContext& context,
+                                                        const AnimGraphNodeRuntime& runtime,
+                                                        const float timeQuantum) const
+{
+    const AnimationClip* clip = findClip(context);
+    if (!clip)
     {
-        return context.skeletonData->referencePose;
+        return 0;
     }
 
-    const auto& clip = (*context.animations)[clipIndex];
+    if (timeQuantum <= 0.f)
+    {
+        return std::hash<float>{}(runtime.time);
+    }
 
-    const float ticksPerSecond = clip.ticksPerSecond != 0 ? clip.ticksPerSecond : 30.f;
+    const float ticksPerSecond = clip->ticksPerSecond != 0 ? clip->ticksPerSecond : 30.f;
 
-    runtime.time += context.deltaTime * ticksPerSecond;
-    runtime.time = fmod(runtime.time, clip.duration);
+    return std::hash<int64_t>{}(static_cast<int64_t>(runtime.time / ticksPerSecond / timeQuantum));
+}
 
-    return Animator::sampleClip(clip, runtime.time, *context.skeletonData, context.skeletonData->rootNode);
-}
\ No newline at end of file
+void Core::Animations::AnimGraphClipNode::onPropertyChanged(const std::string& name)
+{
+    if (name == "clip")
+    {
+        mClip.id = static_cast<uint32_t>(std::get<int>(*getProperty(name)));
+    }
+}
+
+const Core::Animations::AnimationClip*
+Core::Animations::AnimGraphClipNode::findClip(const AnimationContext& context) const
+{
+    return context.database ? context.database->getClip(mClip) : nullptr;
+}
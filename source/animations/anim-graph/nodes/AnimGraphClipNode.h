@@ -2,21 +2,35 @@
 #pragma once
 
 #include "AnimGraphNode.h"
+#include "animations/AnimationDatabase.h"
 
 namespace Core::Animations
 {
-struct AnimationClip;
 
 class AnimGraphClipNode final : public AnimGraphNode
 {
 public:
     AnimGraphClipNode();
 
-    Pose evaluate(AnimationContext& context) const override;
+    void evaluate(AnimationContext& context, std::span<const Pose* const> inputs, AnimGraphNodeRuntime& runtime,
+                  Pose& outPose) const override;
+
+    void advanceTime(AnimationContext& context, AnimGraphNodeRuntime& runtime) const override;
+
+    [[nodiscard]] size_t getStateHash(const AnimationContext& context, const AnimGraphNodeRuntime& runtime,
+                                      float timeQuantum) const override;
 
     [[nodiscard]] PinID getOutputPin() const { return mOutputPin; }
 
+protected:
+    void onPropertyChanged(const std::string& name) override;
+
 private:
+    // cached "clip" property value, which holds handle id, so evaluation doesn't look it up by name
+    AnimationClipHandle mClip;
+
+    [[nodiscard]] const AnimationClip* findClip(const AnimationContext& context) const;
+
     PinID mOutputPin{};
 };
 
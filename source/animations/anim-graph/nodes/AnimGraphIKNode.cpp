@@ -2,6 +2,7 @@
 
 #include "animations/anim-graph/AnimGraph.h"
 #include "animations/anim-graph/AnimationContext.h"
+#include "animations/ik/IKSolverTwoBone.h"
 
 Core::Animations::AnimGraphIKNode::AnimGraphIKNode()
 {
@@ -9,32 +10,65 @@ Core::Animations::AnimGraphIKNode::AnimGraphIKNode()
     mOutputPin = createOutputPin(AnimGraphValueType::Pose);
 }
 
-Core::Animations::Pose Core::Animations::AnimGraphIKNode::evaluate(AnimationContext& context) const
+void Core::Animations::AnimGraphIKNode::evaluate(AnimationContext& context, std::span<const Pose* const> inputs,
+                                                 AnimGraphNodeRuntime&, Pose& outPose) const
 {
-    const auto* graph = context.graph;
-    if (!graph)
+    if (!inputs[0])
     {
-        return context.skeletonData->referencePose;
+        outPose = context.skeletonData->referencePose;
+        return;
     }
 
-    const auto* link = graph->findLinkByInputPin(mInputPin);
-    if (!link)
+    outPose = *inputs[0];
+
+    const size_t firstDeferredSolver = getFirstDeferredSolver(context);
+
+    for (size_t i = 0; i < firstDeferredSolver; ++i)
+    {
+        mSolvers[i]->solve(context.scene, *context.skeletonData, outPose, *context.scratch);
+    }
+
+    // output node only copies this pose, so the caller binds queued chains to the final pose once evaluation is done
+    for (size_t i = firstDeferredSolver; i < mSolvers.size(); ++i)
     {
-        return context.skeletonData->referencePose;
+        const auto& solver = static_cast<const IKSolverTwoBone&>(*mSolvers[i]);
+
+        if (TwoBoneIKRequest request; solver.buildRequest(context.scene, *context.skeletonData, request))
+        {
+            context.twoBoneIKRequests->push_back(request);
+        }
     }
+}
 
-    const auto* sourceNode = graph->findNodeByPin(link->startPin);
-    if (!sourceNode)
+size_t Core::Animations::AnimGraphIKNode::getFirstDeferredSolver(const AnimationContext& context) const
+{
+    if (!context.twoBoneIKRequests || !context.graph || context.graph->getPlan().getFinalPoseSource() != this)
     {
-        return context.skeletonData->referencePose;
+        return mSolvers.size();
     }
 
-    Pose pose = sourceNode->evaluate(context);
+    // solvers before the first non two bone one still run in order, only the trailing run can wait
+    size_t firstDeferredSolver = mSolvers.size();
+    while (firstDeferredSolver > 0 && mSolvers[firstDeferredSolver - 1]->getType() == AnimationSolverType::TwoBone &&
+           mSolvers[firstDeferredSolver - 1]->getChainIndices().size() >= 3)
+    {
+        --firstDeferredSolver;
+    }
 
-    for (const auto& solver : mSolvers)
+    // batch solves all chains of a pose at once, which only matches solving them one by one for separate limbs
+    for (size_t i = firstDeferredSolver; i < mSolvers.size(); ++i)
     {
-        solver->solve(*context.skeletonData, pose);
+        const std::array<int, 3> limb = static_cast<const IKSolverTwoBone&>(*mSolvers[i]).getLimb();
+
+        for (size_t j = i + 1; j < mSolvers.size(); ++j)
+        {
+            const std::array<int, 3> otherLimb = static_cast<const IKSolverTwoBone&>(*mSolvers[j]).getLimb();
+            if (!TwoBoneIKBatch::areLimbsIndependent(*context.skeletonData, limb, otherLimb))
+            {
+                return mSolvers.size();
+            }
+        }
     }
 
-    return pose;
-}
\ No newline at end of file
+    return firstDeferredSolver;
+}
@@ -26,7 +26,14 @@ public:
 
     std::vector<std::unique_ptr<IIKSolver>>& getSolvers() { return mSolvers; }
 
-    Pose evaluate(AnimationContext& context) const override;
+    void evaluate(AnimationContext& context, std::span<const Pose* const> inputs, AnimGraphNodeRuntime& runtime,
+                  Pose& outPose) const override;
+
+    // solvers chase targets in the scene around the instance
+    [[nodiscard]] bool canSharePose() const override { return false; }
+
+    // trailing two bone solvers are queued for the animator batch when this node produces the final pose
+    [[nodiscard]] bool canDeferToAnimator() const override { return true; }
 
 private:
     PinID mInputPin{};
@@ -34,6 +41,9 @@ private:
     PinID mOutputPin{};
 
     std::vector<std::unique_ptr<IIKSolver>> mSolvers;
+
+    // index of the first solver left for the batch, solvers.size() if every solver runs here
+    [[nodiscard]] size_t getFirstDeferredSolver(const AnimationContext& context) const;
 };
 
 } // namespace Core::Animations
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include "AnimGraphInertializationNode.h"
+
+#include "animations/AnimInstance.h"
+#include "animations/anim-graph/AnimationContext.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+using namespace Core::Animations;
+
+// offsets shorter than this are not decayed at all
+constexpr float minOffset = 1e-5f;
+
+// quintic from Bollo's Gears of War inertialization talk, offset x0 moving with velocity v0 along the axis
+// reaches zero with zero velocity and acceleration at the channel duration
+InertializedChannel createChannel(const glm::vec3& axis, const float x0, float v0, const float blendTime)
+{
+    InertializedChannel channel;
+    if (x0 < minOffset || blendTime <= 0.f)
+    {
+        return channel;
+    }
+
+    // offset moving away from zero would overshoot, so only velocity towards zero is kept
+    v0 = std::min(v0, 0.f);
+
+    // fast offsets reach zero sooner, otherwise the curve would have to swing past zero
+    float duration = blendTime;
+    if (v0 < 0.f)
+    {
+        duration = std::min(duration, -5.f * x0 / v0);
+    }
+
+    const float t1 = duration;
+    const float t2 = t1 * t1;
+    const float t3 = t2 * t1;
+    const float t4 = t3 * t1;
+    const float t5 = t4 * t1;
+
+    const float a0 = std::max((-8.f * v0 * t1 - 20.f * x0) / t2, 0.f);
+
+    channel.axis = axis;
+    channel.duration = duration;
+    channel.coefficients = {-(a0 * t2 + 6.f * v0 * t1 + 12.f * x0) / (2.f * t5),
+                            (3.f * a0 * t2 + 16.f * v0 * t1 + 30.f * x0) / (2.f * t4),
+                            -(3.f * a0 * t2 + 12.f * v0 * t1 + 20.f * x0) / (2.f * t3),
+                            a0 * 0.5f,
+                            v0,
+                            x0};
+
+    return channel;
+}
+
+float evaluateChannel(const InertializedChannel& channel, const float time)
+{
+    if (time >= channel.duration)
+    {
+        return 0.f;
+    }
+
+    float value = 0.f;
+    for (const float coefficient : channel.coefficients)
+    {
+        value = value * time + coefficient;
+    }
+
+    return value;
+}
+
+// angle is in [0, pi], axis is zero for rotations too small to have one
+void toAxisAngle(glm::quat rotation, glm::vec3& outAxis, float& outAngle)
+{
+    if (rotation.w < 0.f)
+    {
+        rotation = -rotation;
+    }
+
+    const glm::vec3 imaginary{rotation.x, rotation.y, rotation.z};
+    const float sinHalfAngle = glm::length(imaginary);
+
+    outAngle = 2.f * std::atan2(sinHalfAngle, rotation.w);
+    outAxis = sinHalfAngle > minOffset ? imaginary / sinHalfAngle : glm::vec3(0.f);
+}
+
+// offsets take the previous output to target, velocities come from the previous two outputs
+void startTransition(InertializationRuntime& state, const Pose& target, const float blendTime)
+{
+    const size_t boneCount = target.size();
+
+    state.positionOffsets.resize(boneCount);
+    state.rotationOffsets.resize(boneCount);
+
+    const bool hasVelocity = state.historySize >= 2 && state.previousPoseInterval > 0.f &&
+                             state.olderPose.size() == boneCount;
+    const float inverseInterval = hasVelocity ? 1.f / state.previousPoseInterval : 0.f;
+
+    state.duration = 0.f;
+
+    for (size_t bone = 0; bone < boneCount; ++bone)
+    {
+        const glm::vec3& previousPosition = state.previousPose.positions[bone];
+        const glm::vec3 offset = previousPosition - target.positions[bone];
+        const float distance = glm::length(offset);
+        const glm::vec3 axis = distance > minOffset ? offset / distance : glm::vec3(0.f);
+
+        float speed = 0.f;
+        if (hasVelocity)
+        {
+            speed = glm::dot(previousPosition - state.olderPose.positions[bone], axis) * inverseInterval;
+        }
+
+        state.positionOffsets[bone] = createChannel(axis, distance, speed, blendTime);
+
+        // previous = offset * target, and previous = delta * older, so both rotate in the same frame
+        const glm::quat& previousRotation = state.previousPose.rotations[bone];
+
+        glm::vec3 rotationAxis;
+        float angle;
+        toAxisAngle(previousRotation * glm::inverse(target.rotations[bone]), rotationAxis, angle);
+
+        float angularSpeed = 0.f;
+        if (hasVelocity)
+        {
+            glm::vec3 deltaAxis;
+            float deltaAngle;
+            toAxisAngle(previousRotation * glm::inverse(state.olderPose.rotations[bone]), deltaAxis, deltaAngle);
+
+            angularSpeed = glm::dot(deltaAxis, rotationAxis) * deltaAngle * inverseInterval;
+        }
+
+        state.rotationOffsets[bone] = createChannel(rotationAxis, angle, angularSpeed, blendTime);
+
+        state.duration =
+            std::max({state.duration, state.positionOffsets[bone].duration, state.rotationOffsets[bone].duration});
+    }
+
+    // offsets were measured at the previous output, so the time since then is already part of the transition
+    state.elapsed = std::min(state.timeSincePreviousPose, state.duration);
+}
+
+// scales are taken from target as they are
+void applyOffsets(const InertializationRuntime& state, const Pose& target, Pose& outPose)
+{
+    outPose = target;
+
+    for (size_t bone = 0; bone < target.size(); ++bone)
+    {
+        const InertializedChannel& position = state.positionOffsets[bone];
+        outPose.positions[bone] += position.axis * evaluateChannel(position, state.elapsed);
+
+        const InertializedChannel& rotation = state.rotationOffsets[bone];
+        if (const float angle = evaluateChannel(rotation, state.elapsed); angle != 0.f)
+        {
+            outPose.rotations[bone] = glm::angleAxis(angle, rotation.axis) * target.rotations[bone];
+        }
+    }
+}
+} // namespace
+
+Core::Animations::AnimGraphInertializationNode::AnimGraphInertializationNode()
+{
+    mInputA = createInputPin(AnimGraphValueType::Pose);
+
+    mInputB = createInputPin(AnimGraphValueType::Pose);
+
+    mOutputPin = createOutputPin(AnimGraphValueType::Pose);
+}
+
+void Core::Animations::AnimGraphInertializationNode::evaluate(AnimationContext& context,
+                                                              std::span<const Pose* const> inputs,
+                                                              AnimGraphNodeRuntime& runtime, Pose& outPose) const
+{
+    advanceTime(context, runtime);
+
+    InertializationRuntime& state = runtime.getState<InertializationRuntime>();
+
+    const int activeInput = getActiveInput(context, state);
+    const Pose& target = inputs[activeInput] ? *inputs[activeInput] : context.skeletonData->referencePose;
+
+    if (activeInput != state.activeInput)
+    {
+        if (state.historySize > 0 && state.previousPose.size() == target.size())
+        {
+            startTransition(state, target, mBlendTime);
+        }
+
+        state.activeInput = activeInput;
+    }
+
+    if (state.isTransitioning())
+    {
+        applyOffsets(state, target, outPose);
+    }
+    else
+    {
+        outPose = target;
+    }
+
+    // older pose storage is reused for the new output
+    std::swap(state.previousPose, state.olderPose);
+    state.previousPose = outPose;
+    state.previousPoseInterval = state.timeSincePreviousPose;
+    state.timeSincePreviousPose = 0.f;
+    state.historySize = std::min(state.historySize + 1, 2u);
+}
+
+void Core::Animations::AnimGraphInertializationNode::advanceTime(AnimationContext& context,
+                                                                 AnimGraphNodeRuntime& runtime) const
+{
+    InertializationRuntime& state = runtime.getState<InertializationRuntime>();
+
+    // switches seen only here have no pose to measure offsets from, they snap once the node is evaluated again
+    state.elapsed = std::min(state.elapsed + context.deltaTime, state.duration);
+    state.timeSincePreviousPose += context.deltaTime;
+}
+
+void Core::Animations::AnimGraphInertializationNode::updateInputWeights(AnimationContext& context,
+                                                                        AnimGraphNodeRuntime& runtime,
+                                                                        std::span<float> outWeights) const
+{
+    const int activeInput = getActiveInput(context, runtime.getState<InertializationRuntime>());
+
+    outWeights[0] = activeInput == 0 ? 1.f : 0.f;
+    outWeights[1] = activeInput == 1 ? 1.f : 0.f;
+}
+
+size_t Core::Animations::AnimGraphInertializationNode::getStateHash(const AnimationContext&,
+                                                                    const AnimGraphNodeRuntime& runtime, float) const
+{
+    if (const auto* state = runtime.findState<InertializationRuntime>(); state && state->isTransitioning())
+    {
+        return std::hash<const void*>{}(&runtime);
+    }
+
+    return 0;
+}
+
+void Core::Animations::AnimGraphInertializationNode::onPropertyChanged(const std::string& name)
+{
+    if (name == "parameter")
+    {
+        mParameter.id = static_cast<uint32_t>(std::get<int>(*getProperty(name)));
+    }
+    else if (name == "blendTime")
+    {
+        mBlendTime = std::get<float>(*getProperty(name));
+    }
+}
+
+int Core::Animations::AnimGraphInertializationNode::getActiveInput(const AnimationContext& context,
+                                                                   InertializationRuntime& state) const
+{
+    if (!context.instance)
+    {
+        return 0;
+    }
+
+    const AnimParamSlot slot = context.instance->findSlot(state.parameterSlot, mParameter, AnimParamType::Bool);
+    return context.instance->getBool(slot) ? 1 : 0;
+}
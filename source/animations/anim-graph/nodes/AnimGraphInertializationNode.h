@@ -0,0 +1,49 @@
+#pragma once
+
+#include "AnimGraphNode.h"
+#include "animations/AnimParamID.h"
+
+namespace Core::Animations
+{
+// plays input B while its bool parameter is set and input A otherwise
+// on a switch the difference to the previous output decays over blendTime, so only the new input is evaluated
+class AnimGraphInertializationNode final : public AnimGraphNode
+{
+public:
+    AnimGraphInertializationNode();
+
+    [[nodiscard]] PinID getInputAPin() const { return mInputA; }
+
+    [[nodiscard]] PinID getInputBPin() const { return mInputB; }
+
+    [[nodiscard]] PinID getOutputPin() const { return mOutputPin; }
+
+    void evaluate(AnimationContext& context, std::span<const Pose* const> inputs, AnimGraphNodeRuntime& runtime,
+                  Pose& outPose) const override;
+
+    void advanceTime(AnimationContext& context, AnimGraphNodeRuntime& runtime) const override;
+
+    void updateInputWeights(AnimationContext& context, AnimGraphNodeRuntime& runtime,
+                            std::span<float> outWeights) const override;
+
+    // offsets differ between instances, so a transitioning instance never shares its pose
+    [[nodiscard]] size_t getStateHash(const AnimationContext& context, const AnimGraphNodeRuntime& runtime,
+                                      float timeQuantum) const override;
+
+protected:
+    void onPropertyChanged(const std::string& name) override;
+
+private:
+    // cached property values, "parameter" holds the id of a bool parameter
+    AnimParamID mParameter;
+    float mBlendTime = 0.2f;
+
+    PinID mInputA{};
+    PinID mInputB{};
+
+    PinID mOutputPin{};
+
+    // slot of the parameter is cached in the runtime, so it is searched only after a recompile
+    [[nodiscard]] int getActiveInput(const AnimationContext& context, InertializationRuntime& state) const;
+};
+} // namespace Core::Animations
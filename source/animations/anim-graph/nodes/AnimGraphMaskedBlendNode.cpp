@@ -2,7 +2,6 @@
 
 #include "animations/AnimationsData.h"
 #include "animations/Animator.h"
-#include "animations/anim-graph/AnimGraphLink.h"
 #include "animations/anim-graph/AnimationContext.h"
 
 Core::Animations::AnimGraphMaskedBlendNode::AnimGraphMaskedBlendNode()
@@ -14,49 +13,70 @@ Core::Animations::AnimGraphMaskedBlendNode::AnimGraphMaskedBlendNode()
     mOutputPin = createOutputPin(AnimGraphValueType::Pose);
 }
 
-Core::Animations::Pose Core::Animations::AnimGraphMaskedBlendNode::evaluate(AnimationContext& context) const
+void Core::Animations::AnimGraphMaskedBlendNode::evaluate(AnimationContext& context,
+                                                          std::span<const Pose* const> inputs,
+                                                          AnimGraphNodeRuntime& runtime, Pose& outPose) const
 {
-    const auto* graph = context.graph;
-    if (!graph)
+    const Pose* poseA = inputs[0];
+    const Pose* poseB = inputs[1];
+    if (!poseA || !poseB)
     {
-        return context.skeletonData->referencePose;
+        outPose = context.skeletonData->referencePose;
+        return;
     }
 
-    const auto* linkA = graph->findLinkByInputPin(mInputA);
-    const auto* linkB = graph->findLinkByInputPin(mInputB);
-    if (!linkA || !linkB)
+    if (mMaskIndex < 0 || mMaskIndex >= context.meshComponent->getMasksCount())
     {
-        return context.skeletonData->referencePose;
+        outPose = context.skeletonData->referencePose;
+        return;
     }
 
-    const auto* nodeA = graph->findNodeByPin(linkA->startPin);
-    const auto* nodeB = graph->findNodeByPin(linkB->startPin);
-    if (!nodeA || !nodeB)
-    {
-        return context.skeletonData->referencePose;
-    }
+    const AnimationMask& mask = context.meshComponent->getCompiledMask(mMaskIndex);
+    const float alpha = glm::clamp(mAlpha, 0.f, 1.f);
 
-    const Pose poseA = nodeA->evaluate(context);
-    const Pose poseB = nodeB->evaluate(context);
-
-    float alpha = 0.5f;
-    if (const auto* property = getProperty("alpha"))
+    // empty or full masks take the whole pose from one side
+    if (isInputPruned(runtime, mask.compiledMaxWeight * alpha))
     {
-        alpha = std::get<float>(*property);
+        outPose = *poseA;
+        return;
     }
 
-    int maskIndex = -1;
-    if (const auto* property = getProperty("maskIndex"))
+    if (isInputPruned(runtime, 1.f - mask.compiledMinWeight * alpha))
     {
-        maskIndex = std::get<int>(*property);
+        outPose = *poseB;
+        return;
     }
 
-    if (maskIndex < 0 || maskIndex >= context.meshComponent->getMasksCount())
+    Animator::blendMaskedPoses(*poseA, *poseB, mask.compiledWeights, alpha, outPose);
+}
+
+void Core::Animations::AnimGraphMaskedBlendNode::updateInputWeights(AnimationContext& context, AnimGraphNodeRuntime&,
+                                                                    std::span<float> outWeights) const
+{
+    // evaluation falls back to reference pose without a valid mask
+    if (mMaskIndex < 0 || mMaskIndex >= context.meshComponent->getMasksCount())
     {
-        return context.skeletonData->referencePose;
+        outWeights[0] = 0.f;
+        outWeights[1] = 0.f;
+        return;
     }
 
-    const auto& mask = context.meshComponent->getMask(maskIndex);
+    const AnimationMask& mask = context.meshComponent->getCompiledMask(mMaskIndex);
+    const float alpha = glm::clamp(mAlpha, 0.f, 1.f);
+
+    // bone least affected by the mask takes the most of poseA
+    outWeights[0] = 1.f - mask.compiledMinWeight * alpha;
+    outWeights[1] = mask.compiledMaxWeight * alpha;
+}
 
-    return Animator::blendMaskedPoses(poseA, poseB, *context.skeletonData, mask, alpha);
-}
\ No newline at end of file
+void Core::Animations::AnimGraphMaskedBlendNode::onPropertyChanged(const std::string& name)
+{
+    if (name == "alpha")
+    {
+        mAlpha = std::get<float>(*getProperty(name));
+    }
+    else if (name == "maskIndex")
+    {
+        mMaskIndex = std::get<int>(*getProperty(name));
+    }
+}
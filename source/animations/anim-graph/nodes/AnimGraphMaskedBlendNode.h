@@ -15,9 +15,20 @@ public:
 
     [[nodiscard]] PinID getOutputPin() const { return mOutputPin; }
 
-    Pose evaluate(AnimationContext& context) const override;
+    void evaluate(AnimationContext& context, std::span<const Pose* const> inputs, AnimGraphNodeRuntime& runtime,
+                  Pose& outPose) const override;
+
+    void updateInputWeights(AnimationContext& context, AnimGraphNodeRuntime& runtime,
+                            std::span<float> outWeights) const override;
+
+protected:
+    void onPropertyChanged(const std::string& name) override;
 
 private:
+    // cached property values, so evaluation doesn't look them up by name
+    float mAlpha = 0.5f;
+    int mMaskIndex = -1;
+
     PinID mInputA{};
     PinID mInputB{};
 
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "uuid.h"
+#include "AnimGraphNodeRuntime.h"
 #include "animations/anim-graph/AnimGraphPin.h"
 
+#include <span>
 #include <variant>
 
 namespace Core::Animations
@@ -16,6 +18,9 @@ inline uuids::uuid generateUUID()
 
 using PropertyValue = std::variant<float, int, bool, uuids::uuid>;
 
+// inputs contributing less than this to the final pose are not evaluated, their nodes only advance time
+constexpr float prunedInputWeight = 1e-3f;
+
 struct Pose;
 struct AnimationContext;
 
@@ -24,13 +29,45 @@ class AnimGraphNode
 public:
     virtual ~AnimGraphNode() = default;
 
-    virtual Pose evaluate(AnimationContext& context) const = 0;
+    // inputs hold pose of every input pin in pin order, nullptr for pins without a link
+    // runtime is the per-instance state of this node
+    virtual void evaluate(AnimationContext& context, std::span<const Pose* const> inputs,
+                          AnimGraphNodeRuntime& runtime, Pose& outPose) const = 0;
+
+    // advances node time without building a pose, used for meshes which are not visible and for pruned inputs
+    virtual void advanceTime(AnimationContext&, AnimGraphNodeRuntime&) const {}
+
+    // share of this node's pose taken from every input pin, runs before evaluation to find inputs to prune
+    // nodes choosing their inputs from runtime state update that state here, instead of advanceTime
+    // outWeights has one entry per input pin and starts at 1
+    virtual void updateInputWeights(AnimationContext&, AnimGraphNodeRuntime&, std::span<float>) const {}
+
+    // hash of the runtime state this node's pose depends on, instances with equal states can share one pose
+    // times are snapped to timeQuantum seconds, so instances at nearly the same phase share too
+    [[nodiscard]] virtual size_t getStateHash(const AnimationContext&, const AnimGraphNodeRuntime&, float) const
+    {
+        return 0;
+    }
+
+    // false for nodes depending on the scene around the instance, their pose is never shared
+    [[nodiscard]] virtual bool canSharePose() const { return true; }
+
+    // true for nodes which can leave part of their work to a batched animator stage when they produce the final pose
+    [[nodiscard]] virtual bool canDeferToAnimator() const { return false; }
 
     [[nodiscard]] const uuids::uuid& getUUID() const { return mUUID; }
 
     void setProperty(const std::string& name, const PropertyValue& value)
     {
         mProperties[name] = value;
+
+        mPropertiesHash = 0;
+        for (const auto& [propertyName, propertyValue] : mProperties)
+        {
+            const size_t valueHash = std::hash<PropertyValue>{}(propertyValue);
+            mPropertiesHash += std::hash<std::string>{}(propertyName) ^ (valueHash << 1);
+        }
+
         onPropertyChanged(name);
     }
 
@@ -43,6 +80,9 @@ public:
         return nullptr;
     }
 
+    // order independent hash of all properties, kept up to date by setProperty
+    [[nodiscard]] size_t getPropertiesHash() const { return mPropertiesHash; }
+
     [[nodiscard]] const std::vector<AnimGraphPin>& getInputs() const { return mInputs; }
 
     [[nodiscard]] const std::vector<AnimGraphPin>& getOutputs() const { return mOutputs; }
@@ -50,6 +90,12 @@ public:
 protected:
     virtual void onPropertyChanged(const std::string&) {}
 
+    // true if input with inputWeight was pruned, its pose is then left unevaluated and must not be read
+    [[nodiscard]] static bool isInputPruned(const AnimGraphNodeRuntime& runtime, const float inputWeight)
+    {
+        return runtime.weight * inputWeight < prunedInputWeight;
+    }
+
     PinID createInputPin(const AnimGraphValueType type)
     {
         const PinID id = sNextPinID++;
@@ -78,5 +124,7 @@ private:
     uuids::uuid mUUID = generateUUID();
 
     std::unordered_map<std::string, PropertyValue> mProperties;
+
+    size_t mPropertiesHash = 0;
 };
 } // namespace Core::Animations
\ No newline at end of file
@@ -1,9 +1,104 @@
 #pragma once
 
+#include "animations/AnimParamID.h"
+#include "animations/AnimationsData.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
 namespace Core::Animations
 {
+// offset of one bone channel left by an inertialized switch, measured along a fixed axis
+// follows a quintic which reaches zero with zero velocity and acceleration at duration
+struct InertializedChannel
+{
+    glm::vec3 axis{0.f};
+    float duration = 0.f;
+    // polynomial coefficients from t^5 down to t^0
+    std::array<float, 6> coefficients{};
+};
+
+// runtime data of a single node type, created by the node the first time it needs it
+struct AnimGraphNodeState
+{
+    virtual ~AnimGraphNodeState() = default;
+};
+
+struct InertializationRuntime final : AnimGraphNodeState
+{
+    // input played by the last evaluation, -1 before the first one
+    int activeInput = -1;
+    // seconds since the last switch
+    float elapsed = 0.f;
+    // longest channel duration of the last switch, offsets are gone after it
+    float duration = 0.f;
+
+    // outputs of the last two evaluations, offsets and their velocities are measured from them
+    Pose previousPose;
+    Pose olderPose;
+    // seconds between olderPose and previousPose, and since previousPose was stored
+    float previousPoseInterval = 0.f;
+    float timeSincePreviousPose = 0.f;
+    // number of evaluations stored in the poses above, up to 2
+    uint32_t historySize = 0;
+
+    // slot of the bool parameter selecting the input
+    AnimParamSlotCache parameterSlot;
+
+    // per bone index
+    std::vector<InertializedChannel> positionOffsets;
+    std::vector<InertializedChannel> rotationOffsets;
+
+    [[nodiscard]] bool isTransitioning() const { return elapsed < duration; }
+};
+
+struct StateMachineRuntime final : AnimGraphNodeState
+{
+    // state index, -1 until the machine enters its first state
+    int currentState = -1;
+    // state faded out by the running transition, -1 without one
+    int previousState = -1;
+    float transitionElapsed = 0.f;
+    float transitionDuration = 0.f;
+
+    // parameter slots of transitions by transition index
+    std::vector<AnimParamSlotCache> transitionSlots;
+
+    [[nodiscard]] bool isTransitioning() const { return previousState >= 0; }
+
+    // weight of the current state, previous state takes the rest
+    [[nodiscard]] float getTransitionAlpha() const
+    {
+        return transitionDuration > 0.f ? transitionElapsed / transitionDuration : 1.f;
+    }
+};
+
 struct AnimGraphNodeRuntime
 {
     float time = 0.f;
+
+    // share of the final pose this node contributes this frame, product of input weights along the strongest path
+    float weight = 1.f;
+
+    // per channel sampling cursors of the clip played by this node
+    std::vector<AnimationChannelCursor> cursors;
+
+    // empty for node types without state of their own, so runtimes of most nodes stay small
+    std::unique_ptr<AnimGraphNodeState> state;
+
+    // runtime of a node always belongs to the same node, so it always holds the same state type
+    template <typename T> T& getState()
+    {
+        if (!state)
+        {
+            state = std::make_unique<T>();
+        }
+
+        return static_cast<T&>(*state);
+    }
+
+    // nullptr until the node created its state
+    template <typename T> [[nodiscard]] const T* findState() const { return static_cast<const T*>(state.get()); }
 };
 } // namespace Core::Animations
@@ -10,7 +10,8 @@ class AnimGraphOutputPoseNode final : public AnimGraphNode
 public:
     explicit AnimGraphOutputPoseNode();
 
-    Pose evaluate(AnimationContext& context) const override;
+    void evaluate(AnimationContext& context, std::span<const Pose* const> inputs, AnimGraphNodeRuntime& runtime,
+                  Pose& outPose) const override;
 
     [[nodiscard]] PinID getInputPin() const { return mInputPin; }
 
@@ -0,0 +1,239 @@
+#include "AnimGraphStateMachineNode.h"
+
+#include "animations/AnimInstance.h"
+#include "animations/AnimationsUtils.h"
+#include "animations/Animator.h"
+#include "animations/anim-graph/AnimationContext.h"
+
+#include <algorithm>
+
+namespace
+{
+using namespace Core::Animations;
+
+// pins of states added after the last plan compile are not part of inputs yet
+const Pose& getStatePose(const AnimationContext& context, std::span<const Pose* const> inputs, const int state)
+{
+    if (state >= 0 && state < static_cast<int>(inputs.size()) && inputs[state])
+    {
+        return *inputs[state];
+    }
+
+    return context.skeletonData->referencePose;
+}
+} // namespace
+
+Core::Animations::AnimGraphStateMachineNode::AnimGraphStateMachineNode()
+{
+    mOutputPin = createOutputPin(AnimGraphValueType::Pose);
+}
+
+int Core::Animations::AnimGraphStateMachineNode::addState(const std::string& name)
+{
+    mStates.push_back({name, createInputPin(AnimGraphValueType::Pose)});
+
+    return static_cast<int>(mStates.size()) - 1;
+}
+
+void Core::Animations::AnimGraphStateMachineNode::removeState(const int index)
+{
+    if (index < 0 || index >= static_cast<int>(mStates.size()))
+    {
+        return;
+    }
+
+    const PinID pin = mStates[index].inputPin;
+    std::erase_if(mInputs, [pin](const AnimGraphPin& input) { return input.id == pin; });
+    mStates.erase(mStates.begin() + index);
+
+    std::erase_if(mTransitions, [index](const AnimStateTransition& transition)
+                  { return transition.fromState == index || transition.toState == index; });
+
+    // states after the removed one move down by one
+    for (AnimStateTransition& transition : mTransitions)
+    {
+        if (transition.fromState > index)
+        {
+            --transition.fromState;
+        }
+        if (transition.toState > index)
+        {
+            --transition.toState;
+        }
+    }
+}
+
+void Core::Animations::AnimGraphStateMachineNode::evaluate(AnimationContext& context,
+                                                           std::span<const Pose* const> inputs,
+                                                           AnimGraphNodeRuntime& runtime, Pose& outPose) const
+{
+    const StateMachineRuntime& state = runtime.getState<StateMachineRuntime>();
+
+    const Pose& currentPose = getStatePose(context, inputs, state.currentState);
+    if (!state.isTransitioning())
+    {
+        outPose = currentPose;
+        return;
+    }
+
+    const float alpha = state.getTransitionAlpha();
+    if (isInputPruned(runtime, 1.f - alpha))
+    {
+        outPose = currentPose;
+        return;
+    }
+
+    const Pose& previousPose = getStatePose(context, inputs, state.previousState);
+    if (isInputPruned(runtime, alpha))
+    {
+        outPose = previousPose;
+        return;
+    }
+
+    Animator::blendPoses(previousPose, currentPose, alpha, outPose);
+}
+
+void Core::Animations::AnimGraphStateMachineNode::advanceTime(AnimationContext& context,
+                                                              AnimGraphNodeRuntime& runtime) const
+{
+    updateState(context, runtime.getState<StateMachineRuntime>());
+}
+
+void Core::Animations::AnimGraphStateMachineNode::updateInputWeights(AnimationContext& context,
+                                                                     AnimGraphNodeRuntime& runtime,
+                                                                     std::span<float> outWeights) const
+{
+    StateMachineRuntime& state = runtime.getState<StateMachineRuntime>();
+    updateState(context, state);
+
+    std::ranges::fill(outWeights, 0.f);
+
+    const float alpha = state.isTransitioning() ? state.getTransitionAlpha() : 1.f;
+    if (state.currentState >= 0 && state.currentState < static_cast<int>(outWeights.size()))
+    {
+        outWeights[state.currentState] = alpha;
+    }
+    if (state.previousState >= 0 && state.previousState < static_cast<int>(outWeights.size()))
+    {
+        outWeights[state.previousState] = 1.f - alpha;
+    }
+}
+
+size_t Core::Animations::AnimGraphStateMachineNode::getStateHash(const AnimationContext&,
+                                                                 const AnimGraphNodeRuntime& runtime,
+                                                                 const float timeQuantum) const
+{
+    const StateMachineRuntime* state = runtime.findState<StateMachineRuntime>();
+
+    // machine that was never updated plays no state yet
+    size_t hash = std::hash<int>{}(state ? state->currentState : -1);
+    if (!state || !state->isTransitioning())
+    {
+        return hash;
+    }
+
+    AnimationsUtils::hashCombine(hash, std::hash<int>{}(state->previousState));
+    if (timeQuantum <= 0.f)
+    {
+        AnimationsUtils::hashCombine(hash, std::hash<float>{}(state->transitionElapsed));
+    }
+    else
+    {
+        AnimationsUtils::hashCombine(hash, std::hash<int64_t>{}(
+                                               static_cast<int64_t>(state->transitionElapsed / timeQuantum)));
+    }
+
+    return hash;
+}
+
+void Core::Animations::AnimGraphStateMachineNode::updateState(const AnimationContext& context,
+                                                              StateMachineRuntime& state) const
+{
+    const int stateCount = static_cast<int>(mStates.size());
+
+    // states may have been removed since the last update, machine then starts over
+    if (state.currentState >= stateCount || state.previousState >= stateCount)
+    {
+        state = {};
+    }
+
+    if (stateCount == 0)
+    {
+        return;
+    }
+
+    // first state is the entry state
+    if (state.currentState < 0)
+    {
+        state.currentState = 0;
+    }
+
+    if (state.isTransitioning())
+    {
+        state.transitionElapsed += context.deltaTime;
+        if (state.transitionElapsed < state.transitionDuration)
+        {
+            return;
+        }
+
+        state.previousState = -1;
+    }
+
+    if (!context.instance)
+    {
+        return;
+    }
+
+    // transitions can be added and removed between updates, caches of surviving ones re-resolve themselves
+    state.transitionSlots.resize(mTransitions.size());
+
+    for (size_t i = 0; i < mTransitions.size(); ++i)
+    {
+        const AnimStateTransition& transition = mTransitions[i];
+
+        if (transition.fromState >= 0 && transition.fromState != state.currentState)
+        {
+            continue;
+        }
+
+        if (transition.toState == state.currentState || transition.toState < 0 || transition.toState >= stateCount)
+        {
+            continue;
+        }
+
+        if (!isConditionMet(transition, *context.instance, state.transitionSlots[i]))
+        {
+            continue;
+        }
+
+        state.previousState = transition.blendTime > 0.f ? state.currentState : -1;
+        state.currentState = transition.toState;
+        state.transitionElapsed = 0.f;
+        state.transitionDuration = transition.blendTime;
+        break;
+    }
+}
+
+bool Core::Animations::AnimGraphStateMachineNode::isConditionMet(const AnimStateTransition& transition,
+                                                                 const AnimInstance& instance,
+                                                                 AnimParamSlotCache& slotCache)
+{
+    const bool isBoolCondition = transition.condition == AnimTransitionCondition::BoolSet ||
+                                 transition.condition == AnimTransitionCondition::BoolCleared;
+    const AnimParamSlot slot = instance.findSlot(slotCache, transition.parameter,
+                                                 isBoolCondition ? AnimParamType::Bool : AnimParamType::Float);
+
+    switch (transition.condition)
+    {
+    case AnimTransitionCondition::BoolSet:
+        return instance.getBool(slot);
+    case AnimTransitionCondition::BoolCleared:
+        return !instance.getBool(slot);
+    case AnimTransitionCondition::FloatGreater:
+        return instance.getFloat(slot) > transition.threshold;
+    case AnimTransitionCondition::FloatLess:
+        return instance.getFloat(slot) < transition.threshold;
+    }
+
+    return false;
+}
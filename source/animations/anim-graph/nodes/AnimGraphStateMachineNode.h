@@ -0,0 +1,101 @@
+#pragma once
+
+#include "AnimGraphNode.h"
+#include "animations/AnimParamID.h"
+
+#include <string>
+#include <vector>
+
+namespace Core::Animations
+{
+class AnimInstance;
+
+enum class AnimTransitionCondition : uint8_t
+{
+    BoolSet,
+    BoolCleared,
+    FloatGreater,
+    FloatLess
+};
+
+// pose of the state comes from the input pin it owns
+struct AnimState
+{
+    std::string name;
+    PinID inputPin{};
+};
+
+struct AnimStateTransition
+{
+    // -1 lets the transition leave any state
+    int fromState = -1;
+    int toState = 0;
+
+    AnimParamID parameter;
+    AnimTransitionCondition condition = AnimTransitionCondition::BoolSet;
+    // float conditions compare the parameter against it
+    float threshold = 0.f;
+
+    // seconds of crossfade between the states
+    float blendTime = 0.2f;
+};
+
+// plays one state at a time and crossfades into the next one when a transition condition holds
+// states which are neither current nor fading out get no weight, so their subgraphs are pruned
+class AnimGraphStateMachineNode final : public AnimGraphNode
+{
+public:
+    AnimGraphStateMachineNode();
+
+    [[nodiscard]] PinID getOutputPin() const { return mOutputPin; }
+
+    // adds input pin of the state, graph plan has to be marked dirty afterwards
+    int addState(const std::string& name);
+
+    // removes input pin of the state and transitions touching it, graph plan has to be marked dirty afterwards
+    void removeState(int index);
+
+    [[nodiscard]] std::vector<AnimState>& getStates() { return mStates; }
+
+    [[nodiscard]] const std::vector<AnimState>& getStates() const { return mStates; }
+
+    void addTransition(const AnimStateTransition& transition) { mTransitions.push_back(transition); }
+
+    void removeTransition(const size_t index)
+    {
+        if (index < mTransitions.size())
+        {
+            mTransitions.erase(mTransitions.begin() + index);
+        }
+    }
+
+    // transitions are checked in order, first one whose condition holds is taken
+    [[nodiscard]] std::vector<AnimStateTransition>& getTransitions() { return mTransitions; }
+
+    void evaluate(AnimationContext& context, std::span<const Pose* const> inputs, AnimGraphNodeRuntime& runtime,
+                  Pose& outPose) const override;
+
+    void advanceTime(AnimationContext& context, AnimGraphNodeRuntime& runtime) const override;
+
+    // transitions are taken here, so pruning already sees the states this evaluation reads
+    void updateInputWeights(AnimationContext& context, AnimGraphNodeRuntime& runtime,
+                            std::span<float> outWeights) const override;
+
+    [[nodiscard]] size_t getStateHash(const AnimationContext& context, const AnimGraphNodeRuntime& runtime,
+                                      float timeQuantum) const override;
+
+private:
+    std::vector<AnimState> mStates;
+
+    std::vector<AnimStateTransition> mTransitions;
+
+    PinID mOutputPin{};
+
+    // moves the running transition and starts the next one, running transitions are never interrupted
+    void updateState(const AnimationContext& context, StateMachineRuntime& state) const;
+
+    // slot of the parameter comes from slotCache, so conditions don't search the plan every frame
+    [[nodiscard]] static bool isConditionMet(const AnimStateTransition& transition, const AnimInstance& instance,
+                                             AnimParamSlotCache& slotCache);
+};
+} // namespace Core::Animations
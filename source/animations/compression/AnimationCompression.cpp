@@ -0,0 +1,454 @@
+#include "AnimationCompression.h"
+
+#include "animations/AnimationsUtils.h"
+#include "resources/Mesh.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr float quantizedVec3Max = 65535.f;
+constexpr float quantizedQuatComponentMax = 32767.f;
+// remaining components of a normalized quaternion never exceed 1/sqrt(2) when the largest one is dropped
+constexpr float quatComponentRange = 1.41421356f;
+
+// longest segment tested during key reduction, bounds reduction cost of very long tracks
+constexpr size_t maxReducedSegmentLength = 256;
+
+// returns indices of keys that have to stay, withinTolerance(a, b, k) checks key k against segment [a, b]
+template <typename WithinTolerance>
+std::vector<size_t> reduceKeys(const size_t keyCount, WithinTolerance withinTolerance)
+{
+    std::vector<size_t> keptKeys{0};
+
+    size_t anchor = 0;
+
+    for (size_t candidate = 2; candidate < keyCount; ++candidate)
+    {
+        bool fits = candidate - anchor <= maxReducedSegmentLength;
+
+        for (size_t key = anchor + 1; key < candidate && fits; ++key)
+        {
+            fits = withinTolerance(anchor, candidate, key);
+        }
+
+        if (!fits)
+        {
+            anchor = candidate - 1;
+            keptKeys.push_back(anchor);
+        }
+    }
+
+    keptKeys.push_back(keyCount - 1);
+
+    return keptKeys;
+}
+
+float segmentAlpha(const float startTime, const float endTime, const float time)
+{
+    const float span = endTime - startTime;
+    return span > 0.f ? (time - startTime) / span : 0.f;
+}
+
+float angleBetween(const glm::quat& a, const glm::quat& b)
+{
+    const float dot = glm::clamp(std::abs(glm::dot(a, b)), 0.f, 1.f);
+    return 2.f * std::acos(dot);
+}
+
+Core::Animations::QuantizedVec3 quantizeVec3(const glm::vec3& value, const glm::vec3& rangeMin,
+                                             const glm::vec3& rangeExtent)
+{
+    auto quantizeComponent = [](const float component, const float min, const float extent)
+    {
+        if (extent <= 0.f)
+        {
+            return uint16_t{0};
+        }
+
+        const float normalized = glm::clamp((component - min) / extent, 0.f, 1.f);
+        return static_cast<uint16_t>(std::lround(normalized * quantizedVec3Max));
+    };
+
+    return {quantizeComponent(value.x, rangeMin.x, rangeExtent.x),
+            quantizeComponent(value.y, rangeMin.y, rangeExtent.y),
+            quantizeComponent(value.z, rangeMin.z, rangeExtent.z)};
+}
+
+glm::vec3 dequantizeVec3(const Core::Animations::QuantizedVec3& quantized, const glm::vec3& rangeMin,
+                         const glm::vec3& rangeExtent)
+{
+    return rangeMin + rangeExtent * (glm::vec3(quantized.x, quantized.y, quantized.z) / quantizedVec3Max);
+}
+
+Core::Animations::CompressedVec3Track compressVec3Track(std::span<const Core::Animations::KeyframeVec3> keys,
+                                                        const glm::vec3& defaultValue, const float tolerance,
+                                                        const float duration,
+                                                        Core::Animations::CompressedAnimationClip& outClip)
+{
+    auto quantizeTime = [duration](const float time)
+    {
+        const float normalized = glm::clamp(time / duration, 0.f, 1.f);
+        return static_cast<uint16_t>(
+            std::lround(normalized * Core::Animations::AnimationCompression::maxQuantizedTime));
+    };
+
+    Core::Animations::CompressedVec3Track track;
+    track.firstKey = static_cast<uint32_t>(outClip.vec3Keys.size());
+
+    const bool isConstant =
+        std::ranges::all_of(keys, [&keys, tolerance](const Core::Animations::KeyframeVec3& key)
+                            { return glm::distance(key.value, keys.front().value) <= tolerance; });
+
+    if (isConstant)
+    {
+        track.keyCount = 1;
+        track.rangeMin = keys.empty() ? defaultValue : keys.front().value;
+
+        outClip.vec3KeyTimes.push_back(0);
+        outClip.vec3Keys.push_back({});
+
+        return track;
+    }
+
+    glm::vec3 rangeMax = keys.front().value;
+    track.rangeMin = keys.front().value;
+    for (const auto& key : keys)
+    {
+        track.rangeMin = glm::min(track.rangeMin, key.value);
+        rangeMax = glm::max(rangeMax, key.value);
+    }
+    track.rangeExtent = rangeMax - track.rangeMin;
+
+    std::vector<Core::Animations::QuantizedVec3> quantizedKeys;
+    std::vector<glm::vec3> decodedKeys;
+    quantizedKeys.reserve(keys.size());
+    decodedKeys.reserve(keys.size());
+
+    for (const auto& key : keys)
+    {
+        quantizedKeys.push_back(quantizeVec3(key.value, track.rangeMin, track.rangeExtent));
+        decodedKeys.push_back(dequantizeVec3(quantizedKeys.back(), track.rangeMin, track.rangeExtent));
+    }
+
+    // reduction compares against decoded keys, so quantization error is part of the tolerance
+    const std::vector<size_t> keptKeys = reduceKeys(
+        keys.size(),
+        [&](const size_t start, const size_t end, const size_t key)
+        {
+            const float alpha = segmentAlpha(keys[start].time, keys[end].time, keys[key].time);
+            const glm::vec3 reconstructed = glm::mix(decodedKeys[start], decodedKeys[end], alpha);
+            return glm::distance(reconstructed, keys[key].value) <= tolerance;
+        });
+
+    for (const size_t key : keptKeys)
+    {
+        outClip.vec3KeyTimes.push_back(quantizeTime(keys[key].time));
+        outClip.vec3Keys.push_back(quantizedKeys[key]);
+    }
+
+    track.keyCount = static_cast<uint32_t>(keptKeys.size());
+
+    return track;
+}
+
+Core::Animations::CompressedQuatTrack compressQuatTrack(std::span<const Core::Animations::KeyframeQuat> keys,
+                                                        const float tolerance, const float duration,
+                                                        Core::Animations::CompressedAnimationClip& outClip)
+{
+    using Core::Animations::AnimationCompression;
+
+    auto quantizeTime = [duration](const float time)
+    {
+        const float normalized = glm::clamp(time / duration, 0.f, 1.f);
+        return static_cast<uint16_t>(std::lround(normalized * AnimationCompression::maxQuantizedTime));
+    };
+
+    Core::Animations::CompressedQuatTrack track;
+    track.firstKey = static_cast<uint32_t>(outClip.quatKeys.size());
+
+    const bool isConstant =
+        std::ranges::all_of(keys, [&keys, tolerance](const Core::Animations::KeyframeQuat& key)
+                            { return angleBetween(key.value, keys.front().value) <= tolerance; });
+
+    if (isConstant)
+    {
+        track.keyCount = 1;
+
+        outClip.quatKeyTimes.push_back(0);
+        outClip.quatKeys.push_back(
+            AnimationCompression::quantizeQuat(keys.empty() ? glm::quat(1.f, 0.f, 0.f, 0.f) : keys.front().value));
+
+        return track;
+    }
+
+    std::vector<Core::Animations::QuantizedQuat> quantizedKeys;
+    std::vector<glm::quat> decodedKeys;
+    quantizedKeys.reserve(keys.size());
+    decodedKeys.reserve(keys.size());
+
+    for (const auto& key : keys)
+    {
+        quantizedKeys.push_back(AnimationCompression::quantizeQuat(key.value));
+        decodedKeys.push_back(AnimationCompression::dequantizeQuat(quantizedKeys.back()));
+    }
+
+    const std::vector<size_t> keptKeys = reduceKeys(
+        keys.size(),
+        [&](const size_t start, const size_t end, const size_t key)
+        {
+            const float alpha = segmentAlpha(keys[start].time, keys[end].time, keys[key].time);
+            const glm::quat reconstructed = glm::slerp(decodedKeys[start], decodedKeys[end], alpha);
+            return angleBetween(reconstructed, keys[key].value) <= tolerance;
+        });
+
+    for (const size_t key : keptKeys)
+    {
+        outClip.quatKeyTimes.push_back(quantizeTime(keys[key].time));
+        outClip.quatKeys.push_back(quantizedKeys[key]);
+    }
+
+    track.keyCount = static_cast<uint32_t>(keptKeys.size());
+
+    return track;
+}
+} // namespace
+
+size_t Core::Animations::CompressedAnimationClip::getMemoryUsage() const
+{
+    return channels.size() * sizeof(CompressedAnimationChannel) + vec3KeyTimes.size() * sizeof(uint16_t) +
+           vec3Keys.size() * sizeof(QuantizedVec3) + quatKeyTimes.size() * sizeof(uint16_t) +
+           quatKeys.size() * sizeof(QuantizedQuat);
+}
+
+std::shared_ptr<const Core::Animations::CompressedAnimationClip>
+Core::Animations::AnimationCompression::compress(const AnimationClip& clip,
+                                                 const Resources::SkeletonData* skeletonData,
+                                                 const AnimationCompressionSettings& settings)
+{
+    auto compressed = std::make_shared<CompressedAnimationClip>();
+    compressed->channels.reserve(clip.channels.size());
+
+    const std::vector<float> boneReach = skeletonData ? computeBoneReach(*skeletonData) : std::vector<float>{};
+
+    const float duration = clip.duration > 0.f ? clip.duration : 1.f;
+
+    for (const auto& channel : clip.channels)
+    {
+        // rotation error grows with distance to the end of the bone chain, so long chains get tighter tolerance
+        float reach = 0.f;
+        if (skeletonData)
+        {
+            if (const auto it = skeletonData->boneNameToIndexMap.find(channel.boneName);
+                it != skeletonData->boneNameToIndexMap.end())
+            {
+                reach = boneReach[it->second];
+            }
+        }
+
+        const float rotationTolerance =
+            reach > 0.f ? std::min(settings.maxAngularError, settings.maxPositionError / reach)
+                        : settings.maxAngularError;
+
+        CompressedAnimationChannel compressedChannel;
+        compressedChannel.position =
+            compressVec3Track(channel.positions, glm::vec3(0.f), settings.maxPositionError, duration, *compressed);
+        compressedChannel.rotation = compressQuatTrack(channel.rotations, rotationTolerance, duration, *compressed);
+        compressedChannel.scale =
+            compressVec3Track(channel.scalings, glm::vec3(1.f), settings.maxScaleError, duration, *compressed);
+
+        compressed->channels.push_back(compressedChannel);
+    }
+
+    return compressed;
+}
+
+void Core::Animations::AnimationCompression::compressInPlace(AnimationClip& clip,
+                                                            const Resources::SkeletonData* skeletonData,
+                                                            const AnimationCompressionSettings& settings)
+{
+    clip.compressed = compress(clip, skeletonData, settings);
+
+    for (auto& channel : clip.channels)
+    {
+        channel.positions = {};
+        channel.rotations = {};
+        channel.scalings = {};
+    }
+
+    // releases imported keys, or unmaps the clip cache once no other clip uses it
+    clip.keyStorage.reset();
+}
+
+size_t Core::Animations::AnimationCompression::getUncompressedMemoryUsage(const AnimationClip& clip)
+{
+    size_t usage = 0;
+
+    for (const auto& channel : clip.channels)
+    {
+        usage += channel.positions.size() * sizeof(KeyframeVec3) + channel.rotations.size() * sizeof(KeyframeQuat) +
+                 channel.scalings.size() * sizeof(KeyframeVec3);
+    }
+
+    return usage;
+}
+
+Core::Animations::BoneTransform
+Core::Animations::AnimationCompression::sampleChannel(const CompressedAnimationClip& clip, const size_t channelIndex,
+                                                      const float normalizedTime, AnimationChannelCursor& cursor)
+{
+    const CompressedAnimationChannel& channel = clip.channels[channelIndex];
+
+    return BoneTransform{sampleVec3Track(clip, channel.position, normalizedTime, cursor.position),
+                         sampleQuatTrack(clip, channel.rotation, normalizedTime, cursor.rotation),
+                         sampleVec3Track(clip, channel.scale, normalizedTime, cursor.scale)};
+}
+
+Core::Animations::QuantizedQuat Core::Animations::AnimationCompression::quantizeQuat(const glm::quat& rotation)
+{
+    const glm::quat normalized = glm::normalize(rotation);
+
+    int largest = 0;
+    for (int i = 1; i < 4; ++i)
+    {
+        if (std::abs(normalized[i]) > std::abs(normalized[largest]))
+        {
+            largest = i;
+        }
+    }
+
+    // q and -q are the same rotation, so the dropped component is always reconstructed as positive
+    const float sign = normalized[largest] < 0.f ? -1.f : 1.f;
+
+    uint64_t packed = static_cast<uint64_t>(largest) << 45;
+    int shift = 30;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+        {
+            continue;
+        }
+
+        const float component = glm::clamp(normalized[i] * sign * quatComponentRange * 0.5f + 0.5f, 0.f, 1.f);
+        packed |= static_cast<uint64_t>(std::lround(component * quantizedQuatComponentMax)) << shift;
+        shift -= 15;
+    }
+
+    QuantizedQuat quantized;
+    quantized.data[0] = static_cast<uint16_t>(packed >> 32);
+    quantized.data[1] = static_cast<uint16_t>(packed >> 16);
+    quantized.data[2] = static_cast<uint16_t>(packed);
+
+    return quantized;
+}
+
+glm::quat Core::Animations::AnimationCompression::dequantizeQuat(const QuantizedQuat& quantized)
+{
+    const uint64_t packed = static_cast<uint64_t>(quantized.data[0]) << 32 |
+                            static_cast<uint64_t>(quantized.data[1]) << 16 | static_cast<uint64_t>(quantized.data[2]);
+
+    const int largest = static_cast<int>(packed >> 45 & 0x3);
+
+    glm::quat rotation(1.f, 0.f, 0.f, 0.f);
+    float sumOfSquares = 0.f;
+    int shift = 30;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+        {
+            continue;
+        }
+
+        const auto value = static_cast<float>(packed >> shift & 0x7FFF);
+        const float component = (value / quantizedQuatComponentMax * 2.f - 1.f) / quatComponentRange;
+
+        rotation[i] = component;
+        sumOfSquares += component * component;
+        shift -= 15;
+    }
+
+    rotation[largest] = std::sqrt(std::max(0.f, 1.f - sumOfSquares));
+
+    return rotation;
+}
+
+glm::vec3 Core::Animations::AnimationCompression::sampleVec3Track(const CompressedAnimationClip& clip,
+                                                                  const CompressedVec3Track& track,
+                                                                  const float normalizedTime, uint32_t& cursor)
+{
+    const QuantizedVec3* keys = clip.vec3Keys.data() + track.firstKey;
+
+    if (track.keyCount == 1)
+    {
+        return dequantizeVec3(keys[0], track.rangeMin, track.rangeExtent);
+    }
+
+    const uint16_t* times = clip.vec3KeyTimes.data() + track.firstKey;
+
+    const size_t i =
+        AnimationsUtils::findKeyIndex(track.keyCount, normalizedTime, cursor,
+                                      [times](const size_t index) { return static_cast<float>(times[index]); });
+    if (i == track.keyCount - 1)
+    {
+        return dequantizeVec3(keys[i], track.rangeMin, track.rangeExtent);
+    }
+
+    const float alpha = segmentAlpha(times[i], times[i + 1], normalizedTime);
+
+    return glm::mix(dequantizeVec3(keys[i], track.rangeMin, track.rangeExtent),
+                    dequantizeVec3(keys[i + 1], track.rangeMin, track.rangeExtent), alpha);
+}
+
+glm::quat Core::Animations::AnimationCompression::sampleQuatTrack(const CompressedAnimationClip& clip,
+                                                                  const CompressedQuatTrack& track,
+                                                                  const float normalizedTime, uint32_t& cursor)
+{
+    const QuantizedQuat* keys = clip.quatKeys.data() + track.firstKey;
+
+    if (track.keyCount == 1)
+    {
+        return dequantizeQuat(keys[0]);
+    }
+
+    const uint16_t* times = clip.quatKeyTimes.data() + track.firstKey;
+
+    const size_t i =
+        AnimationsUtils::findKeyIndex(track.keyCount, normalizedTime, cursor,
+                                      [times](const size_t index) { return static_cast<float>(times[index]); });
+    if (i == track.keyCount - 1)
+    {
+        return dequantizeQuat(keys[i]);
+    }
+
+    const float alpha = segmentAlpha(times[i], times[i + 1], normalizedTime);
+
+    return glm::slerp(dequantizeQuat(keys[i]), dequantizeQuat(keys[i + 1]), alpha);
+}
+
+std::vector<float> Core::Animations::AnimationCompression::computeBoneReach(const Resources::SkeletonData& skeletonData)
+{
+    const FlatSkeleton& flatSkeleton = skeletonData.flatSkeleton;
+
+    std::vector<float> reach(skeletonData.boneNameToIndexMap.size(), 0.f);
+
+    // children are stored after parents, so walking backwards finishes every subtree before its root
+    for (size_t slot = flatSkeleton.size(); slot-- > 0;)
+    {
+        const int parentIndex = flatSkeleton.parentBoneIndices[slot];
+        if (parentIndex < 0)
+        {
+            continue;
+        }
+
+        const int boneIndex = flatSkeleton.boneIndices[slot];
+        const float boneLength =
+            glm::length(glm::vec3((flatSkeleton.parentOffsets[slot] * flatSkeleton.bindLocalTransforms[slot])[3]));
+
+        reach[parentIndex] = std::max(reach[parentIndex], boneLength + reach[boneIndex]);
+    }
+
+    return reach;
+}
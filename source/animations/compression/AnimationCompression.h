@@ -0,0 +1,114 @@
+#pragma once
+
+#include "animations/AnimationsData.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Core::Resources
+{
+struct SkeletonData;
+}
+
+namespace Core::Animations
+{
+struct AnimationCompressionSettings
+{
+    bool enabled = false;
+
+    // maximum error at the end of the longest bone chain driven by a track, in skeleton units
+    float maxPositionError = 0.001f;
+
+    // maximum rotation error of a single bone, in radians
+    float maxAngularError = 0.001f;
+
+    float maxScaleError = 0.0001f;
+};
+
+// every component range quantized to 16 bits inside track bounds
+struct QuantizedVec3
+{
+    uint16_t x = 0;
+    uint16_t y = 0;
+    uint16_t z = 0;
+};
+
+// smallest three encoding packed into 48 bits:
+// 2 bits index of the dropped largest component, then 3 x 15 bits for remaining components
+struct QuantizedQuat
+{
+    uint16_t data[3] = {};
+};
+
+// keyCount == 1 means constant track
+struct CompressedVec3Track
+{
+    uint32_t firstKey = 0;
+    uint32_t keyCount = 0;
+    glm::vec3 rangeMin{0.f};
+    glm::vec3 rangeExtent{0.f};
+};
+
+struct CompressedQuatTrack
+{
+    uint32_t firstKey = 0;
+    uint32_t keyCount = 0;
+};
+
+struct CompressedAnimationChannel
+{
+    CompressedVec3Track position;
+    CompressedQuatTrack rotation;
+    CompressedVec3Track scale;
+};
+
+// channels are parallel to AnimationClip::channels, key times are quantized to 16 bits over clip duration
+struct CompressedAnimationClip
+{
+    std::vector<CompressedAnimationChannel> channels;
+
+    std::vector<uint16_t> vec3KeyTimes;
+    std::vector<QuantizedVec3> vec3Keys;
+
+    std::vector<uint16_t> quatKeyTimes;
+    std::vector<QuantizedQuat> quatKeys;
+
+    [[nodiscard]] size_t getMemoryUsage() const;
+};
+
+class AnimationCompression
+{
+public:
+    static constexpr float maxQuantizedTime = 65535.f;
+
+    // builds compressed representation of clip keys, skeleton is used to measure rotation errors at bone chain ends
+    [[nodiscard]] static std::shared_ptr<const CompressedAnimationClip>
+    compress(const AnimationClip& clip, const Resources::SkeletonData* skeletonData,
+             const AnimationCompressionSettings& settings);
+
+    // replaces clip keys with compressed representation, channel names are kept for skeleton binding
+    static void compressInPlace(AnimationClip& clip, const Resources::SkeletonData* skeletonData,
+                                const AnimationCompressionSettings& settings);
+
+    [[nodiscard]] static size_t getUncompressedMemoryUsage(const AnimationClip& clip);
+
+    // normalizedTime is clip time remapped to [0, maxQuantizedTime]
+    [[nodiscard]] static BoneTransform sampleChannel(const CompressedAnimationClip& clip, size_t channelIndex,
+                                                     float normalizedTime, AnimationChannelCursor& cursor);
+
+    [[nodiscard]] static QuantizedQuat quantizeQuat(const glm::quat& rotation);
+
+    [[nodiscard]] static glm::quat dequantizeQuat(const QuantizedQuat& quantized);
+
+private:
+    [[nodiscard]] static glm::vec3 sampleVec3Track(const CompressedAnimationClip& clip,
+                                                   const CompressedVec3Track& track, float normalizedTime,
+                                                   uint32_t& cursor);
+
+    [[nodiscard]] static glm::quat sampleQuatTrack(const CompressedAnimationClip& clip,
+                                                   const CompressedQuatTrack& track, float normalizedTime,
+                                                   uint32_t& cursor);
+
+    [[nodiscard]] static std::vector<float> computeBoneReach(const Resources::SkeletonData& skeletonData);
+};
+} // namespace Core::Animations
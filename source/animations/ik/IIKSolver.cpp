@@ -0,0 +1,18 @@
+#include "IIKSolver.h"
+
+void Core::Animations::IIKSolver::solve(Scene::Scene* scene, const Resources::SkeletonData& skeletonData, Pose& pose,
+                                        AnimationScratch& scratch)
+{
+    if (!mTarget || !scene)
+    {
+        return;
+    }
+
+    const Component::IKTargetComponent* target = mTarget.resolve(scene);
+    if (!target)
+    {
+        return;
+    }
+
+    solveForTarget(skeletonData, target->getTargetWorldPosition(), pose, scratch);
+}
@@ -20,6 +20,7 @@ namespace Core::Animations
 {
 struct BonesInfo;
 struct BoneNode;
+struct AnimationScratch;
 class IIKSolver
 {
 public:
@@ -35,7 +36,13 @@ public:
 
     [[nodiscard]] virtual AnimationSolverType getType() const = 0;
 
-    virtual void solve(const Resources::SkeletonData& skeletonData, Pose& pose) = 0;
+    // resolves target component in the scene and solves towards its world position
+    virtual void solve(Scene::Scene* scene, const Resources::SkeletonData& skeletonData, Pose& pose,
+                       AnimationScratch& scratch);
+
+    // scratch holds buffers reused between solves on the same thread
+    virtual void solveForTarget(const Resources::SkeletonData& skeletonData, const glm::vec3& targetPosition,
+                                Pose& pose, AnimationScratch& scratch) = 0;
 
     void setTarget(Component::IKTargetComponent* target) { mTarget.set(target); }
 
@@ -47,39 +54,9 @@ public:
 
     [[nodiscard]] unsigned int getMaxIterations() const { return mMaxIterations; }
 
-    [[nodiscard]] std::vector<int> getChainIndices() const { return mChainIndices; }
+    [[nodiscard]] const std::vector<int>& getChainIndices() const { return mChainIndices; }
 
 protected:
-    void applyRotationToHierarchy(const Resources::SkeletonData& skeletonData, const BoneNode& node,
-                                  const int targetBoneIndex, const glm::mat4& rotation, BonesInfo& bonesInfo,
-                                  bool found)
-    {
-        if (!found)
-        {
-            if (const auto it = skeletonData.boneNameToIndexMap.find(node.name);
-                it != skeletonData.boneNameToIndexMap.end() && it->second == targetBoneIndex)
-            {
-                found = true;
-            }
-        }
-
-        if (found)
-        {
-            if (const auto it = skeletonData.boneNameToIndexMap.find(node.name);
-                it != skeletonData.boneNameToIndexMap.end())
-            {
-                const int index = it->second;
-                bonesInfo.bones[index].animatedGlobalTransform =
-                    rotation * bonesInfo.bones[index].animatedGlobalTransform;
-            }
-        }
-
-        for (const auto& child : node.children)
-        {
-            applyRotationToHierarchy(skeletonData, child, targetBoneIndex, rotation, bonesInfo, found);
-        }
-    }
-
     std::vector<int> mChainIndices;
     ComponentReference<Component::IKTargetComponent> mTarget;
     unsigned int mMaxIterations = 15;
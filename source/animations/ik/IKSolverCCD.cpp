@@ -1,50 +1,46 @@
 #include "IKSolverCCD.h"
 #include "animations/AnimationsData.h"
 #include "animations/AnimationsUtils.h"
-#include "engine/Engine.h"
+#include "animations/anim-graph/AnimationContext.h"
 #include "resources/Mesh.h"
 
-void Core::Animations::IKSolverCCD::solve(const Resources::SkeletonData& skeletonData, Pose& pose)
-{
-    if (!mTarget)
-    {
-        return;
-    }
+#include <glm/gtc/quaternion.hpp>
 
+void Core::Animations::IKSolverCCD::solveForTarget(const Resources::SkeletonData& skeletonData,
+                                                   const glm::vec3& targetPosition, Pose& pose,
+                                                   AnimationScratch& scratch)
+{
     if (mChainIndices.size() < 2)
     {
         return;
     }
 
-    const int effectorIndex = mChainIndices.front();
+    const size_t chainLength = mChainIndices.size();
+    const int chainRootParent = skeletonData.boneParents[mChainIndices.back()];
 
-    // TODO
-    // create SceneContext to not access scene via Engine
-    auto* scene = Engine::getInstance().getSystem<Scene::Scene>();
-    const glm::vec3 targetPosition = mTarget.resolve(scene)->getTargetWorldPosition();
+    // solver only rotates chain bones, so everything above the chain is built once
+    const glm::mat4 rootParentTransform =
+        AnimationsUtils::buildParentGlobalTransform(pose, skeletonData, mChainIndices.back());
 
-    PoseGlobalData globals;
-    globals.globalTransforms.resize(skeletonData.boneNameToIndexMap.size());
+    std::vector<glm::mat4>& globals = scratch.chainGlobals;
+    AnimationsUtils::updateChainGlobalTransforms(pose, skeletonData, mChainIndices, rootParentTransform,
+                                                 chainLength - 1, globals);
 
     for (uint32_t iteration = 0; iteration < mMaxIterations; ++iteration)
     {
-        AnimationsUtils::buildPoseGlobalTransforms(pose, skeletonData.rootNode, skeletonData, globals);
-
-        auto effectorPosition = glm::vec3(globals.globalTransforms[effectorIndex][3]);
-
-        if (glm::distance(effectorPosition, targetPosition) < mThreshold)
+        if (glm::distance(glm::vec3(globals[0][3]), targetPosition) < mThreshold)
         {
             break;
         }
 
         // TODO
         // implement constraints
-        for (size_t i = 1; i < mChainIndices.size(); ++i)
+        for (size_t i = 1; i < chainLength; ++i)
         {
             const int jointIndex = mChainIndices[i];
 
-            auto jointPosition = glm::vec3(globals.globalTransforms[jointIndex][3]);
-            effectorPosition = glm::vec3(globals.globalTransforms[effectorIndex][3]);
+            auto jointPosition = glm::vec3(globals[i][3]);
+            auto effectorPosition = glm::vec3(globals[0][3]);
 
             glm::vec3 toEffector = glm::normalize(effectorPosition - jointPosition);
 
@@ -63,21 +59,24 @@ void Core::Animations::IKSolverCCD::solve(const Resources::SkeletonData& skeleto
 
             glm::quat worldDelta = glm::angleAxis(angle, axis);
 
-            int parentIndex = skeletonData.boneParents[jointIndex];
-
             glm::quat parentWorldRot(1, 0, 0, 0);
 
-            if (parentIndex >= 0)
+            if (i + 1 < chainLength)
             {
-                glm::mat4 parentGlobal = globals.globalTransforms[parentIndex];
-
-                parentWorldRot = glm::quat_cast(parentGlobal);
+                parentWorldRot = glm::quat_cast(globals[i + 1]);
+            }
+            else if (chainRootParent >= 0)
+            {
+                parentWorldRot = glm::quat_cast(rootParentTransform);
             }
 
             glm::quat localDelta = glm::inverse(parentWorldRot) * worldDelta * parentWorldRot;
 
-            pose.localTransforms[jointIndex].rotation =
-                glm::normalize(localDelta * pose.localTransforms[jointIndex].rotation);
+            pose.rotations[jointIndex] = glm::normalize(localDelta * pose.rotations[jointIndex]);
+
+            // only the joint and bones below it moved
+            AnimationsUtils::updateChainGlobalTransforms(pose, skeletonData, mChainIndices, rootParentTransform, i,
+                                                         globals);
         }
     }
 }
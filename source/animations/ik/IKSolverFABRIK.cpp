@@ -1,38 +1,39 @@
 #include "IKSolverFABRIK.h"
 #include "animations/AnimationsData.h"
 #include "animations/AnimationsUtils.h"
-#include "engine/Engine.h"
+#include "animations/anim-graph/AnimationContext.h"
 
-void Core::Animations::IKSolverFABRIK::solve(const Resources::SkeletonData& skeletonData, Pose& pose)
-{
-    if (!mTarget)
-    {
-        return;
-    }
+#include <glm/gtc/quaternion.hpp>
 
+void Core::Animations::IKSolverFABRIK::solveForTarget(const Resources::SkeletonData& skeletonData,
+                                                      const glm::vec3& target, Pose& pose, AnimationScratch& scratch)
+{
     if (mChainIndices.size() < 2)
     {
         return;
     }
 
-    auto* scene = Engine::getInstance().getSystem<Scene::Scene>();
-    const glm::vec3 target = mTarget.resolve(scene)->getTargetWorldPosition();
+    const size_t chainLength = mChainIndices.size();
+    const int chainRootParent = skeletonData.boneParents[mChainIndices.back()];
 
-    PoseGlobalData globals;
-    globals.globalTransforms.resize(skeletonData.boneNameToIndexMap.size());
+    // solver only rotates chain bones, so everything above the chain is built once
+    const glm::mat4 rootParentTransform =
+        AnimationsUtils::buildParentGlobalTransform(pose, skeletonData, mChainIndices.back());
 
-    AnimationsUtils::buildPoseGlobalTransforms(pose, skeletonData.rootNode, skeletonData, globals);
+    std::vector<glm::mat4>& globals = scratch.chainGlobals;
+    AnimationsUtils::updateChainGlobalTransforms(pose, skeletonData, mChainIndices, rootParentTransform,
+                                                 chainLength - 1, globals);
 
-    std::vector<glm::vec3> positions;
-    positions.reserve(mChainIndices.size());
+    std::vector<glm::vec3>& positions = scratch.chainPositions;
+    positions.clear();
 
-    for (const int index : mChainIndices)
+    for (const glm::mat4& global : globals)
     {
-        positions.push_back(glm::vec3(globals.globalTransforms[index][3]));
+        positions.push_back(glm::vec3(global[3]));
     }
 
-    std::vector<float> lengths;
-    lengths.reserve(positions.size() - 1);
+    std::vector<float>& lengths = scratch.chainLengths;
+    lengths.clear();
 
     float totalLength = 0.0f;
 
@@ -81,15 +82,12 @@ void Core::Animations::IKSolverFABRIK::solve(const Resources::SkeletonData& skel
         }
     }
 
-    AnimationsUtils::buildPoseGlobalTransforms(pose, skeletonData.rootNode, skeletonData, globals);
-
-    for (size_t i = 1; i < mChainIndices.size(); ++i)
+    // joints are rotated from the chain root down, so every joint sees its ancestors already rotated
+    for (size_t i = chainLength - 1; i > 0; --i)
     {
         int joint = mChainIndices[i];
-        int child = mChainIndices[i - 1];
 
-        glm::vec3 currentDir = glm::normalize(glm::vec3(globals.globalTransforms[child][3]) -
-                                              glm::vec3(globals.globalTransforms[joint][3]));
+        glm::vec3 currentDir = glm::normalize(glm::vec3(globals[i - 1][3]) - glm::vec3(globals[i][3]));
 
         glm::vec3 targetDir = glm::normalize(positions[i - 1] - positions[i]);
 
@@ -106,17 +104,22 @@ void Core::Animations::IKSolverFABRIK::solve(const Resources::SkeletonData& skel
 
         glm::quat worldDelta = glm::angleAxis(angle, axis);
 
-        int parent = skeletonData.boneParents[joint];
-
         glm::quat parentRot(1, 0, 0, 0);
 
-        if (parent >= 0)
+        if (i + 1 < chainLength)
         {
-            parentRot = glm::quat_cast(globals.globalTransforms[parent]);
+            parentRot = glm::quat_cast(globals[i + 1]);
+        }
+        else if (chainRootParent >= 0)
+        {
+            parentRot = glm::quat_cast(rootParentTransform);
         }
 
         glm::quat localDelta = glm::inverse(parentRot) * worldDelta * parentRot;
 
-        pose.localTransforms[joint].rotation = glm::normalize(localDelta * pose.localTransforms[joint].rotation);
+        pose.rotations[joint] = glm::normalize(localDelta * pose.rotations[joint]);
+
+        AnimationsUtils::updateChainGlobalTransforms(pose, skeletonData, mChainIndices, rootParentTransform, i,
+                                                     globals);
     }
 }
@@ -17,6 +17,7 @@ public:
 
     [[nodiscard]] AnimationSolverType getType() const override { return AnimationSolverType::FABRIK; }
 
-    void solve(const Resources::SkeletonData& skeletonData, Pose& pose) override;
+    void solveForTarget(const Resources::SkeletonData& skeletonData, const glm::vec3& targetPosition, Pose& pose,
+                        AnimationScratch& scratch) override;
 };
 } // namespace Core::Animations
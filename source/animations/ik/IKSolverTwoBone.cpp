@@ -0,0 +1,63 @@
+#include "IKSolverTwoBone.h"
+#include "animations/AnimationsData.h"
+#include "animations/anim-graph/AnimationContext.h"
+
+void Core::Animations::IKSolverTwoBone::solve(Scene::Scene* scene, const Resources::SkeletonData& skeletonData,
+                                              Pose& pose, AnimationScratch& scratch)
+{
+    TwoBoneIKRequest request;
+    if (!buildRequest(scene, skeletonData, request))
+    {
+        return;
+    }
+
+    request.pose = &pose;
+
+    // single chain goes through the same kernel as batches, so both paths give the same pose
+    TwoBoneIKBatch::solve({&request, 1}, scratch.twoBoneIK);
+}
+
+void Core::Animations::IKSolverTwoBone::solveForTarget(const Resources::SkeletonData& skeletonData,
+                                                       const glm::vec3& targetPosition, Pose& pose,
+                                                       AnimationScratch& scratch)
+{
+    if (mChainIndices.size() < 3)
+    {
+        return;
+    }
+
+    TwoBoneIKRequest request;
+    request.pose = &pose;
+    request.skeletonData = &skeletonData;
+    request.limb = getLimb();
+    request.target = targetPosition;
+
+    TwoBoneIKBatch::solve({&request, 1}, scratch.twoBoneIK);
+}
+
+bool Core::Animations::IKSolverTwoBone::buildRequest(Scene::Scene* scene, const Resources::SkeletonData& skeletonData,
+                                                     TwoBoneIKRequest& outRequest) const
+{
+    if (mChainIndices.size() < 3 || !mTarget || !scene)
+    {
+        return false;
+    }
+
+    const Component::IKTargetComponent* target = mTarget.resolve(scene);
+    if (!target)
+    {
+        return false;
+    }
+
+    outRequest.skeletonData = &skeletonData;
+    outRequest.limb = getLimb();
+    outRequest.target = target->getTargetWorldPosition();
+
+    if (const Component::IKTargetComponent* pole = mPole ? mPole.resolve(scene) : nullptr)
+    {
+        outRequest.pole = pole->getTargetWorldPosition();
+        outRequest.hasPole = true;
+    }
+
+    return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "IIKSolver.h"
+#include "TwoBoneIKBatch.h"
+
+namespace Core::Animations
+{
+// closed form solver for limbs, chain is the effector followed by its parent and grandparent
+// longer chains only bend their last two bones, iterations and threshold are unused
+class IKSolverTwoBone : public IIKSolver
+{
+public:
+    explicit IKSolverTwoBone(const std::vector<int>& chainIndices) : IIKSolver(chainIndices, 1) {}
+
+    [[nodiscard]] AnimationSolverType getType() const override { return AnimationSolverType::TwoBone; }
+
+    // resolves pole component as well, so the middle joint bends towards it
+    void solve(Scene::Scene* scene, const Resources::SkeletonData& skeletonData, Pose& pose,
+               AnimationScratch& scratch) override;
+
+    // keeps the current bend plane of the limb
+    void solveForTarget(const Resources::SkeletonData& skeletonData, const glm::vec3& targetPosition, Pose& pose,
+                        AnimationScratch& scratch) override;
+
+    // resolves target and pole in the scene, false if there is nothing to solve towards
+    // pose of the request is left for the caller to set
+    [[nodiscard]] bool buildRequest(Scene::Scene* scene, const Resources::SkeletonData& skeletonData,
+                                    TwoBoneIKRequest& outRequest) const;
+
+    // chain has to hold at least 3 bones
+    [[nodiscard]] std::array<int, 3> getLimb() const { return {mChainIndices[0], mChainIndices[1], mChainIndices[2]}; }
+
+    void setPole(Component::IKTargetComponent* pole) { mPole.set(pole); }
+
+    void setPoleUUID(const uuids::uuid& uuid) { mPole = ComponentReference<Component::IKTargetComponent>(uuid); }
+
+    [[nodiscard]] const uuids::uuid& getPoleUUID() const { return mPole.uuid(); }
+
+private:
+    ComponentReference<Component::IKTargetComponent> mPole;
+};
+} // namespace Core::Animations
@@ -0,0 +1,104 @@
+#include "TwoBoneIKBatch.h"
+#include "animations/AnimationsUtils.h"
+#include "resources/Mesh.h"
+
+#include <algorithm>
+
+#include <glm/gtc/quaternion.hpp>
+
+namespace
+{
+// rotation part of a global transform, scale inherited from parents is dropped
+glm::quat getWorldRotation(const glm::mat4& transform)
+{
+    return glm::quat_cast(glm::mat3(glm::normalize(glm::vec3(transform[0])), glm::normalize(glm::vec3(transform[1])),
+                                    glm::normalize(glm::vec3(transform[2]))));
+}
+
+// non-bone nodes between bone and its parent bone, local rotation of the bone is applied below them
+glm::mat4 getParentOffset(const Core::Resources::SkeletonData& skeletonData, const int boneIndex)
+{
+    const int slot = skeletonData.flatSkeleton.boneSlots[boneIndex];
+    return slot >= 0 ? skeletonData.flatSkeleton.parentOffsets[slot] : glm::mat4(1.f);
+}
+
+// true if bone is one of limb bones or lies below any of them
+bool isBelowLimb(const Core::Resources::SkeletonData& skeletonData, int boneIndex, const std::array<int, 3>& limb)
+{
+    for (; boneIndex >= 0; boneIndex = skeletonData.boneParents[boneIndex])
+    {
+        if (std::ranges::find(limb, boneIndex) != limb.end())
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+} // namespace
+
+void Core::Animations::TwoBoneIKBatch::solve(const std::span<const TwoBoneIKRequest> requests,
+                                             TwoBoneIKBatchScratch& scratch)
+{
+    const size_t chainCount = requests.size();
+
+    scratch.streams.resize(chainCount);
+    scratch.midParentRotations.resize(chainCount);
+    scratch.rootParentRotations.resize(chainCount);
+
+    // gather walks every hierarchy on its own, solve then runs over coordinate streams of all chains
+    for (size_t chain = 0; chain < chainCount; ++chain)
+    {
+        const TwoBoneIKRequest& request = requests[chain];
+        const int midIndex = request.limb[1];
+        const int rootIndex = request.limb[2];
+
+        const glm::mat4 rootParentTransform =
+            AnimationsUtils::buildParentGlobalTransform(*request.pose, *request.skeletonData, rootIndex);
+        AnimationsUtils::updateChainGlobalTransforms(*request.pose, *request.skeletonData, request.limb,
+                                                     rootParentTransform, 2, scratch.limbGlobals);
+
+        scratch.streams.setVec3(TwoBoneIKStreams::EffectorX, chain, glm::vec3(scratch.limbGlobals[0][3]));
+        scratch.streams.setVec3(TwoBoneIKStreams::MidX, chain, glm::vec3(scratch.limbGlobals[1][3]));
+        scratch.streams.setVec3(TwoBoneIKStreams::RootX, chain, glm::vec3(scratch.limbGlobals[2][3]));
+        scratch.streams.setVec3(TwoBoneIKStreams::TargetX, chain, request.target);
+        scratch.streams.setVec3(TwoBoneIKStreams::PoleX, chain, request.pole);
+        scratch.streams.streams[TwoBoneIKStreams::PoleWeight][chain] = request.hasPole ? 1.f : 0.f;
+
+        scratch.midParentRotations[chain] =
+            getWorldRotation(scratch.limbGlobals[2] * getParentOffset(*request.skeletonData, midIndex));
+        scratch.rootParentRotations[chain] =
+            getWorldRotation(rootParentTransform * getParentOffset(*request.skeletonData, rootIndex));
+    }
+
+    PoseKernels::solveTwoBoneIK(scratch.streams);
+
+    for (size_t chain = 0; chain < chainCount; ++chain)
+    {
+        const TwoBoneIKRequest& request = requests[chain];
+        std::vector<glm::quat>& rotations = request.pose->rotations;
+
+        const glm::quat midDelta = scratch.streams.getQuat(TwoBoneIKStreams::MidDeltaX, chain);
+        const glm::quat rootDelta = scratch.streams.getQuat(TwoBoneIKStreams::RootDeltaX, chain);
+
+        // middle joint is rotated in its parent frame before the root moves, root rotation then carries it along
+        const glm::quat& midParentRotation = scratch.midParentRotations[chain];
+        const glm::quat& rootParentRotation = scratch.rootParentRotations[chain];
+
+        const int midIndex = request.limb[1];
+        const int rootIndex = request.limb[2];
+
+        rotations[midIndex] =
+            glm::normalize(glm::inverse(midParentRotation) * midDelta * midParentRotation * rotations[midIndex]);
+        rotations[rootIndex] =
+            glm::normalize(glm::inverse(rootParentRotation) * rootDelta * rootParentRotation * rotations[rootIndex]);
+    }
+}
+
+bool Core::Animations::TwoBoneIKBatch::areLimbsIndependent(const Resources::SkeletonData& skeletonData,
+                                                           const std::array<int, 3>& limbA,
+                                                           const std::array<int, 3>& limbB)
+{
+    // roots are the highest limb bones, so checking them covers every bone of the other limb
+    return !isBelowLimb(skeletonData, limbA[2], limbB) && !isBelowLimb(skeletonData, limbB[2], limbA);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "animations/AnimationsData.h"
+#include "animations/simd/PoseKernels.h"
+
+#include <array>
+#include <span>
+#include <vector>
+
+namespace Core::Resources
+{
+struct SkeletonData;
+}
+
+namespace Core::Animations
+{
+// two bone chain of one pose, solved together with chains of other poses
+struct TwoBoneIKRequest
+{
+    Pose* pose = nullptr;
+    const Resources::SkeletonData* skeletonData = nullptr;
+
+    // effector, middle joint and root, same order as solver chains
+    std::array<int, 3> limb{-1, -1, -1};
+
+    glm::vec3 target{0.f};
+    glm::vec3 pole{0.f};
+    bool hasPole = false;
+};
+
+// buffers reused between batches solved on the same thread
+struct TwoBoneIKBatchScratch
+{
+    TwoBoneIKStreams streams;
+
+    // world rotations of the parent frames of mid and root, including non-bone nodes above them, parallel to requests
+    std::vector<glm::quat> midParentRotations;
+    std::vector<glm::quat> rootParentRotations;
+
+    std::vector<glm::mat4> limbGlobals;
+};
+
+class TwoBoneIKBatch
+{
+public:
+    // gathers model space limbs into streams, solves all of them at once and writes rotations back into poses
+    // requests may share a pose as long as none of their limbs lies above another one
+    static void solve(std::span<const TwoBoneIKRequest> requests, TwoBoneIKBatchScratch& scratch);
+
+    // true when solving limbs in any order gives the same pose
+    [[nodiscard]] static bool areLimbsIndependent(const Resources::SkeletonData& skeletonData,
+                                                  const std::array<int, 3>& limbA, const std::array<int, 3>& limbB);
+};
+} // namespace Core::Animations
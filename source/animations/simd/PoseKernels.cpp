@@ -0,0 +1,1063 @@
+#include "PoseKernels.h"
+
+#include "core/Assertion.h"
+#include "vk-renderer/VkRenderData.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SE_POSE_KERNELS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// msvc accepts avx intrinsics in any function, dispatch guarantees they only run on supported cpus
+#define SE_TARGET_AVX2
+#else
+#define SE_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+#endif
+
+#ifdef GLM_FORCE_QUAT_DATA_WXYZ
+#error "pose kernels expect quaternion components stored as x, y, z, w"
+#endif
+
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "pose kernels expect tightly packed vec3 streams");
+static_assert(sizeof(glm::quat) == 4 * sizeof(float), "pose kernels expect tightly packed quat streams");
+static_assert(sizeof(glm::mat4) == 16 * sizeof(float), "pose kernels expect column major float matrices");
+static_assert(sizeof(glm::mat3x4) == 12 * sizeof(float), "skinning kernels expect three packed matrix rows");
+
+namespace
+{
+using Core::Animations::PoseKernels;
+
+// lerp over a flat float stream
+using LerpFunction = void (*)(const float* a, const float* b, float weight, float* out, size_t floatCount);
+// lerp over a vec3 stream with weight per vector, every weight is multiplied by weightScale
+using LerpWeightedFunction = void (*)(const float* a, const float* b, const float* weights, float weightScale,
+                                      float* out, size_t vectorCount);
+// nlerp over a quat stream, weights == nullptr means uniform weight, otherwise weights are scaled by weight
+using NlerpFunction = void (*)(const float* a, const float* b, const float* weights, float weight, float* out,
+                               size_t quatCount);
+using ComposeFunction = void (*)(const float* positions, const float* rotations, const float* scales, float* out,
+                                 size_t boneCount);
+// transforms hold three rows of every affine skinning matrix, out is a vec3 stream
+using SkinFunction = void (*)(const Core::Renderer::Vertex* vertices, size_t vertexCount, const float* transforms,
+                              float* out);
+// streams are indexed by TwoBoneIKStreams::Stream
+using TwoBoneIKFunction = void (*)(float* const* streams, size_t firstChain, size_t chainCount);
+
+struct PoseKernelTable
+{
+    PoseKernels::InstructionSet instructionSet;
+    LerpFunction lerp;
+    LerpWeightedFunction lerpWeighted;
+    NlerpFunction nlerp;
+    ComposeFunction compose;
+    SkinFunction skin;
+    TwoBoneIKFunction twoBoneIK;
+};
+
+void lerpScalar(const float* a, const float* b, const float weight, float* out, const size_t floatCount)
+{
+    for (size_t i = 0; i < floatCount; ++i)
+    {
+        out[i] = a[i] + (b[i] - a[i]) * weight;
+    }
+}
+
+void lerpWeightedScalar(const float* a, const float* b, const float* weights, const float weightScale, float* out,
+                        const size_t vectorCount)
+{
+    for (size_t i = 0; i < vectorCount * 3; ++i)
+    {
+        out[i] = a[i] + (b[i] - a[i]) * (weights[i / 3] * weightScale);
+    }
+}
+
+void nlerpScalar(const float* a, const float* b, const float* weights, const float weight, float* out,
+                 const size_t quatCount)
+{
+    for (size_t i = 0; i < quatCount; ++i)
+    {
+        const float* quatA = a + i * 4;
+        const float* quatB = b + i * 4;
+
+        const float t = weights ? weights[i] * weight : weight;
+
+        const float dot = quatA[0] * quatB[0] + quatA[1] * quatB[1] + quatA[2] * quatB[2] + quatA[3] * quatB[3];
+        const float weightA = 1.f - t;
+        const float weightB = dot < 0.f ? -t : t;
+
+        float result[4];
+        float lengthSquared = 0.f;
+        for (int c = 0; c < 4; ++c)
+        {
+            result[c] = quatA[c] * weightA + quatB[c] * weightB;
+            lengthSquared += result[c] * result[c];
+        }
+
+        const float inverseLength = 1.f / std::sqrt(lengthSquared);
+        for (int c = 0; c < 4; ++c)
+        {
+            out[i * 4 + c] = result[c] * inverseLength;
+        }
+    }
+}
+
+void composeScalar(const float* positions, const float* rotations, const float* scales, float* out,
+                   const size_t boneCount)
+{
+    for (size_t i = 0; i < boneCount; ++i)
+    {
+        const float* p = positions + i * 3;
+        const float* q = rotations + i * 4;
+        const float* s = scales + i * 3;
+        float* m = out + i * 16;
+
+        const float x2 = q[0] + q[0];
+        const float y2 = q[1] + q[1];
+        const float z2 = q[2] + q[2];
+
+        const float xx = q[0] * x2;
+        const float yy = q[1] * y2;
+        const float zz = q[2] * z2;
+        const float xy = q[0] * y2;
+        const float xz = q[0] * z2;
+        const float yz = q[1] * z2;
+        const float wx = q[3] * x2;
+        const float wy = q[3] * y2;
+        const float wz = q[3] * z2;
+
+        m[0] = (1.f - (yy + zz)) * s[0];
+        m[1] = (xy + wz) * s[0];
+        m[2] = (xz - wy) * s[0];
+        m[3] = 0.f;
+
+        m[4] = (xy - wz) * s[1];
+        m[5] = (1.f - (xx + zz)) * s[1];
+        m[6] = (yz + wx) * s[1];
+        m[7] = 0.f;
+
+        m[8] = (xz + wy) * s[2];
+        m[9] = (yz - wx) * s[2];
+        m[10] = (1.f - (xx + yy)) * s[2];
+        m[11] = 0.f;
+
+        m[12] = p[0];
+        m[13] = p[1];
+        m[14] = p[2];
+        m[15] = 1.f;
+    }
+}
+
+// matches primitive.vert, zero weights add nothing so they are skipped
+void skinScalar(const Core::Renderer::Vertex* vertices, const size_t vertexCount, const float* transforms, float* out)
+{
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        const Core::Renderer::Vertex& vertex = vertices[i];
+
+        float rows[12] = {};
+        for (int influence = 0; influence < 4; ++influence)
+        {
+            const float weight = vertex.weights[influence];
+            if (weight == 0.f)
+            {
+                continue;
+            }
+
+            const float* bone = transforms + static_cast<size_t>(vertex.boneID[influence]) * 12;
+            for (int c = 0; c < 12; ++c)
+            {
+                rows[c] += bone[c] * weight;
+            }
+        }
+
+        const glm::vec3& p = vertex.position;
+        for (int row = 0; row < 3; ++row)
+        {
+            const float* r = rows + row * 4;
+            out[i * 3 + row] = r[0] * p.x + r[1] * p.y + r[2] * p.z + r[3];
+        }
+    }
+}
+
+// lane operations the two bone ik kernel is written against, one chain per lane
+struct ScalarLanes
+{
+    using Value = float;
+    using Mask = bool;
+
+    static constexpr size_t width = 1;
+
+    static Value load(const float* source) { return *source; }
+    static void store(float* destination, const Value value) { *destination = value; }
+    static Value set(const float value) { return value; }
+
+    static Value add(const Value a, const Value b) { return a + b; }
+    static Value sub(const Value a, const Value b) { return a - b; }
+    static Value mul(const Value a, const Value b) { return a * b; }
+    static Value div(const Value a, const Value b) { return a / b; }
+    static Value min(const Value a, const Value b) { return std::min(a, b); }
+    static Value max(const Value a, const Value b) { return std::max(a, b); }
+    static Value sqrt(const Value a) { return std::sqrt(a); }
+    static Value abs(const Value a) { return std::abs(a); }
+    static Value copySign(const Value magnitude, const Value sign) { return std::copysign(magnitude, sign); }
+
+    static Mask less(const Value a, const Value b) { return a < b; }
+    static Mask either(const Mask a, const Mask b) { return a || b; }
+    static Mask both(const Mask a, const Mask b) { return a && b; }
+    static Value select(const Mask mask, const Value a, const Value b) { return mask ? a : b; }
+};
+
+template <typename L> struct LaneVec3
+{
+    typename L::Value x, y, z;
+};
+
+template <typename L> struct LaneQuat
+{
+    typename L::Value x, y, z, w;
+};
+
+template <typename L> LaneVec3<L> loadVec3(float* const* streams, const size_t stream, const size_t chain)
+{
+    return {L::load(streams[stream] + chain), L::load(streams[stream + 1] + chain),
+            L::load(streams[stream + 2] + chain)};
+}
+
+template <typename L> void storeQuat(float* const* streams, const size_t stream, const size_t chain,
+                                     const LaneQuat<L>& q)
+{
+    L::store(streams[stream] + chain, q.x);
+    L::store(streams[stream + 1] + chain, q.y);
+    L::store(streams[stream + 2] + chain, q.z);
+    L::store(streams[stream + 3] + chain, q.w);
+}
+
+template <typename L> LaneVec3<L> sub(const LaneVec3<L>& a, const LaneVec3<L>& b)
+{
+    return {L::sub(a.x, b.x), L::sub(a.y, b.y), L::sub(a.z, b.z)};
+}
+
+template <typename L> LaneVec3<L> add(const LaneVec3<L>& a, const LaneVec3<L>& b)
+{
+    return {L::add(a.x, b.x), L::add(a.y, b.y), L::add(a.z, b.z)};
+}
+
+template <typename L> LaneVec3<L> scale(const LaneVec3<L>& a, const typename L::Value s)
+{
+    return {L::mul(a.x, s), L::mul(a.y, s), L::mul(a.z, s)};
+}
+
+template <typename L> typename L::Value dot(const LaneVec3<L>& a, const LaneVec3<L>& b)
+{
+    return L::add(L::add(L::mul(a.x, b.x), L::mul(a.y, b.y)), L::mul(a.z, b.z));
+}
+
+template <typename L> LaneVec3<L> cross(const LaneVec3<L>& a, const LaneVec3<L>& b)
+{
+    return {L::sub(L::mul(a.y, b.z), L::mul(a.z, b.y)), L::sub(L::mul(a.z, b.x), L::mul(a.x, b.z)),
+            L::sub(L::mul(a.x, b.y), L::mul(a.y, b.x))};
+}
+
+template <typename L> typename L::Value length(const LaneVec3<L>& a)
+{
+    return L::sqrt(dot(a, a));
+}
+
+template <typename L> LaneVec3<L> select(const typename L::Mask mask, const LaneVec3<L>& a, const LaneVec3<L>& b)
+{
+    return {L::select(mask, a.x, b.x), L::select(mask, a.y, b.y), L::select(mask, a.z, b.z)};
+}
+
+template <typename L> LaneQuat<L> select(const typename L::Mask mask, const LaneQuat<L>& a, const LaneQuat<L>& b)
+{
+    return {L::select(mask, a.x, b.x), L::select(mask, a.y, b.y), L::select(mask, a.z, b.z),
+            L::select(mask, a.w, b.w)};
+}
+
+template <typename L> LaneQuat<L> identityQuat()
+{
+    return {L::set(0.f), L::set(0.f), L::set(0.f), L::set(1.f)};
+}
+
+template <typename L> LaneQuat<L> multiply(const LaneQuat<L>& a, const LaneQuat<L>& b)
+{
+    const LaneVec3<L> va{a.x, a.y, a.z};
+    const LaneVec3<L> vb{b.x, b.y, b.z};
+    const LaneVec3<L> v = add(add(scale(vb, a.w), scale(va, b.w)), cross(va, vb));
+
+    return {v.x, v.y, v.z, L::sub(L::mul(a.w, b.w), dot(va, vb))};
+}
+
+template <typename L> LaneVec3<L> rotate(const LaneQuat<L>& q, const LaneVec3<L>& v)
+{
+    const LaneVec3<L> axis{q.x, q.y, q.z};
+    const LaneVec3<L> t = scale(cross(axis, v), L::set(2.f));
+
+    return add(add(v, scale(t, q.w)), cross(axis, t));
+}
+
+// shortest arc turning from onto to, falls back to half turn around fallbackAxis for opposite vectors
+template <typename L> LaneQuat<L> rotationBetween(const LaneVec3<L>& from, const LaneVec3<L>& to,
+                                                  const LaneVec3<L>& fallbackAxis)
+{
+    const LaneVec3<L> axis = cross(from, to);
+    const typename L::Value w = L::add(L::mul(length(from), length(to)), dot(from, to));
+
+    const typename L::Value lengthSquared = L::add(dot(axis, axis), L::mul(w, w));
+    const typename L::Mask isOpposite = L::less(lengthSquared, L::set(1e-12f));
+
+    const typename L::Value inverseLength = L::div(L::set(1.f), L::sqrt(L::max(lengthSquared, L::set(1e-12f))));
+    const LaneQuat<L> arc{L::mul(axis.x, inverseLength), L::mul(axis.y, inverseLength),
+                          L::mul(axis.z, inverseLength), L::mul(w, inverseLength)};
+
+    return select(isOpposite, LaneQuat<L>{fallbackAxis.x, fallbackAxis.y, fallbackAxis.z, L::set(0.f)}, arc);
+}
+
+// closed form two bone ik, trigonometry is replaced by cosine and sine pairs so lanes need only sqrt and div
+template <typename L> void solveTwoBoneIKLanes(float* const* streams, const size_t chain)
+{
+    using Value = typename L::Value;
+    using Streams = Core::Animations::TwoBoneIKStreams;
+
+    const Value epsilon = L::set(1e-5f);
+    const Value zero = L::set(0.f);
+    const Value one = L::set(1.f);
+    const Value half = L::set(0.5f);
+
+    const LaneVec3<L> root = loadVec3<L>(streams, Streams::RootX, chain);
+    const LaneVec3<L> mid = loadVec3<L>(streams, Streams::MidX, chain);
+    const LaneVec3<L> effector = loadVec3<L>(streams, Streams::EffectorX, chain);
+    const LaneVec3<L> target = loadVec3<L>(streams, Streams::TargetX, chain);
+    const LaneVec3<L> pole = loadVec3<L>(streams, Streams::PoleX, chain);
+    const typename L::Mask hasPole = L::less(zero, L::load(streams[Streams::PoleWeight] + chain));
+
+    const LaneVec3<L> midToRoot = sub(root, mid);
+    const LaneVec3<L> midToEffector = sub(effector, mid);
+    const LaneVec3<L> rootToTarget = sub(target, root);
+    const LaneVec3<L> rootToPole = sub(pole, root);
+
+    const Value upperLength = length(midToRoot);
+    const Value lowerLength = length(midToEffector);
+    const Value lengthProduct = L::mul(upperLength, lowerLength);
+    const typename L::Mask isDegenerate = L::either(L::less(upperLength, epsilon), L::less(lowerLength, epsilon));
+
+    // unreachable targets straighten the limb towards them, too close ones fold it as far as it goes
+    const Value targetDistance = L::min(L::max(length(rootToTarget),
+                                               L::add(L::abs(L::sub(upperLength, lowerLength)), epsilon)),
+                                        L::sub(L::add(upperLength, lowerLength), epsilon));
+
+    const Value safeProduct = L::max(lengthProduct, L::set(1e-12f));
+    const Value twiceProduct = L::mul(L::set(2.f), safeProduct);
+
+    // law of cosines gives the middle joint angle for the wanted root to effector distance
+    const Value wantedCos = L::min(L::max(L::div(L::sub(L::add(L::mul(upperLength, upperLength),
+                                                                 L::mul(lowerLength, lowerLength)),
+                                                           L::mul(targetDistance, targetDistance)),
+                                                    twiceProduct),
+                                              L::set(-1.f)),
+                                       one);
+    const Value currentCos = L::min(L::max(L::div(dot(midToRoot, midToEffector), safeProduct), L::set(-1.f)), one);
+    const Value wantedSin = L::sqrt(L::max(L::sub(one, L::mul(wantedCos, wantedCos)), zero));
+    const Value currentSin = L::sqrt(L::max(L::sub(one, L::mul(currentCos, currentCos)), zero));
+
+    // cosine and sine of wanted minus current angle
+    const Value deltaCos = L::add(L::mul(wantedCos, currentCos), L::mul(wantedSin, currentSin));
+    const Value deltaSin = L::sub(L::mul(wantedSin, currentCos), L::mul(wantedCos, currentSin));
+
+    // bend in the current plane of the limb, straight limbs fall back to the pole or any perpendicular plane
+    const LaneVec3<L> rootToEffector = sub(effector, root);
+    const LaneVec3<L> limbAxis = cross(midToRoot, midToEffector);
+    const LaneVec3<L> poleAxis = cross(rootToEffector, rootToPole);
+
+    const LaneVec3<L> limbDirection = scale(rootToEffector, L::div(one, L::max(length(rootToEffector), epsilon)));
+    const typename L::Mask isLimbVertical = L::less(L::set(0.99f), L::abs(limbDirection.y));
+    const LaneVec3<L> perpendicularAxis =
+        cross(limbDirection, LaneVec3<L>{L::select(isLimbVertical, one, zero), L::select(isLimbVertical, zero, one),
+                                         zero});
+
+    LaneVec3<L> bendAxis = select(L::both(hasPole, L::less(length(limbAxis), epsilon)), poleAxis, limbAxis);
+    bendAxis = select(L::less(length(bendAxis), epsilon), perpendicularAxis, bendAxis);
+    bendAxis = scale(bendAxis, L::div(one, L::max(length(bendAxis), L::set(1e-12f))));
+
+    const Value halfCos = L::sqrt(L::max(L::mul(L::add(one, deltaCos), half), zero));
+    const Value halfSin = L::copySign(L::sqrt(L::max(L::mul(L::sub(one, deltaCos), half), zero)), deltaSin);
+    const LaneQuat<L> midDelta{L::mul(bendAxis.x, halfSin), L::mul(bendAxis.y, halfSin), L::mul(bendAxis.z, halfSin),
+                               halfCos};
+
+    // swing the bent limb so its effector lies on the line to the target
+    const LaneVec3<L> bentEffector = add(mid, rotate(midDelta, midToEffector));
+    LaneQuat<L> rootDelta = rotationBetween(sub(bentEffector, root), rootToTarget, bendAxis);
+
+    // twist around that line until the middle joint faces the pole
+    const Value targetLength = length(rootToTarget);
+    const LaneVec3<L> twistAxis = scale(rootToTarget, L::div(one, L::max(targetLength, epsilon)));
+    const LaneVec3<L> midOffset = rotate(rootDelta, sub(mid, root));
+    const LaneVec3<L> midOnPlane = sub(midOffset, scale(twistAxis, dot(midOffset, twistAxis)));
+    const LaneVec3<L> poleOnPlane = sub(rootToPole, scale(twistAxis, dot(rootToPole, twistAxis)));
+
+    const typename L::Mask canTwist =
+        L::both(L::both(hasPole, L::less(epsilon, targetLength)),
+                L::both(L::less(epsilon, length(midOnPlane)), L::less(epsilon, length(poleOnPlane))));
+    const LaneQuat<L> twist = rotationBetween(midOnPlane, poleOnPlane, twistAxis);
+    rootDelta = select(canTwist, multiply(twist, rootDelta), rootDelta);
+
+    storeQuat<L>(streams, Streams::MidDeltaX, chain, select(isDegenerate, identityQuat<L>(), midDelta));
+    storeQuat<L>(streams, Streams::RootDeltaX, chain, select(isDegenerate, identityQuat<L>(), rootDelta));
+}
+
+void solveTwoBoneIKScalar(float* const* streams, const size_t firstChain, const size_t chainCount)
+{
+    for (size_t chain = firstChain; chain < firstChain + chainCount; ++chain)
+    {
+        solveTwoBoneIKLanes<ScalarLanes>(streams, chain);
+    }
+}
+
+constexpr PoseKernelTable scalarKernels{PoseKernels::InstructionSet::Scalar, lerpScalar, lerpWeightedScalar,
+                                        nlerpScalar, composeScalar, skinScalar, solveTwoBoneIKScalar};
+
+#ifdef SE_POSE_KERNELS_X86
+// sse2 is part of x86-64 baseline, so these need no target attributes
+
+void lerpSSE2(const float* a, const float* b, const float weight, float* out, const size_t floatCount)
+{
+    const __m128 t = _mm_set1_ps(weight);
+
+    size_t i = 0;
+    for (; i + 4 <= floatCount; i += 4)
+    {
+        const __m128 va = _mm_loadu_ps(a + i);
+        const __m128 vb = _mm_loadu_ps(b + i);
+        _mm_storeu_ps(out + i, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(vb, va), t)));
+    }
+
+    lerpScalar(a + i, b + i, weight, out + i, floatCount - i);
+}
+
+void lerpWeightedSSE2(const float* a, const float* b, const float* weights, const float weightScale, float* out,
+                      const size_t vectorCount)
+{
+    const __m128 scale = _mm_set1_ps(weightScale);
+
+    size_t i = 0;
+    for (; i + 4 <= vectorCount; i += 4)
+    {
+        // 4 vectors take 12 floats, weights are spread as w0w0w0w1 w1w1w2w2 w2w3w3w3
+        const __m128 w = _mm_mul_ps(_mm_loadu_ps(weights + i), scale);
+        const __m128 spreadWeights[3] = {_mm_shuffle_ps(w, w, _MM_SHUFFLE(1, 0, 0, 0)),
+                                         _mm_shuffle_ps(w, w, _MM_SHUFFLE(2, 2, 1, 1)),
+                                         _mm_shuffle_ps(w, w, _MM_SHUFFLE(3, 3, 3, 2))};
+
+        for (size_t part = 0; part < 3; ++part)
+        {
+            const size_t offset = i * 3 + part * 4;
+            const __m128 va = _mm_loadu_ps(a + offset);
+            const __m128 vb = _mm_loadu_ps(b + offset);
+            _mm_storeu_ps(out + offset, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(vb, va), spreadWeights[part])));
+        }
+    }
+
+    lerpWeightedScalar(a + i * 3, b + i * 3, weights + i, weightScale, out + i * 3, vectorCount - i);
+}
+
+// 4 quaternions are transposed into x, y, z, w registers, so every operation handles 4 bones
+__m128 nlerpTransposedSSE2(__m128 (&ra)[4], const __m128 (&rb)[4], const __m128 t)
+{
+    const __m128 signMask = _mm_set1_ps(-0.f);
+
+    const __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ra[0], rb[0]), _mm_mul_ps(ra[1], rb[1])),
+                                  _mm_add_ps(_mm_mul_ps(ra[2], rb[2]), _mm_mul_ps(ra[3], rb[3])));
+
+    // hemisphere correction, weight of b takes sign of the dot product
+    const __m128 weightB = _mm_xor_ps(t, _mm_and_ps(dot, signMask));
+    const __m128 weightA = _mm_sub_ps(_mm_set1_ps(1.f), t);
+
+    __m128 lengthSquared = _mm_setzero_ps();
+    for (int c = 0; c < 4; ++c)
+    {
+        ra[c] = _mm_add_ps(_mm_mul_ps(ra[c], weightA), _mm_mul_ps(rb[c], weightB));
+        lengthSquared = _mm_add_ps(lengthSquared, _mm_mul_ps(ra[c], ra[c]));
+    }
+
+    return _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(lengthSquared));
+}
+
+void nlerpSSE2(const float* a, const float* b, const float* weights, const float weight, float* out,
+               const size_t quatCount)
+{
+    size_t i = 0;
+    for (; i + 4 <= quatCount; i += 4)
+    {
+        __m128 ra[4];
+        __m128 rb[4];
+        for (int k = 0; k < 4; ++k)
+        {
+            ra[k] = _mm_loadu_ps(a + (i + k) * 4);
+            rb[k] = _mm_loadu_ps(b + (i + k) * 4);
+        }
+        _MM_TRANSPOSE4_PS(ra[0], ra[1], ra[2], ra[3]);
+        _MM_TRANSPOSE4_PS(rb[0], rb[1], rb[2], rb[3]);
+
+        const __m128 t = weights ? _mm_mul_ps(_mm_loadu_ps(weights + i), _mm_set1_ps(weight)) : _mm_set1_ps(weight);
+        const __m128 inverseLength = nlerpTransposedSSE2(ra, rb, t);
+
+        for (int c = 0; c < 4; ++c)
+        {
+            ra[c] = _mm_mul_ps(ra[c], inverseLength);
+        }
+        _MM_TRANSPOSE4_PS(ra[0], ra[1], ra[2], ra[3]);
+
+        for (int k = 0; k < 4; ++k)
+        {
+            _mm_storeu_ps(out + (i + k) * 4, ra[k]);
+        }
+    }
+
+    nlerpScalar(a + i * 4, b + i * 4, weights ? weights + i : nullptr, weight, out + i * 4, quatCount - i);
+}
+
+// writes 4 matrices from transposed columns, columns[c][r] holds row r of column c for 4 bones
+void storeTransposedMatricesSSE2(__m128 (&columns)[4][4], float* out)
+{
+    for (int c = 0; c < 4; ++c)
+    {
+        _MM_TRANSPOSE4_PS(columns[c][0], columns[c][1], columns[c][2], columns[c][3]);
+
+        for (int k = 0; k < 4; ++k)
+        {
+            _mm_storeu_ps(out + k * 16 + c * 4, columns[c][k]);
+        }
+    }
+}
+
+void composeSSE2(const float* positions, const float* rotations, const float* scales, float* out,
+                 const size_t boneCount)
+{
+    const __m128 one = _mm_set1_ps(1.f);
+    const __m128 zero = _mm_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 4 <= boneCount; i += 4)
+    {
+        __m128 q[4];
+        for (int k = 0; k < 4; ++k)
+        {
+            q[k] = _mm_loadu_ps(rotations + (i + k) * 4);
+        }
+        _MM_TRANSPOSE4_PS(q[0], q[1], q[2], q[3]);
+
+        const float* p = positions + i * 3;
+        const float* s = scales + i * 3;
+
+        const __m128 px = _mm_setr_ps(p[0], p[3], p[6], p[9]);
+        const __m128 py = _mm_setr_ps(p[1], p[4], p[7], p[10]);
+        const __m128 pz = _mm_setr_ps(p[2], p[5], p[8], p[11]);
+        const __m128 sx = _mm_setr_ps(s[0], s[3], s[6], s[9]);
+        const __m128 sy = _mm_setr_ps(s[1], s[4], s[7], s[10]);
+        const __m128 sz = _mm_setr_ps(s[2], s[5], s[8], s[11]);
+
+        const __m128 x2 = _mm_add_ps(q[0], q[0]);
+        const __m128 y2 = _mm_add_ps(q[1], q[1]);
+        const __m128 z2 = _mm_add_ps(q[2], q[2]);
+
+        const __m128 xx = _mm_mul_ps(q[0], x2);
+        const __m128 yy = _mm_mul_ps(q[1], y2);
+        const __m128 zz = _mm_mul_ps(q[2], z2);
+        const __m128 xy = _mm_mul_ps(q[0], y2);
+        const __m128 xz = _mm_mul_ps(q[0], z2);
+        const __m128 yz = _mm_mul_ps(q[1], z2);
+        const __m128 wx = _mm_mul_ps(q[3], x2);
+        const __m128 wy = _mm_mul_ps(q[3], y2);
+        const __m128 wz = _mm_mul_ps(q[3], z2);
+
+        __m128 columns[4][4] = {
+            {_mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx), _mm_mul_ps(_mm_add_ps(xy, wz), sx),
+             _mm_mul_ps(_mm_sub_ps(xz, wy), sx), zero},
+            {_mm_mul_ps(_mm_sub_ps(xy, wz), sy), _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy),
+             _mm_mul_ps(_mm_add_ps(yz, wx), sy), zero},
+            {_mm_mul_ps(_mm_add_ps(xz, wy), sz), _mm_mul_ps(_mm_sub_ps(yz, wx), sz),
+             _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz), zero},
+            {px, py, pz, one}};
+
+        storeTransposedMatricesSSE2(columns, out + i * 16);
+    }
+
+    composeScalar(positions + i * 3, rotations + i * 4, scales + i * 3, out + i * 16, boneCount - i);
+}
+
+// x, y, z and w of the result hold dot products of the three skinned rows with the position, w is unused
+__m128 transformPointSSE2(__m128 row0, __m128 row1, __m128 row2, const glm::vec3& position)
+{
+    const __m128 point = _mm_setr_ps(position.x, position.y, position.z, 1.f);
+
+    row0 = _mm_mul_ps(row0, point);
+    row1 = _mm_mul_ps(row1, point);
+    row2 = _mm_mul_ps(row2, point);
+    __m128 row3 = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+    return _mm_add_ps(_mm_add_ps(row0, row1), _mm_add_ps(row2, row3));
+}
+
+void skinSSE2(const Core::Renderer::Vertex* vertices, const size_t vertexCount, const float* transforms, float* out)
+{
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        const Core::Renderer::Vertex& vertex = vertices[i];
+
+        __m128 rows[3] = {_mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps()};
+        for (int influence = 0; influence < 4; ++influence)
+        {
+            const __m128 weight = _mm_set1_ps(vertex.weights[influence]);
+            const float* bone = transforms + static_cast<size_t>(vertex.boneID[influence]) * 12;
+            for (int row = 0; row < 3; ++row)
+            {
+                rows[row] = _mm_add_ps(rows[row], _mm_mul_ps(_mm_loadu_ps(bone + row * 4), weight));
+            }
+        }
+
+        float result[4];
+        _mm_storeu_ps(result, transformPointSSE2(rows[0], rows[1], rows[2], vertex.position));
+        std::memcpy(out + i * 3, result, 3 * sizeof(float));
+    }
+}
+
+struct SSE2Lanes
+{
+    using Value = __m128;
+    using Mask = __m128;
+
+    static constexpr size_t width = 4;
+
+    static Value load(const float* source) { return _mm_loadu_ps(source); }
+    static void store(float* destination, const Value value) { _mm_storeu_ps(destination, value); }
+    static Value set(const float value) { return _mm_set1_ps(value); }
+
+    static Value add(const Value a, const Value b) { return _mm_add_ps(a, b); }
+    static Value sub(const Value a, const Value b) { return _mm_sub_ps(a, b); }
+    static Value mul(const Value a, const Value b) { return _mm_mul_ps(a, b); }
+    static Value div(const Value a, const Value b) { return _mm_div_ps(a, b); }
+    static Value min(const Value a, const Value b) { return _mm_min_ps(a, b); }
+    static Value max(const Value a, const Value b) { return _mm_max_ps(a, b); }
+    static Value sqrt(const Value a) { return _mm_sqrt_ps(a); }
+    static Value abs(const Value a) { return _mm_andnot_ps(_mm_set1_ps(-0.f), a); }
+
+    static Value copySign(const Value magnitude, const Value sign)
+    {
+        const __m128 signMask = _mm_set1_ps(-0.f);
+        return _mm_or_ps(_mm_andnot_ps(signMask, magnitude), _mm_and_ps(signMask, sign));
+    }
+
+    static Mask less(const Value a, const Value b) { return _mm_cmplt_ps(a, b); }
+    static Mask either(const Mask a, const Mask b) { return _mm_or_ps(a, b); }
+    static Mask both(const Mask a, const Mask b) { return _mm_and_ps(a, b); }
+    static Value select(const Mask mask, const Value a, const Value b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+};
+
+void solveTwoBoneIKSSE2(float* const* streams, const size_t firstChain, const size_t chainCount)
+{
+    size_t i = 0;
+    for (; i + SSE2Lanes::width <= chainCount; i += SSE2Lanes::width)
+    {
+        solveTwoBoneIKLanes<SSE2Lanes>(streams, firstChain + i);
+    }
+
+    solveTwoBoneIKScalar(streams, firstChain + i, chainCount - i);
+}
+
+constexpr PoseKernelTable sse2Kernels{PoseKernels::InstructionSet::SSE2, lerpSSE2, lerpWeightedSSE2, nlerpSSE2,
+                                      composeSSE2, skinSSE2, solveTwoBoneIKSSE2};
+
+SE_TARGET_AVX2 __m256 combineAVX2(const __m128 low, const __m128 high)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+}
+
+SE_TARGET_AVX2 void lerpAVX2(const float* a, const float* b, const float weight, float* out, const size_t floatCount)
+{
+    const __m256 t = _mm256_set1_ps(weight);
+
+    size_t i = 0;
+    for (; i + 8 <= floatCount; i += 8)
+    {
+        const __m256 va = _mm256_loadu_ps(a + i);
+        const __m256 vb = _mm256_loadu_ps(b + i);
+        _mm256_storeu_ps(out + i, _mm256_fmadd_ps(_mm256_sub_ps(vb, va), t, va));
+    }
+
+    lerpScalar(a + i, b + i, weight, out + i, floatCount - i);
+}
+
+SE_TARGET_AVX2 void lerpWeightedAVX2(const float* a, const float* b, const float* weights, const float weightScale,
+                                     float* out, const size_t vectorCount)
+{
+    const __m256 scale = _mm256_set1_ps(weightScale);
+
+    // 8 vectors take 24 floats, 3 registers with weights spread over their components
+    const __m256i spreadIndices[3] = {_mm256_setr_epi32(0, 0, 0, 1, 1, 1, 2, 2),
+                                      _mm256_setr_epi32(2, 3, 3, 3, 4, 4, 4, 5),
+                                      _mm256_setr_epi32(5, 5, 6, 6, 6, 7, 7, 7)};
+
+    size_t i = 0;
+    for (; i + 8 <= vectorCount; i += 8)
+    {
+        const __m256 w = _mm256_mul_ps(_mm256_loadu_ps(weights + i), scale);
+
+        for (size_t part = 0; part < 3; ++part)
+        {
+            const size_t offset = i * 3 + part * 8;
+            const __m256 va = _mm256_loadu_ps(a + offset);
+            const __m256 vb = _mm256_loadu_ps(b + offset);
+            const __m256 t = _mm256_permutevar8x32_ps(w, spreadIndices[part]);
+            _mm256_storeu_ps(out + offset, _mm256_fmadd_ps(_mm256_sub_ps(vb, va), t, va));
+        }
+    }
+
+    lerpWeightedSSE2(a + i * 3, b + i * 3, weights + i, weightScale, out + i * 3, vectorCount - i);
+}
+
+// loads 8 quaternions as x, y, z, w registers
+SE_TARGET_AVX2 void loadTransposedQuatsAVX2(const float* quats, __m256 (&out)[4])
+{
+    __m128 low[4];
+    __m128 high[4];
+    for (int k = 0; k < 4; ++k)
+    {
+        low[k] = _mm_loadu_ps(quats + k * 4);
+        high[k] = _mm_loadu_ps(quats + (k + 4) * 4);
+    }
+    _MM_TRANSPOSE4_PS(low[0], low[1], low[2], low[3]);
+    _MM_TRANSPOSE4_PS(high[0], high[1], high[2], high[3]);
+
+    for (int c = 0; c < 4; ++c)
+    {
+        out[c] = combineAVX2(low[c], high[c]);
+    }
+}
+
+SE_TARGET_AVX2 void storeTransposedQuatsAVX2(const __m256 (&components)[4], float* quats)
+{
+    __m128 low[4];
+    __m128 high[4];
+    for (int c = 0; c < 4; ++c)
+    {
+        low[c] = _mm256_castps256_ps128(components[c]);
+        high[c] = _mm256_extractf128_ps(components[c], 1);
+    }
+    _MM_TRANSPOSE4_PS(low[0], low[1], low[2], low[3]);
+    _MM_TRANSPOSE4_PS(high[0], high[1], high[2], high[3]);
+
+    for (int k = 0; k < 4; ++k)
+    {
+        _mm_storeu_ps(quats + k * 4, low[k]);
+        _mm_storeu_ps(quats + (k + 4) * 4, high[k]);
+    }
+}
+
+SE_TARGET_AVX2 void nlerpAVX2(const float* a, const float* b, const float* weights, const float weight, float* out,
+                              const size_t quatCount)
+{
+    const __m256 signMask = _mm256_set1_ps(-0.f);
+    const __m256 one = _mm256_set1_ps(1.f);
+
+    size_t i = 0;
+    for (; i + 8 <= quatCount; i += 8)
+    {
+        __m256 ra[4];
+        __m256 rb[4];
+        loadTransposedQuatsAVX2(a + i * 4, ra);
+        loadTransposedQuatsAVX2(b + i * 4, rb);
+
+        const __m256 t = weights ? _mm256_mul_ps(_mm256_loadu_ps(weights + i), _mm256_set1_ps(weight))
+                                 : _mm256_set1_ps(weight);
+
+        __m256 dot = _mm256_mul_ps(ra[0], rb[0]);
+        dot = _mm256_fmadd_ps(ra[1], rb[1], dot);
+        dot = _mm256_fmadd_ps(ra[2], rb[2], dot);
+        dot = _mm256_fmadd_ps(ra[3], rb[3], dot);
+
+        const __m256 weightB = _mm256_xor_ps(t, _mm256_and_ps(dot, signMask));
+        const __m256 weightA = _mm256_sub_ps(one, t);
+
+        __m256 lengthSquared = _mm256_setzero_ps();
+        for (int c = 0; c < 4; ++c)
+        {
+            ra[c] = _mm256_fmadd_ps(rb[c], weightB, _mm256_mul_ps(ra[c], weightA));
+            lengthSquared = _mm256_fmadd_ps(ra[c], ra[c], lengthSquared);
+        }
+
+        const __m256 inverseLength = _mm256_div_ps(one, _mm256_sqrt_ps(lengthSquared));
+        for (int c = 0; c < 4; ++c)
+        {
+            ra[c] = _mm256_mul_ps(ra[c], inverseLength);
+        }
+
+        storeTransposedQuatsAVX2(ra, out + i * 4);
+    }
+
+    nlerpSSE2(a + i * 4, b + i * 4, weights ? weights + i : nullptr, weight, out + i * 4, quatCount - i);
+}
+
+SE_TARGET_AVX2 void composeAVX2(const float* positions, const float* rotations, const float* scales, float* out,
+                                const size_t boneCount)
+{
+    const __m256 one = _mm256_set1_ps(1.f);
+    const __m256 zero = _mm256_setzero_ps();
+
+    // vec3 streams are gathered component-wise, 8 bones per register
+    const __m256i vec3Indices = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+
+    size_t i = 0;
+    for (; i + 8 <= boneCount; i += 8)
+    {
+        __m256 q[4];
+        loadTransposedQuatsAVX2(rotations + i * 4, q);
+
+        const float* p = positions + i * 3;
+        const float* s = scales + i * 3;
+
+        const __m256 px = _mm256_i32gather_ps(p, vec3Indices, 4);
+        const __m256 py = _mm256_i32gather_ps(p + 1, vec3Indices, 4);
+        const __m256 pz = _mm256_i32gather_ps(p + 2, vec3Indices, 4);
+        const __m256 sx = _mm256_i32gather_ps(s, vec3Indices, 4);
+        const __m256 sy = _mm256_i32gather_ps(s + 1, vec3Indices, 4);
+        const __m256 sz = _mm256_i32gather_ps(s + 2, vec3Indices, 4);
+
+        const __m256 x2 = _mm256_add_ps(q[0], q[0]);
+        const __m256 y2 = _mm256_add_ps(q[1], q[1]);
+        const __m256 z2 = _mm256_add_ps(q[2], q[2]);
+
+        const __m256 xx = _mm256_mul_ps(q[0], x2);
+        const __m256 yy = _mm256_mul_ps(q[1], y2);
+        const __m256 zz = _mm256_mul_ps(q[2], z2);
+        const __m256 xy = _mm256_mul_ps(q[0], y2);
+        const __m256 xz = _mm256_mul_ps(q[0], z2);
+        const __m256 yz = _mm256_mul_ps(q[1], z2);
+        const __m256 wx = _mm256_mul_ps(q[3], x2);
+        const __m256 wy = _mm256_mul_ps(q[3], y2);
+        const __m256 wz = _mm256_mul_ps(q[3], z2);
+
+        const __m256 columns[4][4] = {
+            {_mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), sx), _mm256_mul_ps(_mm256_add_ps(xy, wz), sx),
+             _mm256_mul_ps(_mm256_sub_ps(xz, wy), sx), zero},
+            {_mm256_mul_ps(_mm256_sub_ps(xy, wz), sy), _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), sy),
+             _mm256_mul_ps(_mm256_add_ps(yz, wx), sy), zero},
+            {_mm256_mul_ps(_mm256_add_ps(xz, wy), sz), _mm256_mul_ps(_mm256_sub_ps(yz, wx), sz),
+             _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), sz), zero},
+            {px, py, pz, one}};
+
+        __m128 lowColumns[4][4];
+        __m128 highColumns[4][4];
+        for (int c = 0; c < 4; ++c)
+        {
+            for (int r = 0; r < 4; ++r)
+            {
+                lowColumns[c][r] = _mm256_castps256_ps128(columns[c][r]);
+                highColumns[c][r] = _mm256_extractf128_ps(columns[c][r], 1);
+            }
+        }
+
+        storeTransposedMatricesSSE2(lowColumns, out + i * 16);
+        storeTransposedMatricesSSE2(highColumns, out + (i + 4) * 16);
+    }
+
+    composeSSE2(positions + i * 3, rotations + i * 4, scales + i * 3, out + i * 16, boneCount - i);
+}
+
+// two vertices per iteration, one in every 128 bit lane
+SE_TARGET_AVX2 void skinAVX2(const Core::Renderer::Vertex* vertices, const size_t vertexCount, const float* transforms,
+                             float* out)
+{
+    size_t i = 0;
+    for (; i + 2 <= vertexCount; i += 2)
+    {
+        const Core::Renderer::Vertex& vertexA = vertices[i];
+        const Core::Renderer::Vertex& vertexB = vertices[i + 1];
+
+        __m256 rows[3] = {_mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps()};
+        for (int influence = 0; influence < 4; ++influence)
+        {
+            const __m256 weight =
+                combineAVX2(_mm_set1_ps(vertexA.weights[influence]), _mm_set1_ps(vertexB.weights[influence]));
+            const float* boneA = transforms + static_cast<size_t>(vertexA.boneID[influence]) * 12;
+            const float* boneB = transforms + static_cast<size_t>(vertexB.boneID[influence]) * 12;
+            for (int row = 0; row < 3; ++row)
+            {
+                const __m256 bone = combineAVX2(_mm_loadu_ps(boneA + row * 4), _mm_loadu_ps(boneB + row * 4));
+                rows[row] = _mm256_fmadd_ps(bone, weight, rows[row]);
+            }
+        }
+
+        const glm::vec3& positionA = vertexA.position;
+        const glm::vec3& positionB = vertexB.position;
+        const __m256 point = combineAVX2(_mm_setr_ps(positionA.x, positionA.y, positionA.z, 1.f),
+                                         _mm_setr_ps(positionB.x, positionB.y, positionB.z, 1.f));
+
+        // horizontal adds leave x, y, z, 0 of the skinned position in every lane
+        const __m256 xy = _mm256_hadd_ps(_mm256_mul_ps(rows[0], point), _mm256_mul_ps(rows[1], point));
+        const __m256 z = _mm256_hadd_ps(_mm256_mul_ps(rows[2], point), _mm256_setzero_ps());
+
+        float result[8];
+        _mm256_storeu_ps(result, _mm256_hadd_ps(xy, z));
+        std::memcpy(out + i * 3, result, 3 * sizeof(float));
+        std::memcpy(out + i * 3 + 3, result + 4, 3 * sizeof(float));
+    }
+
+    skinSSE2(vertices + i, vertexCount - i, transforms, out + i * 3);
+}
+
+// ik lanes are written once against lane operations, which can't take avx2 registers without the target attribute
+// chains are few compared to bones and vertices, so avx2 keeps the sse2 ik kernel
+constexpr PoseKernelTable avx2Kernels{PoseKernels::InstructionSet::AVX2, lerpAVX2, lerpWeightedAVX2, nlerpAVX2,
+                                      composeAVX2, skinAVX2, solveTwoBoneIKSSE2};
+
+bool isAVX2Supported()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+
+    __cpuid(info, 1);
+    const bool hasFMA = (info[2] & (1 << 12)) != 0;
+    const bool hasOSXSAVE = (info[2] & (1 << 27)) != 0;
+    const bool hasAVX = (info[2] & (1 << 28)) != 0;
+
+    // os has to save ymm registers on context switch
+    if (!hasFMA || !hasOSXSAVE || !hasAVX || (_xgetbv(0) & 0x6) != 0x6)
+    {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+#endif
+
+const PoseKernelTable& getKernelTable(const PoseKernels::InstructionSet instructionSet)
+{
+#ifdef SE_POSE_KERNELS_X86
+    static const bool hasAVX2 = isAVX2Supported();
+
+    if (instructionSet == PoseKernels::InstructionSet::AVX2 && hasAVX2)
+    {
+        return avx2Kernels;
+    }
+
+    if (instructionSet != PoseKernels::InstructionSet::Scalar)
+    {
+        return sse2Kernels;
+    }
+#endif
+
+    return scalarKernels;
+}
+
+template <typename T> const float* toFloats(const std::vector<T>& stream)
+{
+    return reinterpret_cast<const float*>(stream.data());
+}
+
+template <typename T> float* toFloats(std::vector<T>& stream)
+{
+    return reinterpret_cast<float*>(stream.data());
+}
+
+const PoseKernelTable* activeKernels = &getKernelTable(PoseKernels::InstructionSet::AVX2);
+} // namespace
+
+void Core::Animations::PoseKernels::blend(const Pose& poseA, const Pose& poseB, const float weight, Pose& outPose)
+{
+    SE_ASSERT(poseA.size() == poseB.size(), "Blended poses have different bone count");
+
+    const size_t boneCount = poseA.size();
+    outPose.resize(boneCount);
+
+    activeKernels->lerp(toFloats(poseA.positions), toFloats(poseB.positions), weight, toFloats(outPose.positions),
+                        boneCount * 3);
+    activeKernels->nlerp(toFloats(poseA.rotations), toFloats(poseB.rotations), nullptr, weight,
+                         toFloats(outPose.rotations), boneCount);
+    activeKernels->lerp(toFloats(poseA.scales), toFloats(poseB.scales), weight, toFloats(outPose.scales),
+                        boneCount * 3);
+}
+
+void Core::Animations::PoseKernels::blendWeighted(const Pose& poseA, const Pose& poseB, const float* boneWeights,
+                                                  const float weightScale, Pose& outPose)
+{
+    SE_ASSERT(poseA.size() == poseB.size(), "Blended poses have different bone count");
+
+    const size_t boneCount = poseA.size();
+    outPose.resize(boneCount);
+
+    activeKernels->lerpWeighted(toFloats(poseA.positions), toFloats(poseB.positions), boneWeights, weightScale,
+                                toFloats(outPose.positions), boneCount);
+    activeKernels->nlerp(toFloats(poseA.rotations), toFloats(poseB.rotations), boneWeights, weightScale,
+                         toFloats(outPose.rotations), boneCount);
+    activeKernels->lerpWeighted(toFloats(poseA.scales), toFloats(poseB.scales), boneWeights, weightScale,
+                                toFloats(outPose.scales), boneCount);
+}
+
+void Core::Animations::PoseKernels::composeMatrices(const Pose& pose, glm::mat4* outMatrices)
+{
+    activeKernels->compose(toFloats(pose.positions), toFloats(pose.rotations), toFloats(pose.scales),
+                           reinterpret_cast<float*>(outMatrices), pose.size());
+}
+
+void Core::Animations::PoseKernels::skinPositions(const std::span<const Renderer::Vertex> vertices,
+                                                  const std::span<const glm::mat3x4> skinningTransforms,
+                                                  glm::vec3* outPositions)
+{
+    if (skinningTransforms.empty())
+    {
+        std::ranges::transform(vertices, outPositions, &Renderer::Vertex::position);
+        return;
+    }
+
+    activeKernels->skin(vertices.data(), vertices.size(), reinterpret_cast<const float*>(skinningTransforms.data()),
+                        reinterpret_cast<float*>(outPositions));
+}
+
+void Core::Animations::PoseKernels::solveTwoBoneIK(TwoBoneIKStreams& streams)
+{
+    activeKernels->twoBoneIK(streams.pointers.data(), 0, streams.size());
+}
+
+Core::Animations::PoseKernels::InstructionSet Core::Animations::PoseKernels::getInstructionSet()
+{
+    return activeKernels->instructionSet;
+}
+
+void Core::Animations::PoseKernels::setInstructionSet(const InstructionSet instructionSet)
+{
+    activeKernels = &getKernelTable(instructionSet);
+}
+
+const char* Core::Animations::PoseKernels::getInstructionSetName(const InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+    case InstructionSet::Scalar:
+        return "Scalar";
+    case InstructionSet::SSE2:
+        return "SSE2";
+    case InstructionSet::AVX2:
+        return "AVX2";
+    }
+
+    return "Unknown";
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "animations/AnimationsData.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Core::Renderer
+{
+struct Vertex;
+}
+
+namespace Core::Animations
+{
+// two bone ik chains stored one coordinate per stream, so the solver handles several chains per instruction
+struct TwoBoneIKStreams
+{
+    enum Stream : uint8_t
+    {
+        // model space positions of the limb and of what it reaches for
+        RootX,
+        RootY,
+        RootZ,
+        MidX,
+        MidY,
+        MidZ,
+        EffectorX,
+        EffectorY,
+        EffectorZ,
+        TargetX,
+        TargetY,
+        TargetZ,
+        PoleX,
+        PoleY,
+        PoleZ,
+        // above 0 for chains bending towards their pole, others keep their current bend plane
+        PoleWeight,
+        // outputs, model space rotations around the middle joint and around the root
+        MidDeltaX,
+        MidDeltaY,
+        MidDeltaZ,
+        MidDeltaW,
+        RootDeltaX,
+        RootDeltaY,
+        RootDeltaZ,
+        RootDeltaW,
+        Count
+    };
+
+    std::array<std::vector<float>, Count> streams;
+    // data pointer of every stream, handed to kernels
+    std::array<float*, Count> pointers{};
+
+    [[nodiscard]] size_t size() const { return streams[0].size(); }
+
+    void resize(const size_t chainCount)
+    {
+        for (size_t stream = 0; stream < Count; ++stream)
+        {
+            streams[stream].resize(chainCount);
+            pointers[stream] = streams[stream].data();
+        }
+    }
+
+    void setVec3(const Stream firstStream, const size_t chain, const glm::vec3& value)
+    {
+        streams[firstStream][chain] = value.x;
+        streams[firstStream + 1][chain] = value.y;
+        streams[firstStream + 2][chain] = value.z;
+    }
+
+    [[nodiscard]] glm::quat getQuat(const Stream firstStream, const size_t chain) const
+    {
+        return glm::quat(streams[firstStream + 3][chain], streams[firstStream][chain],
+                         streams[firstStream + 1][chain], streams[firstStream + 2][chain]);
+    }
+};
+
+// pose and skinning stream kernels, implementation is picked once from cpu features on first use
+class PoseKernels
+{
+public:
+    enum class InstructionSet : uint8_t
+    {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    // positions and scales are lerped, rotations use normalized lerp along the shortest arc
+    static void blend(const Pose& poseA, const Pose& poseB, float weight, Pose& outPose);
+
+    // same as blend, but with a separate weight for every bone, scaled by weightScale inside the kernel
+    static void blendWeighted(const Pose& poseA, const Pose& poseB, const float* boneWeights, float weightScale,
+                              Pose& outPose);
+
+    // local matrix of every bone, matches BoneTransform::toMatrix, outMatrices has to fit pose.size() matrices
+    static void composeMatrices(const Pose& pose, glm::mat4* outMatrices);
+
+    // cpu version of primitive.vert skinning, bone ids of every vertex have to index skinningTransforms
+    // outPositions has to fit vertices.size() positions
+    static void skinPositions(std::span<const Renderer::Vertex> vertices,
+                              std::span<const glm::mat3x4> skinningTransforms, glm::vec3* outPositions);
+
+    // fills mid and root delta streams of every chain from its positions, chains are independent of each other
+    static void solveTwoBoneIK(TwoBoneIKStreams& streams);
+
+    [[nodiscard]] static InstructionSet getInstructionSet();
+
+    // falls back to the best supported set if requested one is not available on this cpu
+    static void setInstructionSet(InstructionSet instructionSet);
+
+    [[nodiscard]] static const char* getInstructionSetName(InstructionSet instructionSet);
+};
+} // namespace Core::Animations
@@ -33,21 +33,52 @@ Core::Resources::MeshData Core::Assets::ModelLoader::loadMeshFromFile(const std:
     std::unordered_map<std::string, int> globalBoneIndexMap;
     buildGlobalBoneIndexMap(scene, globalBoneIndexMap);
 
-    std::vector<int> boneParents;
-    boneParents.resize(globalBoneIndexMap.size(), -1);
-    fillBoneParents(scene->mRootNode, -1, globalBoneIndexMap, boneParents);
-
     processNodeHierarchy(mesh.rootNode, scene->mRootNode, scene, renderData, baseDir, globalBoneIndexMap);
 
-    mesh.skeletonData.rootNode = Animations::AnimationsUtils::buildBoneHierarchy(scene->mRootNode);
-    mesh.skeletonData.boneNameToIndexMap = globalBoneIndexMap;
-    mesh.skeletonData.boneParents = boneParents;
-    mesh.skeletonData.referencePose =
-        Animations::AnimationsUtils::createReferencePose(mesh.skeletonData, mesh.skeletonData.rootNode);
+    buildSkeletonData(scene, globalBoneIndexMap, mesh.skeletonData);
 
     return mesh;
 }
 
+Core::Resources::SkeletonData Core::Assets::ModelLoader::loadSkeletonFromFile(const std::string& fileName)
+{
+    Assimp::Importer importer{};
+    importer.SetPropertyBool(AI_CONFIG_IMPORT_FBX_PRESERVE_PIVOTS, false);
+    importer.ReadFile(fileName, aiProcess_GlobalScale);
+
+    const aiScene* scene = importer.GetScene();
+
+    if (!scene || !scene->mRootNode || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE)
+    {
+        Logger::log(1, "%s error: Failed to load skeleton %s \n", __FUNCTION__, fileName.c_str());
+        return {};
+    }
+
+    std::unordered_map<std::string, int> globalBoneIndexMap;
+    buildGlobalBoneIndexMap(scene, globalBoneIndexMap);
+
+    Resources::SkeletonData skeletonData;
+    buildSkeletonData(scene, globalBoneIndexMap, skeletonData);
+
+    return skeletonData;
+}
+
+void Core::Assets::ModelLoader::buildSkeletonData(const aiScene* scene,
+                                                  const std::unordered_map<std::string, int>& globalBoneIndexMap,
+                                                  Resources::SkeletonData& outSkeletonData)
+{
+    std::vector<int> boneParents;
+    boneParents.resize(globalBoneIndexMap.size(), -1);
+    fillBoneParents(scene->mRootNode, -1, globalBoneIndexMap, boneParents);
+
+    outSkeletonData.rootNode = Animations::AnimationsUtils::buildBoneHierarchy(scene->mRootNode);
+    outSkeletonData.boneNameToIndexMap = globalBoneIndexMap;
+    outSkeletonData.boneParents = boneParents;
+    Animations::AnimationsUtils::buildFlatSkeleton(outSkeletonData.rootNode, globalBoneIndexMap,
+                                                   outSkeletonData.flatSkeleton);
+    outSkeletonData.referencePose = Animations::AnimationsUtils::createReferencePose(outSkeletonData);
+}
+
 void Core::Assets::ModelLoader::collectPrimitivesRecursive(const Resources::MeshNode& node,
                                                            const glm::mat4& parentTransform,
                                                            std::vector<Resources::PrimitiveData>& outAllPrimitives)
@@ -62,6 +93,10 @@ void Core::Assets::ModelLoader::collectPrimitivesRecursive(const Resources::Mesh
             vertex.position = glm::vec3(globalTransform * glm::vec4(vertex.position, 1.0f));
             vertex.normal = glm::normalize(glm::mat3(globalTransform) * vertex.normal);
         }
+
+        // bounds of bind pose vertices have to move with them, or animated bounds end up in node space
+        buildBoneBounds(transformedPrimitive);
+
         outAllPrimitives.push_back(std::move(transformedPrimitive));
     }
 
@@ -389,27 +424,36 @@ void Core::Assets::ModelLoader::processMesh(std::vector<Resources::PrimitiveData
 void Core::Assets::ModelLoader::processBones(Resources::PrimitiveData& primitiveData, const aiMesh* mesh,
                                              const std::unordered_map<std::string, int>& globalBoneIndexMap)
 {
-    primitiveData.bones.bones.resize(globalBoneIndexMap.size());
-    primitiveData.bones.finalTransforms.resize(globalBoneIndexMap.size(), glm::mat4(1.0f));
+    primitiveData.bones.bones.reserve(mesh->mNumBones);
 
     for (unsigned int i = 0; i < mesh->mNumBones; i++)
     {
         processSingleBone(primitiveData, mesh->mBones[i], globalBoneIndexMap);
     }
 
-    primitiveData.bones.finalTransforms.resize(primitiveData.bones.bones.size(), glm::mat4(1.0));
+    buildBoneBounds(primitiveData);
+
+    if (primitiveData.bones.bones.size() > Renderer::maxNumberOfBones)
+    {
+        Logger::log(1, "Primitive is skinned to %zu bones, only first %zu are uploaded\n",
+                    primitiveData.bones.bones.size(), Renderer::maxNumberOfBones);
+    }
+
+    primitiveData.bones.finalTransforms.resize(primitiveData.bones.bones.size(), glm::mat3x4(1.0f));
 }
 
 void Core::Assets::ModelLoader::processSingleBone(Resources::PrimitiveData& primitiveData, const aiBone* bone,
                                                   const std::unordered_map<std::string, int>& globalBoneIndexMap)
 {
     const std::string boneName = bone->mName.C_Str();
-    const int boneID = globalBoneIndexMap.at(boneName);
+
+    // vertices index the primitive palette, which holds only bones of this primitive
+    const int boneID = static_cast<int>(primitiveData.bones.bones.size());
 
     Logger::log(1, "Bone '%s': num vertices affected by this bone: %d\n", boneName.c_str(), bone->mNumWeights);
 
-    primitiveData.bones.bones[boneID] =
-        Animations::Bone{Animations::AnimationsUtils::convertMatrixToGlm(bone->mOffsetMatrix)};
+    primitiveData.bones.bones.emplace_back(Animations::AnimationsUtils::convertMatrixToGlm(bone->mOffsetMatrix),
+                                           globalBoneIndexMap.at(boneName));
 
     for (unsigned int boneWeight = 0; boneWeight < bone->mNumWeights; ++boneWeight)
     {
@@ -431,3 +475,22 @@ void Core::Assets::ModelLoader::setVertexBoneData(Renderer::Vertex& vertex, int
         }
     }
 }
+
+void Core::Assets::ModelLoader::buildBoneBounds(Resources::PrimitiveData& primitiveData)
+{
+    std::vector<Animations::BoundingBox>& boneBounds = primitiveData.bones.boneBounds;
+    boneBounds.assign(primitiveData.bones.bones.size(), {});
+
+    // only influences that made it into the vertex are skinned, so only they extend the bounds
+    for (const Renderer::Vertex& vertex : primitiveData.vertices)
+    {
+        for (size_t i = 0; i < maxNumberOfBonesPerVertex; i++)
+        {
+            const int boneID = vertex.boneID[i];
+            if (vertex.weights[i] > 0.f && boneID >= 0 && boneID < static_cast<int>(boneBounds.size()))
+            {
+                boneBounds[boneID].extend(vertex.position);
+            }
+        }
+    }
+}
@@ -14,10 +14,16 @@ class ModelLoader
 public:
     static Resources::MeshData loadMeshFromFile(const std::string& fileName, Renderer::VkRenderData& renderData);
 
+    // imports only the skeleton, needs no renderer, so it can run headless
+    static Resources::SkeletonData loadSkeletonFromFile(const std::string& fileName);
+
     static void collectPrimitivesRecursive(const Resources::MeshNode& node, const glm::mat4& parentTransform,
                                            std::vector<Resources::PrimitiveData>& outAllPrimitives);
 
 private:
+    static void buildSkeletonData(const aiScene* scene, const std::unordered_map<std::string, int>& globalBoneIndexMap,
+                                  Resources::SkeletonData& outSkeletonData);
+
     static void buildGlobalBoneIndexMap(const aiScene* scene,
                                         std::unordered_map<std::string, int>& outGlobalBoneIndexMap);
 
@@ -40,5 +46,9 @@ private:
                                   const std::unordered_map<std::string, int>& globalBoneIndexMap);
 
     static void setVertexBoneData(Renderer::Vertex& vertex, int id, float weight);
+
+    // box of the vertices every bone influences, in the space vertices are stored in, so it has to be rebuilt
+    // whenever vertices are transformed
+    static void buildBoneBounds(Resources::PrimitiveData& primitiveData);
 };
 } // namespace Core::Assets
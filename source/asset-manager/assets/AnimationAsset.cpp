@@ -0,0 +1,20 @@
+#include "AnimationAsset.h"
+#include "animations/AnimationClipCache.h"
+#include "animations/AnimationsUtils.h"
+#include "tools/Logger.h"
+
+Core::Assets::AnimationAsset::AnimationAsset(const std::string& path) : Asset(path)
+{
+    if (Animations::AnimationClipCache::load(path, mClips))
+    {
+        Logger::log(1, "Animations of %s loaded from cache\n", path.c_str());
+        return;
+    }
+
+    mClips = Animations::AnimationsUtils::loadAnimationsFromFile(path);
+
+    if (!mClips.empty())
+    {
+        Animations::AnimationClipCache::save(path, mClips);
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Asset.h"
+#include "animations/AnimationsData.h"
+
+#include <vector>
+
+namespace Core::Assets
+{
+// every clip of an animation file, loaded once and shared by all meshes playing it
+class AnimationAsset : public Asset
+{
+public:
+    explicit AnimationAsset(const std::string& path);
+
+    ~AnimationAsset() override = default;
+
+    [[nodiscard]] const std::vector<Animations::AnimationClip>& getClips() const { return mClips; }
+
+private:
+    std::vector<Animations::AnimationClip> mClips;
+};
+} // namespace Core::Assets
@@ -2,9 +2,10 @@
 #include "animations/AnimInstance.h"
 #include "vk-renderer/buffers/UniformBuffer.h"
 #include "engine/Engine.h"
-#include "animations/AnimationsUtils.h"
 #include "animations/anim-graph/AnimGraph.h"
 #include "animations/anim-graph/nodes/AnimGraphClipNode.h"
+#include "animations/simd/PoseKernels.h"
+#include "animations/AnimationsUtils.h"
 #include "asset-manager/AssetManager.h"
 #include "asset-manager/ModelLoader.h"
 #include "asset-manager/assets/MeshAsset.h"
@@ -13,31 +14,73 @@
 #include "utils/FileUtils.h"
 #include "vk-renderer/debug/Skeleton.h"
 
-void buildDebugSkeletonLines(const Core::Animations::Skeleton& skeleton, const Core::Animations::BonesInfo& bonesInfo,
-                             std::vector<Core::Renderer::Debug::DebugBone>& debugBones,
-                             const Core::Animations::BoneNode& node, const glm::mat4& parentTransform,
-                             const glm::mat4& meshTransform = glm::mat4(1.f))
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+// moller-trumbore, triangles are hit from both sides since picking does not know about culling
+bool intersectTriangle(const glm::vec3& origin, const glm::vec3& direction, const glm::vec3& v0, const glm::vec3& v1,
+                       const glm::vec3& v2, float& outDistance)
 {
-    glm::mat4 currentTransform;
+    const glm::vec3 edge1 = v1 - v0;
+    const glm::vec3 edge2 = v2 - v0;
+    const glm::vec3 p = glm::cross(direction, edge2);
 
-    auto& boneMap = skeleton.getSkeletonData()->boneNameToIndexMap;
-    if (const auto it = boneMap.find(node.name); it != boneMap.end())
+    const float determinant = glm::dot(edge1, p);
+    if (glm::abs(determinant) < std::numeric_limits<float>::epsilon())
     {
-        const int boneIndex = it->second;
-        currentTransform = meshTransform * bonesInfo.bones[boneIndex].animatedGlobalTransform;
+        return false;
     }
 
-    const glm::vec3 parentPos = glm::vec3(parentTransform * glm::vec4(0, 0, 0, 1));
-    const glm::vec3 currentPos = glm::vec3(currentTransform * glm::vec4(0, 0, 0, 1));
+    const float invDeterminant = 1.f / determinant;
+    const glm::vec3 toOrigin = origin - v0;
 
-    if (parentTransform != glm::mat4(1.f))
+    const float u = glm::dot(toOrigin, p) * invDeterminant;
+    if (u < 0.f || u > 1.f)
     {
-        debugBones.push_back({parentPos, currentPos});
+        return false;
     }
 
-    for (const auto& child : node.children)
+    const glm::vec3 q = glm::cross(toOrigin, edge1);
+    const float v = glm::dot(direction, q) * invDeterminant;
+    if (v < 0.f || u + v > 1.f)
     {
-        buildDebugSkeletonLines(skeleton, bonesInfo, debugBones, child, currentTransform, meshTransform);
+        return false;
+    }
+
+    outDistance = glm::dot(edge2, q) * invDeterminant;
+    return outDistance >= 0.f;
+}
+} // namespace
+
+void buildDebugSkeletonLines(const Core::Animations::Skeleton& skeleton, const Core::Animations::BonePalette& palette,
+                             std::vector<Core::Renderer::Debug::DebugBone>& debugBones,
+                             const glm::mat4& meshTransform = glm::mat4(1.f))
+{
+    if (palette.globalTransforms.empty())
+    {
+        return;
+    }
+
+    const Core::Animations::FlatSkeleton& flatSkeleton = skeleton.getSkeletonData()->flatSkeleton;
+
+    for (size_t slot = 0; slot < flatSkeleton.size(); ++slot)
+    {
+        const int parentIndex = flatSkeleton.parentBoneIndices[slot];
+        if (parentIndex < 0)
+        {
+            continue;
+        }
+
+        const int boneIndex = flatSkeleton.boneIndices[slot];
+
+        const glm::vec3 parentPos =
+            glm::vec3(meshTransform * palette.globalTransforms[parentIndex] * glm::vec4(0, 0, 0, 1));
+        const glm::vec3 currentPos =
+            glm::vec3(meshTransform * palette.globalTransforms[boneIndex] * glm::vec4(0, 0, 0, 1));
+
+        debugBones.push_back({parentPos, currentPos});
     }
 }
 
@@ -50,6 +93,8 @@ Core::Component::MeshComponent::MeshComponent(const Resources::SkeletonData* ske
 Core::Component::MeshComponent::~MeshComponent()
 {
     Logger::log(1, "%s: Destroyed mesh for owner %s", __FUNCTION__, getOwner()->getName().c_str());
+
+    releaseAnimations();
 }
 
 void Core::Component::MeshComponent::onAdded()
@@ -79,6 +124,69 @@ void Core::Component::MeshComponent::addPrimitive(
                              bonesInfo, renderData);
 }
 
+Core::Animations::BoundingBox Core::Component::MeshComponent::getBounds() const
+{
+    if (!mAnimatedBounds.isEmpty())
+    {
+        return mAnimatedBounds;
+    }
+
+    Animations::BoundingBox bounds;
+    for (const Renderer::Primitive& primitive : mPrimitives)
+    {
+        bounds.extend(primitive.getBounds());
+    }
+
+    return bounds;
+}
+
+void Core::Component::MeshComponent::skinPositions(const size_t primitiveIndex,
+                                                   std::vector<glm::vec3>& outPositions) const
+{
+    const Renderer::Primitive& primitive = mPrimitives[primitiveIndex];
+    const std::vector<Renderer::Vertex>& vertices = primitive.getVertices();
+
+    outPositions.resize(vertices.size());
+    Animations::PoseKernels::skinPositions(vertices, primitive.getBonesInfo().finalTransforms, outPositions.data());
+}
+
+bool Core::Component::MeshComponent::intersectRay(const glm::vec3& origin, const glm::vec3& direction,
+                                                  float& outDistance) const
+{
+    float boundsDistance = 0.f;
+    if (!getBounds().intersectRay(origin, direction, boundsDistance))
+    {
+        return false;
+    }
+
+    // only primitives that are drawn can be picked
+    const size_t primitiveCount = mPrimitiveIndex >= 0 ? std::min<size_t>(mPrimitives.size(), 1) : mPrimitives.size();
+
+    bool isHit = false;
+    outDistance = std::numeric_limits<float>::max();
+
+    std::vector<glm::vec3> positions;
+    for (size_t primitiveIndex = 0; primitiveIndex < primitiveCount; ++primitiveIndex)
+    {
+        skinPositions(primitiveIndex, positions);
+
+        const std::vector<uint32_t>& indices = mPrimitives[primitiveIndex].getIndices();
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            float distance = 0.f;
+            if (intersectTriangle(origin, direction, positions[indices[i]], positions[indices[i + 1]],
+                                  positions[indices[i + 2]], distance) &&
+                distance < outDistance)
+            {
+                outDistance = distance;
+                isHit = true;
+            }
+        }
+    }
+
+    return isHit;
+}
+
 void Core::Component::MeshComponent::update(Renderer::VkRenderData& renderData)
 {
     auto* transformComponent = getOwner()->getComponent<TransformComponent>();
@@ -87,14 +195,13 @@ void Core::Component::MeshComponent::update(Renderer::VkRenderData& renderData)
     for (auto& primitive : mPrimitives)
     {
         primitive.uploadUniformBuffer(renderData, worldMatrix);
+    }
 
-        if (shouldDrawDebugSkeleton())
-        {
-            std::vector<Renderer::Debug::DebugBone> debugBones;
-            buildDebugSkeletonLines(mSkeleton, primitive.getBonesInfo(), debugBones, mSkeleton.getRootNode(),
-                                    worldMatrix, worldMatrix);
-            mSkeleton.updateDebug(renderData, debugBones);
-        }
+    if (shouldDrawDebugSkeleton())
+    {
+        std::vector<Renderer::Debug::DebugBone> debugBones;
+        buildDebugSkeletonLines(mSkeleton, mBonePalette, debugBones, worldMatrix);
+        mSkeleton.updateDebug(renderData, debugBones);
     }
 }
 
@@ -137,7 +244,15 @@ void Core::Component::MeshComponent::setSourceMesh(const std::string_view& path,
     mPrimitiveIndex = primitiveIndex;
 }
 
-float Core::Component::MeshComponent::getWeightForBone(const std::string& boneName, float globalBlendFactor)
+const Core::Animations::AnimationMask& Core::Component::MeshComponent::getCompiledMask(const int index)
+{
+    Animations::AnimationMask& mask = mMasks[index];
+    Animations::AnimationsUtils::compileMask(mask, *mSkeleton.getSkeletonData());
+
+    return mask;
+}
+
+float Core::Component::MeshComponent::getWeightForBone(const int boneIndex, float globalBlendFactor)
 {
     if (mBlendingMode == Animations::AnimationBlendingMode::Crossfade)
     {
@@ -150,10 +265,10 @@ float Core::Component::MeshComponent::getWeightForBone(const std::string& boneNa
             return 0.f;
         }
 
-        const Animations::AnimationMask& mask = mMasks[mCurrentMaskIndex];
-        if (const auto it = mask.boneWeights.find(boneName); it != mask.boneWeights.end())
+        const std::span<const float> weights = getMaskWeights(mCurrentMaskIndex);
+        if (boneIndex >= 0 && static_cast<size_t>(boneIndex) < weights.size())
         {
-            return it->second;
+            return weights[boneIndex];
         }
 
         return 0.f;
@@ -164,23 +279,60 @@ float Core::Component::MeshComponent::getWeightForBone(const std::string& boneNa
 
 void Core::Component::MeshComponent::loadAnimationFromFile(const std::string_view& filePath)
 {
-    Animations::AnimationClip clip = Animations::AnimationsUtils::loadAnimationFromFile(filePath);
+    if (!mSkeleton.getSkeletonData())
+    {
+        Logger::log(1, "Animation %s can't be added for mesh %s without skeleton", filePath.data(),
+                    uuids::to_string(getUUID()).c_str());
+        return;
+    }
 
-    if (!clip.channels.empty())
+    const Animations::AnimationClipHandle handle = Animations::AnimationDatabase::getInstance().acquire(
+        std::string(filePath), *mSkeleton.getSkeletonData(),
+        Engine::getInstance().getSystem<Animations::Animator>()->getCompressionSettings());
+
+    if (!handle.isValid())
     {
-        mAnimationFiles.push_back(Utils::FileUtils::getRelativePath(filePath));
-        mAnimations.push_back(std::move(clip));
+        return;
+    }
 
-        if (mAnimations.size() == 1)
-        {
-            mShouldPlayAnimation = true;
-        }
+    mAnimationFiles.push_back(Utils::FileUtils::getRelativePath(filePath));
+    mAnimations.push_back(handle);
 
-        Logger::log(1, "Animation %s loaded and added for mesh %s", filePath.data(),
-                    uuids::to_string(getUUID()).c_str());
+    if (mAnimations.size() == 1)
+    {
+        mShouldPlayAnimation = true;
+    }
+
+    Logger::log(1, "Animation %s loaded and added for mesh %s", filePath.data(), uuids::to_string(getUUID()).c_str());
+}
+
+void Core::Component::MeshComponent::addAnimation(const Animations::AnimationClipHandle handle)
+{
+    if (!handle.isValid())
+    {
+        return;
+    }
+
+    mAnimations.push_back(handle);
+
+    if (mAnimations.size() == 1)
+    {
+        mShouldPlayAnimation = true;
     }
 }
 
+void Core::Component::MeshComponent::releaseAnimations()
+{
+    // clips are only acquired with a skeleton, and the skeleton changes only after they are released
+    for (const Animations::AnimationClipHandle handle : mAnimations)
+    {
+        Animations::AnimationDatabase::getInstance().release(handle, *mSkeleton.getSkeletonData());
+    }
+
+    mAnimations.clear();
+    mAnimationFiles.clear();
+}
+
 YAML::Node Core::Component::MeshComponent::serialize() const
 {
     YAML::Node node;
@@ -202,7 +354,9 @@ void Core::Component::MeshComponent::deserialize(const YAML::Node& node)
     mShouldPlayAnimation = node["shouldPlayAnimation"].as<bool>();
 
     mPrimitives.clear();
-    mAnimationFiles.clear();
+    mBonePalette = {};
+    mAnimatedBounds = {};
+    releaseAnimations();
 
     if (node["meshFile"])
     {
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "animations/AnimInstance.h"
+#include "animations/AnimationDatabase.h"
 #include "animations/Skeleton.h"
 #include "animations/anim-graph/AnimGraph.h"
 #include "animations/ik/IIKSolver.h"
 #include "scene/objects/SceneObject.h"
+#include <span>
 #include <utility>
 #include <vector>
 #include "vk-renderer/Primitive.h"
@@ -44,11 +46,27 @@ public:
 
     [[nodiscard]] Animations::Skeleton& getSkeleton() { return mSkeleton; }
 
+    // skeleton bone transforms shared by all primitives of the mesh, filled by Animator
+    [[nodiscard]] Animations::BonePalette& getBonePalette() { return mBonePalette; }
+
+    // mesh space box for culling and selection, animated box once Animator posed the mesh, bind pose box before
+    [[nodiscard]] Animations::BoundingBox getBounds() const;
+
+    void setAnimatedBounds(const Animations::BoundingBox& bounds) { mAnimatedBounds = bounds; }
+
+    // exact mesh space positions of primitive vertices in current pose, for precise picking after a bounds hit
+    void skinPositions(size_t primitiveIndex, std::vector<glm::vec3>& outPositions) const;
+
+    // distance along mesh space ray to the closest triangle in current pose
+    // rays missing the bounds return before any vertex is skinned
+    [[nodiscard]] bool intersectRay(const glm::vec3& origin, const glm::vec3& direction, float& outDistance) const;
+
     [[nodiscard]] std::unique_ptr<Animations::AnimInstance>& getAnimInstance() { return mAnimInstance; }
 
     [[nodiscard]] std::shared_ptr<Animations::AnimGraph>& getAnimGraph() { return mAnimGraph; }
 
-    [[nodiscard]] const std::vector<Animations::AnimationClip>& getAnimations() const { return mAnimations; }
+    // clips live in AnimationDatabase, mesh holds one reference to each of them
+    [[nodiscard]] const std::vector<Animations::AnimationClipHandle>& getAnimations() const { return mAnimations; }
 
     [[nodiscard]] bool hasAnimations() const { return !mAnimations.empty(); }
 
@@ -109,7 +127,16 @@ public:
 
     [[nodiscard]] Animations::AnimationMask& getMask(const int index) { return mMasks[index]; }
 
-    [[nodiscard]] float getWeightForBone(const std::string& boneName, float globalBlendFactor);
+    // mask is compiled against the skeleton on first use after an edit
+    [[nodiscard]] const Animations::AnimationMask& getCompiledMask(int index);
+
+    // weight of every bone index
+    [[nodiscard]] std::span<const float> getMaskWeights(const int index)
+    {
+        return getCompiledMask(index).compiledWeights;
+    }
+
+    [[nodiscard]] float getWeightForBone(int boneIndex, float globalBlendFactor);
 
     [[nodiscard]] std::string_view getMeshFilePath() const { return mMeshFilePath; }
 
@@ -117,6 +144,9 @@ public:
 
     void loadAnimationFromFile(const std::string_view& filePath);
 
+    // takes over the reference of a clip built at runtime, such clips have no file and are not serialized
+    void addAnimation(Animations::AnimationClipHandle handle);
+
     void setAnimationFiles(std::vector<std::string> files) { mAnimationFiles = std::move(files); }
 
     [[nodiscard]] YAML::Node serialize() const override;
@@ -124,17 +154,20 @@ public:
     void deserialize(const YAML::Node& node) override;
 
 private:
+    // gives clip references back to AnimationDatabase
+    void releaseAnimations();
+
     std::vector<Renderer::Primitive> mPrimitives;
     Animations::Skeleton mSkeleton;
+    Animations::BonePalette mBonePalette;
+    Animations::BoundingBox mAnimatedBounds;
 #pragma region Animation
     // TODO
     // remove later
     std::shared_ptr<Animations::AnimGraph> mAnimGraph;
     std::unique_ptr<Animations::AnimInstance> mAnimInstance;
 
-    // TODO
-    // I guess it should be moved to global animation manager, and mesh should store only shared pointers
-    std::vector<Animations::AnimationClip> mAnimations;
+    std::vector<Animations::AnimationClipHandle> mAnimations;
     bool mShouldPlayAnimation = false;
     bool mShouldBlendAnimations = false;
     bool mShouldDrawDebugSkeleton = false;
@@ -0,0 +1,115 @@
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+bool Core::MappedFile::open(const std::string& path)
+{
+    close();
+
+    // delete sharing lets the file be replaced by a rename while it is still mapped
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    mFileHandle = file;
+    mMappingHandle = mapping;
+    mData = static_cast<const std::byte*>(data);
+    mSize = static_cast<size_t>(size.QuadPart);
+
+    return true;
+}
+
+void Core::MappedFile::close()
+{
+    if (mData)
+    {
+        UnmapViewOfFile(mData);
+        CloseHandle(mMappingHandle);
+        CloseHandle(mFileHandle);
+    }
+
+    mData = nullptr;
+    mSize = 0;
+    mFileHandle = nullptr;
+    mMappingHandle = nullptr;
+}
+#else
+bool Core::MappedFile::open(const std::string& path)
+{
+    close();
+
+    const int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+
+    struct stat status{};
+    if (fstat(file, &status) != 0 || status.st_size == 0)
+    {
+        ::close(file);
+        return false;
+    }
+
+    void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+
+    // mapping keeps its own reference to the file
+    ::close(file);
+
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    mData = static_cast<const std::byte*>(data);
+    mSize = static_cast<size_t>(status.st_size);
+
+    return true;
+}
+
+void Core::MappedFile::close()
+{
+    if (mData)
+    {
+        munmap(const_cast<std::byte*>(mData), mSize);
+    }
+
+    mData = nullptr;
+    mSize = 0;
+}
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace Core
+{
+// read-only memory mapping of a whole file, pages are loaded by the OS on first access
+class MappedFile
+{
+public:
+    MappedFile() = default;
+
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // returns false if file can't be opened, is empty or can't be mapped
+    [[nodiscard]] bool open(const std::string& path);
+
+    void close();
+
+    [[nodiscard]] bool isOpen() const { return mData != nullptr; }
+
+    [[nodiscard]] const std::byte* getData() const { return mData; }
+
+    [[nodiscard]] size_t getSize() const { return mSize; }
+
+private:
+    const std::byte* mData = nullptr;
+
+    size_t mSize = 0;
+
+#if defined(_WIN32)
+    void* mFileHandle = nullptr;
+    void* mMappingHandle = nullptr;
+#endif
+};
+} // namespace Core
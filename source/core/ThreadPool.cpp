@@ -0,0 +1,125 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+Core::ThreadPool::ThreadPool(const size_t threadCount) { setThreadCount(threadCount); }
+
+Core::ThreadPool::~ThreadPool() { stopWorkers(); }
+
+void Core::ThreadPool::setThreadCount(size_t threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    if (threadCount == getThreadCount())
+    {
+        return;
+    }
+
+    stopWorkers();
+
+    // read before any worker starts, so a dispatch issued before a worker took the lock is still new to it
+    uint64_t generation;
+    {
+        std::lock_guard lock(mMutex);
+        generation = mGeneration;
+    }
+
+    mWorkers.reserve(threadCount - 1);
+    for (size_t threadIndex = 1; threadIndex < threadCount; ++threadIndex)
+    {
+        mWorkers.emplace_back(&ThreadPool::workerLoop, this, threadIndex, generation);
+    }
+}
+
+void Core::ThreadPool::parallelFor(const size_t count, const Task& task)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (mWorkers.empty() || count == 1)
+    {
+        for (size_t index = 0; index < count; ++index)
+        {
+            task(index, 0);
+        }
+
+        return;
+    }
+
+    {
+        std::lock_guard lock(mMutex);
+
+        mTask = &task;
+        mTaskCount = count;
+        mNextIndex.store(0, std::memory_order_relaxed);
+        mActiveWorkers = mWorkers.size();
+        ++mGeneration;
+    }
+    mWakeCondition.notify_all();
+
+    runTasks(0);
+
+    std::unique_lock lock(mMutex);
+    mDoneCondition.wait(lock, [this] { return mActiveWorkers == 0; });
+    mTask = nullptr;
+}
+
+void Core::ThreadPool::workerLoop(const size_t threadIndex, uint64_t seenGeneration)
+{
+    while (true)
+    {
+        {
+            std::unique_lock lock(mMutex);
+            mWakeCondition.wait(lock, [this, seenGeneration] { return mStopping || mGeneration != seenGeneration; });
+
+            if (mStopping)
+            {
+                return;
+            }
+
+            seenGeneration = mGeneration;
+        }
+
+        runTasks(threadIndex);
+
+        {
+            std::lock_guard lock(mMutex);
+            if (--mActiveWorkers == 0)
+            {
+                mDoneCondition.notify_one();
+            }
+        }
+    }
+}
+
+void Core::ThreadPool::runTasks(const size_t threadIndex)
+{
+    // indices are handed out one by one, so a few expensive items don't stall a whole thread's range
+    for (size_t index = mNextIndex.fetch_add(1, std::memory_order_relaxed); index < mTaskCount;
+         index = mNextIndex.fetch_add(1, std::memory_order_relaxed))
+    {
+        (*mTask)(index, threadIndex);
+    }
+}
+
+void Core::ThreadPool::stopWorkers()
+{
+    {
+        std::lock_guard lock(mMutex);
+        mStopping = true;
+    }
+    mWakeCondition.notify_all();
+
+    for (std::thread& worker : mWorkers)
+    {
+        worker.join();
+    }
+
+    mWorkers.clear();
+    mStopping = false;
+}
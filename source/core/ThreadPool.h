@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Core
+{
+// fixed set of workers for data parallel loops, calling thread takes part in every dispatch as thread 0
+class ThreadPool
+{
+public:
+    using Task = std::function<void(size_t index, size_t threadIndex)>;
+
+    // threadCount includes calling thread, 0 picks hardware concurrency
+    explicit ThreadPool(size_t threadCount = 0);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // must not be called while parallelFor is running
+    void setThreadCount(size_t threadCount);
+
+    [[nodiscard]] size_t getThreadCount() const { return mWorkers.size() + 1; }
+
+    // calls task for every index in [0, count) and returns once all of them finished
+    // threadIndex is in [0, getThreadCount()), so callers can keep per-thread scratch memory
+    void parallelFor(size_t count, const Task& task);
+
+private:
+    std::vector<std::thread> mWorkers;
+
+    std::mutex mMutex;
+    std::condition_variable mWakeCondition;
+    std::condition_variable mDoneCondition;
+
+    const Task* mTask = nullptr;
+    size_t mTaskCount = 0;
+    std::atomic<size_t> mNextIndex{0};
+
+    size_t mActiveWorkers = 0;
+    uint64_t mGeneration = 0;
+    bool mStopping = false;
+
+    // seenGeneration is the last dispatch that happened before the worker was created
+    void workerLoop(size_t threadIndex, uint64_t seenGeneration);
+
+    void runTasks(size_t threadIndex);
+
+    void stopWorkers();
+};
+} // namespace Core
@@ -1,15 +1,23 @@
 #include "AnimGraphEditorWindow.h"
 
 #include "imgui.h"
+#include "animations/AnimInstance.h"
+#include "animations/AnimationDatabase.h"
+#include "animations/anim-graph/AnimGraphBaker.h"
+#include "animations/anim-graph/AnimationContext.h"
 #include "animations/anim-graph/nodes/AnimGraphBlendNode.h"
 #include "animations/anim-graph/nodes/AnimGraphClipNode.h"
 #include "animations/anim-graph/nodes/AnimGraphIKNode.h"
+#include "animations/anim-graph/nodes/AnimGraphInertializationNode.h"
 #include "animations/anim-graph/nodes/AnimGraphMaskedBlendNode.h"
 #include "animations/anim-graph/nodes/AnimGraphOutputPoseNode.h"
+#include "animations/anim-graph/nodes/AnimGraphStateMachineNode.h"
+#include "animations/ik/IKSolverTwoBone.h"
 #include "components/MeshComponent.h"
 #include "editor/elements/Elements.h"
 #include "editor/styles/NodeEditorStyle.h"
 #include "engine/Engine.h"
+#include "imgui_stdlib.h"
 #include "ui/inspector/animation/AnimationInspectorInverseKinematicsUIWindow.h"
 
 namespace ed = ax::NodeEditor;
@@ -73,6 +81,10 @@ void Editor::Animations::AnimGraphEditorWindow::draw()
 
     ImGui::Begin("AnimGraph Editor", &mIsOpen);
 
+    drawBakeControls(animGraph);
+
+    drawParameterPanel(animGraph.get());
+
     ed::Begin("AnimGraph");
 
     UI::NodeEditorStyle::push();
@@ -92,7 +104,9 @@ void Editor::Animations::AnimGraphEditorWindow::draw()
         if (ImGui::MenuItem("Add Clip Node"))
         {
             const auto node = animGraph->createNode<Core::Animations::AnimGraphClipNode>();
-            node->setProperty("clipIndex", 0);
+            const auto& clips = mCurrentMeshComponent->getAnimations();
+            node->setProperty("clip", static_cast<int>(clips.empty() ? Core::Animations::AnimationClipHandle::invalidID
+                                                                     : clips.front().id));
 
             createEditorNode(node->getUUID());
             ed::SetNodePosition(mEditorNodes[node->getUUID()].NodeId, openPopupPosition);
@@ -117,6 +131,25 @@ void Editor::Animations::AnimGraphEditorWindow::draw()
             ed::SetNodePosition(mEditorNodes[node->getUUID()].NodeId, openPopupPosition);
         }
 
+        if (ImGui::MenuItem("Add Inertialization Node"))
+        {
+            const auto node = animGraph->createNode<Core::Animations::AnimGraphInertializationNode>();
+            node->setProperty("parameter", 0);
+            node->setProperty("blendTime", 0.2f);
+
+            createEditorNode(node->getUUID());
+            ed::SetNodePosition(mEditorNodes[node->getUUID()].NodeId, openPopupPosition);
+        }
+
+        if (ImGui::MenuItem("Add State Machine Node"))
+        {
+            const auto node = animGraph->createNode<Core::Animations::AnimGraphStateMachineNode>();
+            node->addState("Entry");
+
+            createEditorNode(node->getUUID());
+            ed::SetNodePosition(mEditorNodes[node->getUUID()].NodeId, openPopupPosition);
+        }
+
         if (ImGui::MenuItem("Add IK Node"))
         {
             const auto node = animGraph->createNode<Core::Animations::AnimGraphIKNode>();
@@ -160,6 +193,14 @@ void Editor::Animations::AnimGraphEditorWindow::draw()
         {
             ImGui::TextColored(ImVec4(0.3f, 1.f, 0.7f, 1.f), "Masked Blend");
         }
+        else if (dynamic_cast<Core::Animations::AnimGraphInertializationNode*>(node.get()))
+        {
+            ImGui::TextColored(ImVec4(0.3f, 0.9f, 0.9f, 1.f), "Inertialization");
+        }
+        else if (dynamic_cast<Core::Animations::AnimGraphStateMachineNode*>(node.get()))
+        {
+            ImGui::TextColored(ImVec4(1.f, 0.8f, 0.3f, 1.f), "State Machine");
+        }
         else if (dynamic_cast<Core::Animations::AnimGraphIKNode*>(node.get()))
         {
             ImGui::TextColored(ImVec4(0.9f, 0.6f, 0.2f, 1.f), "IK Solver");
@@ -180,10 +221,12 @@ void Editor::Animations::AnimGraphEditorWindow::draw()
         if (const auto* clipNode = dynamic_cast<Core::Animations::AnimGraphClipNode*>(node.get()))
         {
             const auto& clips = mCurrentMeshComponent->getAnimations();
-            int clipIndex = 0;
-            if (auto* property = clipNode->getProperty("clipIndex"))
+            const auto& database = Core::Animations::AnimationDatabase::getInstance();
+
+            Core::Animations::AnimationClipHandle currentClip;
+            if (auto* property = clipNode->getProperty("clip"))
             {
-                clipIndex = std::get<int>(*property);
+                currentClip.id = static_cast<uint32_t>(std::get<int>(*property));
             }
             if (clips.empty())
             {
@@ -191,7 +234,8 @@ void Editor::Animations::AnimGraphEditorWindow::draw()
             }
             else
             {
-                if (const char* currentLabel = clips[clipIndex].name.c_str(); ImGui::Button(currentLabel))
+                const Core::Animations::AnimationClip* clip = database.getClip(currentClip);
+                if (const char* currentLabel = clip ? clip->name.c_str() : "None"; ImGui::Button(currentLabel))
                 {
                     mClipSelectorPopupOpen = true;
                     mClipSelectorPopupOpenNode = uuid;
@@ -201,12 +245,12 @@ void Editor::Animations::AnimGraphEditorWindow::draw()
                     mClipSelectorPopup.items.clear();
                     mClipSelectorPopup.items.reserve(clips.size());
 
-                    for (auto& clip : clips)
+                    for (const Core::Animations::AnimationClipHandle handle : clips)
                     {
-                        mClipSelectorPopup.items.push_back(clip.name);
+                        mClipSelectorPopup.items.push_back(database.getClip(handle)->name);
                     }
 
-                    mClipSelectorPopup.onSelect = [uuid, animGraph](int index)
+                    mClipSelectorPopup.onSelect = [uuid, animGraph, clips](int index)
                     {
                         const auto it = animGraph->getNodes().find(uuid);
                         if (it == animGraph->getNodes().end())
@@ -216,7 +260,7 @@ void Editor::Animations::AnimGraphEditorWindow::draw()
 
                         if (auto* targetClipNode = dynamic_cast<Core::Animations::AnimGraphClipNode*>(it->second.get()))
                         {
-                            targetClipNode->setProperty("clipIndex", index);
+                            targetClipNode->setProperty("clip", static_cast<int>(clips[index].id));
                         }
                     };
                 }
@@ -295,13 +339,70 @@ void Editor::Animations::AnimGraphEditorWindow::draw()
             }
         }
 
+        if (auto* inertializationNode = dynamic_cast<Core::Animations::AnimGraphInertializationNode*>(node.get()))
+        {
+            uint32_t parameterID = 0;
+            if (auto* property = inertializationNode->getProperty("parameter"))
+            {
+                parameterID = static_cast<uint32_t>(std::get<int>(*property));
+            }
+
+            const std::string* parameterName = nullptr;
+            for (const Core::Animations::AnimParamDeclaration& parameter : animGraph->getParameters())
+            {
+                if (parameter.type == Core::Animations::AnimParamType::Bool && parameter.id.id == parameterID)
+                {
+                    parameterName = &parameter.name;
+                }
+            }
+
+            // input B plays while the parameter is set
+            ImGui::SetNextItemWidth(140.f);
+            if (ImGui::BeginCombo("Use B", parameterName ? parameterName->c_str() : "None"))
+            {
+                for (const Core::Animations::AnimParamDeclaration& parameter : animGraph->getParameters())
+                {
+                    if (parameter.type != Core::Animations::AnimParamType::Bool)
+                    {
+                        continue;
+                    }
+
+                    if (ImGui::Selectable(parameter.name.c_str(), parameter.id.id == parameterID))
+                    {
+                        inertializationNode->setProperty("parameter", static_cast<int>(parameter.id.id));
+                    }
+                }
+
+                ImGui::EndCombo();
+            }
+
+            float blendTime = 0.2f;
+            if (auto* property = inertializationNode->getProperty("blendTime"))
+            {
+                blendTime = std::get<float>(*property);
+            }
+
+            ImGui::SetNextItemWidth(140.f);
+            if (ImGui::SliderFloat("Blend Time", &blendTime, 0.0f, 1.0f, "%.2f s"))
+            {
+                inertializationNode->setProperty("blendTime", blendTime);
+            }
+        }
+
+        if (auto* stateMachineNode = dynamic_cast<Core::Animations::AnimGraphStateMachineNode*>(node.get()))
+        {
+            drawStateMachineBody(uuid, stateMachineNode, animGraph.get());
+        }
+
         if (auto* IKNode = dynamic_cast<Core::Animations::AnimGraphIKNode*>(node.get()))
         {
             bool signalFromNode = false;
             int targetPickerSolverIndex = -1;
+            int polePickerSolverIndex = -1;
 
             Core::UI::AnimationInspectorInverseKinematicsUIWindow::renderBody(
-                IKNode->getSolvers(), mCurrentMeshComponent, signalFromNode, targetPickerSolverIndex);
+                IKNode->getSolvers(), mCurrentMeshComponent, signalFromNode, targetPickerSolverIndex,
+                polePickerSolverIndex);
 
             if (signalFromNode)
             {
@@ -314,6 +415,15 @@ void Editor::Animations::AnimGraphEditorWindow::draw()
                 mIKTargetPickerOpenRequest = true;
                 mIKTargetPickerRequestNode = uuid;
                 mIKTargetPickerRequestSolverIndex = targetPickerSolverIndex;
+                mIKTargetPickerPicksPole = false;
+            }
+
+            if (polePickerSolverIndex != -1)
+            {
+                mIKTargetPickerOpenRequest = true;
+                mIKTargetPickerRequestNode = uuid;
+                mIKTargetPickerRequestSolverIndex = polePickerSolverIndex;
+                mIKTargetPickerPicksPole = true;
             }
         }
 
@@ -321,10 +431,24 @@ void Editor::Animations::AnimGraphEditorWindow::draw()
 
         ImGui::BeginGroup();
 
+        const auto* stateMachineNode = dynamic_cast<const Core::Animations::AnimGraphStateMachineNode*>(node.get());
+
         for (const auto& inputPin : editorData.InputPins)
         {
+            const char* label = "In";
+            if (stateMachineNode)
+            {
+                for (const Core::Animations::AnimState& state : stateMachineNode->getStates())
+                {
+                    if (state.inputPin == inputPin.RuntimePinId)
+                    {
+                        label = state.name.c_str();
+                    }
+                }
+            }
+
             ed::BeginPin(inputPin.EditorId, ed::PinKind::Input);
-            ImGui::Text("In");
+            ImGui::Text("%s", label);
             ed::EndPin();
         }
 
@@ -507,11 +631,22 @@ void Editor::Animations::AnimGraphEditorWindow::draw()
                 mIKTargetPickerRequestSolverIndex >= 0 && mIKTargetPickerRequestSolverIndex < solvers.size())
             {
                 auto& solver = solvers[mIKTargetPickerRequestSolverIndex];
+                auto* twoBoneSolver = dynamic_cast<Core::Animations::IKSolverTwoBone*>(solver.get());
 
-                Core::UI::ComponentPicker::RenderOnlyPopup<Core::Component::IKTargetComponent>(
-                    "IKNodeTargetDropdownPopup", solver->getTargetUUID(),
-                    Core::Engine::getInstance().getSystem<Core::Scene::Scene>(),
-                    [&](const uuids::uuid& selectedUUID) { solver->setTargetUUID(selectedUUID); });
+                if (mIKTargetPickerPicksPole && twoBoneSolver)
+                {
+                    Core::UI::ComponentPicker::RenderOnlyPopup<Core::Component::IKTargetComponent>(
+                        "IKNodeTargetDropdownPopup", twoBoneSolver->getPoleUUID(),
+                        Core::Engine::getInstance().getSystem<Core::Scene::Scene>(),
+                        [&](const uuids::uuid& selectedUUID) { twoBoneSolver->setPoleUUID(selectedUUID); });
+                }
+                else
+                {
+                    Core::UI::ComponentPicker::RenderOnlyPopup<Core::Component::IKTargetComponent>(
+                        "IKNodeTargetDropdownPopup", solver->getTargetUUID(),
+                        Core::Engine::getInstance().getSystem<Core::Scene::Scene>(),
+                        [&](const uuids::uuid& selectedUUID) { solver->setTargetUUID(selectedUUID); });
+                }
             }
         }
     }
@@ -555,6 +690,22 @@ void Editor::Animations::AnimGraphEditorWindow::createEditorNode(const uuids::uu
         data.InputPins.push_back({.EditorId = generateEditorId(), .RuntimePinId = maskedBlendNode->getInputBPin()});
         data.OutputPins.push_back({.EditorId = generateEditorId(), .RuntimePinId = maskedBlendNode->getOutputPin()});
     }
+    else if (const auto* inertializationNode =
+                 dynamic_cast<const Core::Animations::AnimGraphInertializationNode*>(node))
+    {
+        data.InputPins.push_back({.EditorId = generateEditorId(), .RuntimePinId = inertializationNode->getInputAPin()});
+        data.InputPins.push_back({.EditorId = generateEditorId(), .RuntimePinId = inertializationNode->getInputBPin()});
+        data.OutputPins.push_back(
+            {.EditorId = generateEditorId(), .RuntimePinId = inertializationNode->getOutputPin()});
+    }
+    else if (const auto* stateMachineNode = dynamic_cast<const Core::Animations::AnimGraphStateMachineNode*>(node))
+    {
+        for (const Core::Animations::AnimState& state : stateMachineNode->getStates())
+        {
+            data.InputPins.push_back({.EditorId = generateEditorId(), .RuntimePinId = state.inputPin});
+        }
+        data.OutputPins.push_back({.EditorId = generateEditorId(), .RuntimePinId = stateMachineNode->getOutputPin()});
+    }
     else if (const auto* IKNode = dynamic_cast<const Core::Animations::AnimGraphIKNode*>(node))
     {
         data.InputPins.push_back({.EditorId = generateEditorId(), .RuntimePinId = IKNode->getInputPin()});
@@ -568,6 +719,357 @@ void Editor::Animations::AnimGraphEditorWindow::createEditorNode(const uuids::uu
     mEditorNodes[uuid] = data;
 }
 
+void Editor::Animations::AnimGraphEditorWindow::drawBakeControls(
+    const std::shared_ptr<Core::Animations::AnimGraph>& animGraph)
+{
+    ImGui::SetNextItemWidth(100.f);
+    ImGui::DragFloat("Bake Length", &mBakeLength, 0.05f, 0.1f, 60.f, "%.2f s");
+
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(100.f);
+    ImGui::DragFloat("Bake Rate", &mBakeSampleRate, 1.f, 1.f, 120.f, "%.0f fps");
+
+    ImGui::SameLine();
+    if (!ImGui::Button("Bake to Clip"))
+    {
+        return;
+    }
+
+    const Core::Resources::SkeletonData* skeletonData = mCurrentMeshComponent->getSkeleton().getSkeletonData();
+    if (!skeletonData)
+    {
+        return;
+    }
+
+    animGraph->compilePlanIfDirty();
+
+    Core::Animations::AnimGraphBakeSettings settings;
+    settings.clipName = "baked:" + uuids::to_string(mCurrentMeshComponent->getUUID()) + ":" +
+                        std::to_string(mBakedClipCount++);
+    settings.endTime = mBakeLength;
+    settings.sampleRate = mBakeSampleRate;
+
+    // live parameter values are held for the whole clip
+    if (const auto& liveInstance = mCurrentMeshComponent->getAnimInstance())
+    {
+        for (const Core::Animations::AnimParamDeclaration& parameter : animGraph->getParameters())
+        {
+            const float value = parameter.type == Core::Animations::AnimParamType::Bool
+                                    ? (liveInstance->getBool(parameter.id) ? 1.f : 0.f)
+                                    : liveInstance->getFloat(parameter.id);
+
+            settings.parameterTracks.push_back({parameter.id, parameter.type, {{0.f, value}}});
+        }
+    }
+
+    Core::Animations::AnimationContext context;
+    context.skeletonData = skeletonData;
+    context.meshComponent = mCurrentMeshComponent;
+    context.database = &Core::Animations::AnimationDatabase::getInstance();
+    context.scene = Core::Engine::getInstance().getSystem<Core::Scene::Scene>();
+
+    // own instance, so the bake doesn't move clocks of the mesh being edited
+    Core::Animations::AnimInstance instance(animGraph);
+
+    Core::Animations::AnimationClip clip = Core::Animations::AnimGraphBaker::bake(instance, context, settings);
+
+    mCurrentMeshComponent->addAnimation(
+        Core::Animations::AnimationDatabase::getInstance().add(std::move(clip), *skeletonData));
+}
+
+void Editor::Animations::AnimGraphEditorWindow::drawParameterPanel(Core::Animations::AnimGraph* animGraph)
+{
+    if (!ImGui::CollapsingHeader("Parameters"))
+    {
+        return;
+    }
+
+    // values of parameters declared a frame ago need their slots
+    animGraph->compilePlanIfDirty();
+
+    const auto& liveInstance = mCurrentMeshComponent->getAnimInstance();
+
+    std::string parameterToRemove;
+    for (const Core::Animations::AnimParamDeclaration& parameter : animGraph->getParameters())
+    {
+        ImGui::PushID(static_cast<int>(parameter.id.id));
+
+        const bool isBool = parameter.type == Core::Animations::AnimParamType::Bool;
+
+        if (liveInstance && isBool)
+        {
+            bool value = liveInstance->getBool(parameter.id);
+            if (ImGui::Checkbox(parameter.name.c_str(), &value))
+            {
+                liveInstance->setBool(parameter.id, value);
+            }
+        }
+        else if (liveInstance)
+        {
+            float value = liveInstance->getFloat(parameter.id);
+            ImGui::SetNextItemWidth(140.f);
+            if (ImGui::DragFloat(parameter.name.c_str(), &value, 0.01f))
+            {
+                liveInstance->setFloat(parameter.id, value);
+            }
+        }
+        else
+        {
+            ImGui::TextUnformatted(parameter.name.c_str());
+        }
+
+        ImGui::SameLine();
+        ImGui::TextDisabled(isBool ? "(Bool)" : "(Float)");
+
+        ImGui::SameLine();
+        if (ImGui::SmallButton("x"))
+        {
+            parameterToRemove = parameter.name;
+        }
+
+        ImGui::PopID();
+    }
+
+    if (!parameterToRemove.empty())
+    {
+        animGraph->removeParameter(parameterToRemove);
+    }
+
+    ImGui::Separator();
+
+    ImGui::SetNextItemWidth(140.f);
+    ImGui::InputText("Name", &mNewParameterName);
+
+    static constexpr const char* typeNames[] = {"Float", "Bool"};
+
+    int type = static_cast<int>(mNewParameterType);
+    ImGui::SetNextItemWidth(140.f);
+    if (ImGui::Combo("Type", &type, typeNames, IM_ARRAYSIZE(typeNames)))
+    {
+        mNewParameterType = static_cast<Core::Animations::AnimParamType>(type);
+        mNewParameterDefault = 0.f;
+    }
+
+    if (mNewParameterType == Core::Animations::AnimParamType::Bool)
+    {
+        bool defaultValue = mNewParameterDefault != 0.f;
+        if (ImGui::Checkbox("Default", &defaultValue))
+        {
+            mNewParameterDefault = defaultValue ? 1.f : 0.f;
+        }
+    }
+    else
+    {
+        ImGui::SetNextItemWidth(140.f);
+        ImGui::DragFloat("Default", &mNewParameterDefault, 0.01f);
+    }
+
+    ImGui::BeginDisabled(mNewParameterName.empty());
+    if (ImGui::SmallButton("Add Parameter"))
+    {
+        // redeclaring an existing name changes its type and default
+        animGraph->declareParameter(mNewParameterName, mNewParameterType, mNewParameterDefault);
+        mNewParameterName.clear();
+    }
+    ImGui::EndDisabled();
+}
+
+void Editor::Animations::AnimGraphEditorWindow::drawStateMachineBody(
+    const uuids::uuid& uuid, Core::Animations::AnimGraphStateMachineNode* stateMachineNode,
+    Core::Animations::AnimGraph* animGraph)
+{
+    auto& states = stateMachineNode->getStates();
+
+    ImGui::TextDisabled("States");
+
+    int stateToRemove = -1;
+    for (int i = 0; i < static_cast<int>(states.size()); i++)
+    {
+        ImGui::PushID(i);
+
+        ImGui::SetNextItemWidth(120.f);
+        ImGui::InputText("##StateName", &states[i].name);
+
+        ImGui::SameLine();
+        if (ImGui::SmallButton("x"))
+        {
+            stateToRemove = i;
+        }
+
+        ImGui::PopID();
+    }
+
+    if (ImGui::SmallButton("Add State"))
+    {
+        stateMachineNode->addState("State " + std::to_string(states.size()));
+        animGraph->markPlanDirty();
+        syncInputPins(uuid, animGraph);
+    }
+
+    if (stateToRemove != -1)
+    {
+        stateMachineNode->removeState(stateToRemove);
+        animGraph->markPlanDirty();
+        syncInputPins(uuid, animGraph);
+    }
+
+    const auto getStateName = [&states](const int index)
+    { return index >= 0 && index < static_cast<int>(states.size()) ? states[index].name.c_str() : "Any"; };
+
+    const auto& parameters = animGraph->getParameters();
+
+    ImGui::Spacing();
+    ImGui::TextDisabled("Transitions");
+
+    auto& transitions = stateMachineNode->getTransitions();
+
+    int transitionToRemove = -1;
+    for (int i = 0; i < static_cast<int>(transitions.size()); i++)
+    {
+        Core::Animations::AnimStateTransition& transition = transitions[i];
+
+        ImGui::PushID(1000 + i);
+
+        ImGui::SetNextItemWidth(140.f);
+        if (ImGui::BeginCombo("From", getStateName(transition.fromState)))
+        {
+            for (int state = -1; state < static_cast<int>(states.size()); state++)
+            {
+                if (ImGui::Selectable(getStateName(state), transition.fromState == state))
+                {
+                    transition.fromState = state;
+                }
+            }
+
+            ImGui::EndCombo();
+        }
+
+        ImGui::SetNextItemWidth(140.f);
+        if (ImGui::BeginCombo("To", getStateName(transition.toState)))
+        {
+            for (int state = 0; state < static_cast<int>(states.size()); state++)
+            {
+                if (ImGui::Selectable(getStateName(state), transition.toState == state))
+                {
+                    transition.toState = state;
+                }
+            }
+
+            ImGui::EndCombo();
+        }
+
+        const Core::Animations::AnimParamDeclaration* currentParameter = nullptr;
+        for (const Core::Animations::AnimParamDeclaration& parameter : parameters)
+        {
+            if (parameter.id.id == transition.parameter.id)
+            {
+                currentParameter = &parameter;
+            }
+        }
+
+        ImGui::SetNextItemWidth(140.f);
+        if (ImGui::BeginCombo("Parameter", currentParameter ? currentParameter->name.c_str() : "None"))
+        {
+            for (const Core::Animations::AnimParamDeclaration& parameter : parameters)
+            {
+                if (ImGui::Selectable(parameter.name.c_str(), &parameter == currentParameter))
+                {
+                    transition.parameter = parameter.id;
+
+                    // keep condition matching the parameter type
+                    const bool isBool = parameter.type == Core::Animations::AnimParamType::Bool;
+                    const bool isBoolCondition =
+                        transition.condition == Core::Animations::AnimTransitionCondition::BoolSet ||
+                        transition.condition == Core::Animations::AnimTransitionCondition::BoolCleared;
+                    if (isBool != isBoolCondition)
+                    {
+                        transition.condition = isBool ? Core::Animations::AnimTransitionCondition::BoolSet
+                                                      : Core::Animations::AnimTransitionCondition::FloatGreater;
+                    }
+                }
+            }
+
+            ImGui::EndCombo();
+        }
+
+        static constexpr const char* conditionNames[] = {"Is Set", "Is Cleared", "Greater Than", "Less Than"};
+
+        int condition = static_cast<int>(transition.condition);
+        ImGui::SetNextItemWidth(140.f);
+        if (ImGui::Combo("Condition", &condition, conditionNames, IM_ARRAYSIZE(conditionNames)))
+        {
+            transition.condition = static_cast<Core::Animations::AnimTransitionCondition>(condition);
+        }
+
+        if (transition.condition == Core::Animations::AnimTransitionCondition::FloatGreater ||
+            transition.condition == Core::Animations::AnimTransitionCondition::FloatLess)
+        {
+            ImGui::SetNextItemWidth(140.f);
+            ImGui::DragFloat("Threshold", &transition.threshold, 0.01f);
+        }
+
+        ImGui::SetNextItemWidth(140.f);
+        ImGui::SliderFloat("Blend Time", &transition.blendTime, 0.0f, 1.0f, "%.2f s");
+
+        if (ImGui::SmallButton("Remove Transition"))
+        {
+            transitionToRemove = i;
+        }
+
+        UI::Elements::nodeSeparator(140.f);
+
+        ImGui::PopID();
+    }
+
+    if (transitionToRemove != -1)
+    {
+        stateMachineNode->removeTransition(transitionToRemove);
+    }
+
+    if (ImGui::SmallButton("Add Transition"))
+    {
+        stateMachineNode->addTransition({});
+    }
+}
+
+void Editor::Animations::AnimGraphEditorWindow::syncInputPins(const uuids::uuid& uuid,
+                                                               Core::Animations::AnimGraph* animGraph)
+{
+    const auto* node = animGraph->getNode(uuid);
+    if (!node || !mEditorNodes.contains(uuid))
+    {
+        return;
+    }
+
+    const auto& runtimeInputs = node->getInputs();
+    const auto hasRuntimePin = [&runtimeInputs](const Core::Animations::PinID pin)
+    { return std::ranges::any_of(runtimeInputs, [pin](const auto& input) { return input.id == pin; }); };
+
+    // links of removed pins go first, finding their runtime pin needs the editor pin
+    std::vector<EditorPinData> keptPins;
+    for (const EditorPinData& pin : mEditorNodes[uuid].InputPins)
+    {
+        if (hasRuntimePin(pin.RuntimePinId))
+        {
+            keptPins.push_back(pin);
+        }
+        else
+        {
+            removeLinksConnectedToPin(pin.EditorId, animGraph);
+        }
+    }
+
+    for (const auto& input : runtimeInputs)
+    {
+        if (std::ranges::none_of(keptPins, [&input](const EditorPinData& pin) { return pin.RuntimePinId == input.id; }))
+        {
+            keptPins.push_back({.EditorId = generateEditorId(), .RuntimePinId = input.id});
+        }
+    }
+
+    mEditorNodes[uuid].InputPins = std::move(keptPins);
+}
+
 const uuids::uuid* Editor::Animations::AnimGraphEditorWindow::findNodeByPin(const Core::Animations::PinID editorPinId)
 {
     for (const auto& [uuid, data] : mEditorNodes)
@@ -9,6 +9,11 @@ namespace Core::Component
 class MeshComponent;
 }
 
+namespace Core::Animations
+{
+class AnimGraphStateMachineNode;
+}
+
 // TODO
 // use CRTP pattern for UIWindow<>, but with state management
 namespace Editor::Animations
@@ -43,6 +48,19 @@ public:
 private:
     static void createEditorNode(const uuids::uuid& uuid);
 
+    // bakes graph of the mesh into a clip and adds it to the mesh clips
+    static void drawBakeControls(const std::shared_ptr<Core::Animations::AnimGraph>& animGraph);
+
+    // declares and removes graph parameters, values edited here go to the live instance of the mesh
+    static void drawParameterPanel(Core::Animations::AnimGraph* animGraph);
+
+    static void drawStateMachineBody(const uuids::uuid& uuid,
+                                     Core::Animations::AnimGraphStateMachineNode* stateMachineNode,
+                                     Core::Animations::AnimGraph* animGraph);
+
+    // matches editor input pins with the runtime ones after a node added or removed pins
+    static void syncInputPins(const uuids::uuid& uuid, Core::Animations::AnimGraph* animGraph);
+
     static const uuids::uuid* findNodeByPin(Core::Animations::PinID editorPinId);
 
     static Core::Animations::PinID findRuntimePin(Core::Animations::PinID editorPinId);
@@ -60,6 +78,15 @@ private:
     inline static std::vector<EditorLinkData> mEditorLinks{};
     inline static uint64_t mNextEditorId = 1;
 
+    inline static float mBakeLength = 1.f;
+    inline static float mBakeSampleRate = 30.f;
+    // keeps names of baked clips unique in AnimationDatabase
+    inline static uint32_t mBakedClipCount = 0;
+
+    inline static std::string mNewParameterName;
+    inline static Core::Animations::AnimParamType mNewParameterType = Core::Animations::AnimParamType::Float;
+    inline static float mNewParameterDefault = 0.f;
+
 #pragma region Popups
     inline static UI::PopupRequest mClipSelectorPopup{};
     inline static bool mClipSelectorPopupOpen = false;
@@ -75,6 +102,8 @@ private:
     inline static bool mIKTargetPickerOpenRequest = false;
     inline static uuids::uuid mIKTargetPickerRequestNode;
     inline static int mIKTargetPickerRequestSolverIndex = -1;
+    // same popup assigns pole of two bone solvers
+    inline static bool mIKTargetPickerPicksPole = false;
 #pragma endregion
 };
 } // namespace Editor::Animations
\ No newline at end of file
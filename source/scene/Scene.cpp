@@ -1,7 +1,10 @@
 #include "Scene.h"
 
+#include "components/MeshComponent.h"
 #include "components/TransformComponent.h"
 
+#include <limits>
+
 void Core::Scene::Scene::addObject(std::shared_ptr<SceneObject> object)
 {
     registerObjectRecursive(object);
@@ -83,6 +86,47 @@ void Core::Scene::Scene::unregisterObjectRecursive(const SceneObject* object)
     }
 }
 
+std::shared_ptr<Core::Scene::SceneObject> Core::Scene::Scene::pickObject(const glm::vec3& origin,
+                                                                         const glm::vec3& direction) const
+{
+    std::shared_ptr<SceneObject> pickedObject;
+    float closestDistance = std::numeric_limits<float>::max();
+
+    for (const auto& object : mObjects)
+    {
+        pickObjectRecursive(object, origin, direction, closestDistance, pickedObject);
+    }
+
+    return pickedObject;
+}
+
+void Core::Scene::Scene::pickObjectRecursive(const std::shared_ptr<SceneObject>& object, const glm::vec3& origin,
+                                             const glm::vec3& direction, float& closestDistance,
+                                             std::shared_ptr<SceneObject>& outObject)
+{
+    const auto* meshComponent = object->getComponent<Component::MeshComponent>();
+    auto* transformComponent = object->getComponent<Component::TransformComponent>();
+    if (meshComponent && transformComponent)
+    {
+        // affine inverse keeps ray parameter, so distances of different meshes stay comparable
+        const glm::mat4 worldToMesh = glm::inverse(transformComponent->getWorldMatrix());
+        const glm::vec3 meshOrigin = glm::vec3(worldToMesh * glm::vec4(origin, 1.f));
+        const glm::vec3 meshDirection = glm::vec3(worldToMesh * glm::vec4(direction, 0.f));
+
+        float distance = 0.f;
+        if (meshComponent->intersectRay(meshOrigin, meshDirection, distance) && distance < closestDistance)
+        {
+            closestDistance = distance;
+            outObject = object;
+        }
+    }
+
+    for (const auto& child : object->getChildren())
+    {
+        pickObjectRecursive(child, origin, direction, closestDistance, outObject);
+    }
+}
+
 void Core::Scene::Scene::registerComponent(Component::Component* component)
 {
     mUUIDToComponents[component->getUUID()] = component;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <glm/glm.hpp>
 #include <memory>
 #include "scene/objects/SceneObject.h"
 #include "SceneEditor.h"
@@ -43,6 +44,9 @@ public:
 
     [[nodiscard]] SceneObjectSelection& getSceneObjectSelection() { return sceneObjectSelection; }
 
+    // object owning the closest mesh hit by a world space ray, nullptr if the ray hits nothing
+    [[nodiscard]] std::shared_ptr<SceneObject> pickObject(const glm::vec3& origin, const glm::vec3& direction) const;
+
     template <typename T> T* findComponentInScene()
     {
         for (auto& object : mObjects)
@@ -93,6 +97,10 @@ public:
     }
 
 private:
+    static void pickObjectRecursive(const std::shared_ptr<SceneObject>& object, const glm::vec3& origin,
+                                    const glm::vec3& direction, float& closestDistance,
+                                    std::shared_ptr<SceneObject>& outObject);
+
     template <typename T> T* findComponentRecursive(SceneObject* object)
     {
         if (T* component = object->getComponent<T>())
@@ -90,7 +90,9 @@ class AnimationSequenceUIWindow : public UIWindow<AnimationSequenceUIWindow>
         return true;
     }
 
-    static void drawBoneNodeRecursive(const Animations::BoneNode& node, Component::MeshComponent* meshComponent)
+    // inheritedWeight is the mask weight of the parent node, shown for nodes without own weight
+    static void drawBoneNodeRecursive(const Animations::BoneNode& node, Component::MeshComponent* meshComponent,
+                                      const float inheritedWeight = 0.f)
     {
         ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_OpenOnDoubleClick;
 
@@ -125,17 +127,34 @@ class AnimationSequenceUIWindow : public UIWindow<AnimationSequenceUIWindow>
             ImGui::PopStyleColor();
         }
 
+        float weight = inheritedWeight;
         if (const int currentMaskIdx = meshComponent->getCurrentMaskIndex(); currentMaskIdx != -1)
         {
             ImGui::SameLine(ImGui::GetContentRegionAvail().x - 380.0f);
 
             auto& mask = meshComponent->getMask(currentMaskIdx);
-            float& weight = mask.boneWeights[node.name];
+            const float* authoredWeight = mask.findWeight(node.name);
+            if (authoredWeight)
+            {
+                weight = *authoredWeight;
+            }
 
             ImGui::PushItemWidth(80.0f);
 
+            // inherited weights are dimmed
+            if (!authoredWeight)
+            {
+                ImGui::PushStyleVar(ImGuiStyleVar_Alpha, ImGui::GetStyle().Alpha * 0.5f);
+            }
             const std::string sliderLabel = "##w_" + node.name;
-            ImGui::SliderFloat(sliderLabel.c_str(), &weight, 0.0f, 1.0f, "%.1f");
+            if (ImGui::SliderFloat(sliderLabel.c_str(), &weight, 0.0f, 1.0f, "%.1f"))
+            {
+                mask.setWeight(node.name, weight);
+            }
+            if (!authoredWeight)
+            {
+                ImGui::PopStyleVar();
+            }
             ImGui::PopItemWidth();
 
             ImGui::SameLine();
@@ -150,13 +169,12 @@ class AnimationSequenceUIWindow : public UIWindow<AnimationSequenceUIWindow>
             }
         }
 
-        if (isActualBone)
+        const auto& globalTransforms = meshComponent->getBonePalette().globalTransforms;
+        if (isActualBone && static_cast<size_t>(boneIndex) < globalTransforms.size())
         {
             ImGui::SameLine(ImGui::GetContentRegionAvail().x - 250.0f);
 
-            const auto& boneData = meshComponent->getPrimitives()[0].getBonesInfo().bones[boneIndex];
-
-            const Animations::BoneTransform transform{boneData.animatedGlobalTransform};
+            const Animations::BoneTransform transform{globalTransforms[boneIndex]};
 
             const glm::vec3 euler = glm::degrees(glm::eulerAngles(transform.rotation));
 
@@ -175,7 +193,7 @@ class AnimationSequenceUIWindow : public UIWindow<AnimationSequenceUIWindow>
         {
             for (const auto& child : node.children)
             {
-                drawBoneNodeRecursive(child, meshComponent);
+                drawBoneNodeRecursive(child, meshComponent, weight);
             }
             ImGui::TreePop();
         }
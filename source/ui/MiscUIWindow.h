@@ -73,6 +73,35 @@ class MiscUIWindow : public UIWindow<MiscUIWindow>
 
         ImGui::Separator();
 
+        auto* animator = Engine::getInstance().getSystem<Animations::Animator>();
+
+        int animationThreadCount = static_cast<int>(animator->getThreadCount());
+        if (ImGui::SliderInt("Animation threads", &animationThreadCount, 1,
+                             static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))))
+        {
+            animator->setThreadCount(animationThreadCount);
+        }
+
+        Animations::AnimationCompressionSettings& compressionSettings = animator->getCompressionSettings();
+
+        ImGui::Checkbox("Compress animations on load", &compressionSettings.enabled);
+        ImGui::SliderFloat("Max position error", &compressionSettings.maxPositionError, 0.0001f, 0.01f, "%.4f");
+        ImGui::SliderFloat("Max angular error", &compressionSettings.maxAngularError, 0.0001f, 0.01f, "%.4f");
+
+        Animations::AnimationLODSettings& lodSettings = animator->getLODSettings();
+
+        ImGui::Checkbox("Animation LOD", &lodSettings.enabled);
+        ImGui::SliderFloat("Animation budget (ms)", &lodSettings.budgetMilliseconds, 0.f, 10.f, "%.2f");
+        ImGui::SliderFloat("Animation bounding radius", &lodSettings.boundingRadius, 0.1f, 10.f, "%.1f");
+        ImGui::SliderFloat3("LOD min screen sizes", lodSettings.minScreenSizes.data(), 0.f, 1.f, "%.2f");
+
+        Animations::AnimationSharingSettings& sharingSettings = animator->getSharingSettings();
+
+        ImGui::Checkbox("Share animation poses", &sharingSettings.enabled);
+        ImGui::SliderFloat("Sharing time quantum (s)", &sharingSettings.timeQuantum, 0.f, 0.5f, "%.3f");
+
+        ImGui::Separator();
+
         ImGui::SliderInt("FOV", &renderData.rdFieldOfView, 40, 150);
 
         ImGui::Text("Camera Position:");
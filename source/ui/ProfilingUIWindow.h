@@ -5,6 +5,7 @@
 #include "string"
 #include "engine/Engine.h"
 #include "profiling/PlotBuffer.h"
+#include "animations/simd/PoseKernels.h"
 
 namespace Core::UI
 {
@@ -45,6 +46,33 @@ class ProfilingUIWindow : public UIWindow<ProfilingUIWindow>
         mAnimationPlot.push(renderData.rdAnimationBonesTransformCalculationTime);
         mAnimationPlot.draw("Animation Update Time");
 
+        ImGui::Text("Animated meshes per LOD:");
+        for (size_t lod = 0; lod < Animations::animationLODCount; ++lod)
+        {
+            ImGui::SameLine();
+            ImGui::Text("%u", renderData.rdAnimationLODMeshCounts[lod]);
+        }
+
+        ImGui::Text("Off-screen animated meshes:");
+        ImGui::SameLine();
+        ImGui::Text("%u", renderData.rdAnimationLODMeshCounts[Animations::offScreenAnimationLOD]);
+
+        ImGui::Text("Deferred by animation budget:");
+        ImGui::SameLine();
+        ImGui::Text("%u", renderData.rdAnimationDeferredMeshCount);
+
+        ImGui::Text("Shared animation poses:");
+        ImGui::SameLine();
+        ImGui::Text("%u", renderData.rdAnimationSharedMeshCount);
+
+        ImGui::Text("Pruned anim graph inputs:");
+        ImGui::SameLine();
+        ImGui::Text("%u", renderData.rdAnimationPrunedSubgraphCount);
+
+        ImGui::Text("Pose kernels:");
+        ImGui::SameLine();
+        ImGui::Text("%s", Animations::PoseKernels::getInstructionSetName(Animations::PoseKernels::getInstructionSet()));
+
         ImGui::End();
 
         return true;
@@ -35,8 +35,16 @@ class ViewportUIWindow : public UIWindow<ViewportUIWindow>
 
         ImGui::Image(reinterpret_cast<ImTextureID>(renderData.rdViewportTarget.descriptorSet), viewportSize);
 
-        Scene::SceneObjectSelection sceneObjectSelection =
-            Engine::getInstance().getSystem<Scene::Scene>()->getSceneObjectSelection();
+        auto* scene = Engine::getInstance().getSystem<Scene::Scene>();
+
+        // gizmo is drawn only for selected object, so its hover state is stale without one
+        const bool isOverGizmo = ImGuizmo::IsOver() && !scene->getSceneObjectSelection().selectedObject.expired();
+        if (ImGui::IsItemClicked(ImGuiMouseButton_Left) && !renderData.freeCameraMovement && !isOverGizmo)
+        {
+            pickSceneObject(renderData, ImGui::GetItemRectMin(), viewportSize);
+        }
+
+        Scene::SceneObjectSelection sceneObjectSelection = scene->getSceneObjectSelection();
 
         if (auto selectedObject = sceneObjectSelection.selectedObject.lock())
         {
@@ -95,6 +103,30 @@ class ViewportUIWindow : public UIWindow<ViewportUIWindow>
         return true;
     }
 
+    // selects object under the mouse, clicks into empty space keep current selection
+    static void pickSceneObject(const Renderer::VkRenderData& renderData, const ImVec2& imageMin,
+                                const ImVec2& imageSize)
+    {
+        const ImVec2 mousePosition = ImGui::GetMousePos();
+
+        // viewport is flipped, so ndc y points up
+        const glm::vec2 ndc{2.f * (mousePosition.x - imageMin.x) / imageSize.x - 1.f,
+                            1.f - 2.f * (mousePosition.y - imageMin.y) / imageSize.y};
+
+        const glm::mat4& projection = renderData.rdGlobalSceneData.projection;
+        const glm::mat4 cameraToWorld = glm::inverse(renderData.rdGlobalSceneData.view);
+
+        const glm::vec3 viewDirection{ndc.x / projection[0][0], ndc.y / projection[1][1], -1.f};
+        const glm::vec3 origin = glm::vec3(cameraToWorld[3]);
+        const glm::vec3 direction = glm::normalize(glm::vec3(cameraToWorld * glm::vec4(viewDirection, 0.f)));
+
+        auto* scene = Engine::getInstance().getSystem<Scene::Scene>();
+        if (const std::shared_ptr<Scene::SceneObject> object = scene->pickObject(origin, direction))
+        {
+            scene->getSceneObjectSelection().selectedObject = object;
+        }
+    }
+
 public:
     static void setSceneObjectManipulationOperation(ImGuizmo::OPERATION manipulateOperation)
     {
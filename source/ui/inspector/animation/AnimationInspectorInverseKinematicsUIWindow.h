@@ -4,6 +4,7 @@
 #include "imgui.h"
 #include "animations/ik/IKSolverCCD.h"
 #include "animations/ik/IKSolverFABRIK.h"
+#include "animations/ik/IKSolverTwoBone.h"
 #include "ui/ComponentPickerUIWindow.h"
 #include "engine/Engine.h"
 #include <ranges>
@@ -19,7 +20,7 @@ class AnimationInspectorInverseKinematicsUIWindow : public UIWindow<AnimationIns
 
     static bool getBody(std::vector<std::unique_ptr<Animations::IIKSolver>>& solvers,
                         Component::MeshComponent* meshComponent, bool& openPopupSignal,
-                        int& openTargetPickerSolverIndexSignal)
+                        int& openTargetPickerSolverIndexSignal, int& openPolePickerSolverIndexSignal)
     {
         if (!meshComponent)
         {
@@ -39,8 +40,7 @@ class AnimationInspectorInverseKinematicsUIWindow : public UIWindow<AnimationIns
                 const auto& solver = solvers[i];
                 const auto& chain = solver->getChainIndices();
 
-                const std::string solverTypePrefix =
-                    solver->getType() == Animations::AnimationSolverType::FABRIK ? "FABRIK" : "CCD";
+                const std::string solverTypePrefix = getSolverTypeName(solver->getType());
 
                 const std::string startBone = skeleton.getBoneName(chain.back());
                 const std::string endBone = skeleton.getBoneName(chain.front());
@@ -51,10 +51,15 @@ class AnimationInspectorInverseKinematicsUIWindow : public UIWindow<AnimationIns
                                       "%s Solver - %zu bones {%s} -> {%s}", solverTypePrefix.c_str(), chain.size(),
                                       startBone.c_str(), endBone.c_str()))
                 {
-                    int iterations = static_cast<int>(solver->getMaxIterations());
-                    if (ImGui::SliderInt("Iterations", &iterations, 1, 50))
+                    const auto* twoBoneSolver = dynamic_cast<const Animations::IKSolverTwoBone*>(solver.get());
+
+                    if (!twoBoneSolver)
                     {
-                        solver->setMaxIterations(iterations);
+                        int iterations = static_cast<int>(solver->getMaxIterations());
+                        if (ImGui::SliderInt("Iterations", &iterations, 1, 50))
+                        {
+                            solver->setMaxIterations(iterations);
+                        }
                     }
                     if (ImGui::Button("Remove Solver"))
                     {
@@ -64,24 +69,21 @@ class AnimationInspectorInverseKinematicsUIWindow : public UIWindow<AnimationIns
                         break;
                     }
 
-                    std::string targetLabel = "None (Click to select)";
-
-                    if (!solver->getTargetUUID().is_nil())
+                    ImGui::Text("Target");
+                    ImGui::SameLine();
+                    if (ImGui::Button((getComponentLabel(solver->getTargetUUID()) + "##Target").c_str()))
                     {
-                        if (const auto object = Engine::getInstance().getSystem<Scene::Scene>()->findComponentByUUID(
-                                solver->getTargetUUID()))
-                        {
-                            targetLabel = object->getOwner()->getName();
-                        }
-                        else
-                        {
-                            targetLabel = "Missing component";
-                        }
+                        openTargetPickerSolverIndexSignal = i;
                     }
 
-                    if (ImGui::Button(targetLabel.c_str()))
+                    if (twoBoneSolver)
                     {
-                        openTargetPickerSolverIndexSignal = i;
+                        ImGui::Text("Pole");
+                        ImGui::SameLine();
+                        if (ImGui::Button((getComponentLabel(twoBoneSolver->getPoleUUID()) + "##Pole").c_str()))
+                        {
+                            openPolePickerSolverIndexSignal = i;
+                        }
                     }
 
                     ImGui::TreePop();
@@ -172,6 +174,15 @@ public:
             {
                 solveType = Animations::AnimationSolverType::CCD;
             }
+            ImGui::SameLine();
+            if (ImGui::RadioButton("Two Bone", solveType == Animations::AnimationSolverType::TwoBone))
+            {
+                solveType = Animations::AnimationSolverType::TwoBone;
+            }
+            if (solveType == Animations::AnimationSolverType::TwoBone)
+            {
+                ImGui::TextDisabled("Bends the effector and its two parent bones, chain needs at least 3 bones.");
+            }
 
             const bool canCreate = startIndex != -1 && endIndex != -1;
             if (!canCreate)
@@ -181,14 +192,20 @@ public:
 
             if (ImGui::Button("Create", ImVec2(120, 0)))
             {
-                if (const std::vector<int> chain = meshComponent->getSkeleton().buildBonesChain(startIndex, endIndex);
-                    !chain.empty())
+                const std::vector<int> chain = meshComponent->getSkeleton().buildBonesChain(startIndex, endIndex);
+                const size_t minChainLength = solveType == Animations::AnimationSolverType::TwoBone ? 3 : 1;
+
+                if (chain.size() >= minChainLength)
                 {
                     std::unique_ptr<Animations::IIKSolver> newSolver;
                     if (solveType == Animations::AnimationSolverType::FABRIK)
                     {
                         newSolver = std::make_unique<Animations::IKSolverFABRIK>(chain);
                     }
+                    else if (solveType == Animations::AnimationSolverType::TwoBone)
+                    {
+                        newSolver = std::make_unique<Animations::IKSolverTwoBone>(chain);
+                    }
                     else
                     {
                         newSolver = std::make_unique<Animations::IKSolverCCD>(chain);
@@ -218,6 +235,34 @@ public:
         }
     }
 
+    static const char* getSolverTypeName(const Animations::AnimationSolverType type)
+    {
+        switch (type)
+        {
+        case Animations::AnimationSolverType::FABRIK:
+            return "FABRIK";
+        case Animations::AnimationSolverType::TwoBone:
+            return "Two Bone";
+        default:
+            return "CCD";
+        }
+    }
+
+    static std::string getComponentLabel(const uuids::uuid& uuid)
+    {
+        if (uuid.is_nil())
+        {
+            return "None (Click to select)";
+        }
+
+        if (const auto object = Engine::getInstance().getSystem<Scene::Scene>()->findComponentByUUID(uuid))
+        {
+            return object->getOwner()->getName();
+        }
+
+        return "Missing component";
+    }
+
     static void drawBoneHierarchy(const Animations::BoneNode& node, int& selectedIndex,
                                   const std::unordered_map<std::string, int>& nameToIndex)
     {
@@ -3,6 +3,9 @@
 #include "buffers/IndexBuffer.h"
 #include "buffers/VertexBuffer.h"
 
+#include <algorithm>
+#include <cstddef>
+
 Core::Renderer::Primitive::Primitive(
     const std::vector<Vertex>& vertexBufferData, const std::vector<uint32_t>& indexBufferData,
     const std::unordered_map<aiTextureType, std::shared_ptr<Assets::TextureAsset>>& textures,
@@ -17,6 +20,11 @@ Core::Renderer::Primitive::Primitive(
     createPrimitiveDataBuffer(renderData);
 
     primitiveFlagsPushConstants.hasSkinning = mBonesInfo.bones.empty() ? 0 : 1;
+
+    for (const Vertex& vertex : mVertexBufferData)
+    {
+        mBounds.extend(vertex.position);
+    }
 }
 
 void Core::Renderer::Primitive::createVertexBuffer(VkRenderData& renderData)
@@ -50,15 +58,30 @@ void Core::Renderer::Primitive::createPrimitiveDataBuffer(VkRenderData& renderDa
 
 void Core::Renderer::Primitive::uploadUniformBuffer(VkRenderData& renderData, const glm::mat4& modelMatrix)
 {
-    PrimitiveData data{};
-    data.model = modelMatrix;
+    // buffer is owned by the primitive and keeps its contents, static primitives upload only when they move
+    if (!mHasUploadedModel || modelMatrix != mUploadedModelMatrix)
+    {
+        UniformBuffer::uploadData(renderData, mPrimitiveDataUBO, &modelMatrix, sizeof(glm::mat4),
+                                  offsetof(PrimitiveData, model));
+
+        mUploadedModelMatrix = modelMatrix;
+        mHasUploadedModel = true;
+    }
+
+    if (!mBonesInfo.finalTransformsDirty)
+    {
+        return;
+    }
 
-    if (!mBonesInfo.finalTransforms.empty())
+    // bone ids of the primitive index its own compact bone table, matrices past it are never read
+    const size_t boneCount = std::min(mBonesInfo.finalTransforms.size(), maxNumberOfBones);
+    if (boneCount > 0)
     {
-        std::ranges::copy(mBonesInfo.finalTransforms, std::begin(data.bones));
+        UniformBuffer::uploadData(renderData, mPrimitiveDataUBO, mBonesInfo.finalTransforms.data(),
+                                  boneCount * sizeof(glm::mat3x4), offsetof(PrimitiveData, bones));
     }
 
-    UniformBuffer::uploadData(renderData, mPrimitiveDataUBO, data);
+    mBonesInfo.finalTransformsDirty = false;
 }
 
 void Core::Renderer::Primitive::draw(const VkRenderData& renderData, PrimitiveRenderType renderType)
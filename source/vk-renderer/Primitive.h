@@ -39,6 +39,15 @@ public:
 
     Animations::BonesInfo& getBonesInfo() { return mBonesInfo; }
 
+    [[nodiscard]] const Animations::BonesInfo& getBonesInfo() const { return mBonesInfo; }
+
+    [[nodiscard]] const std::vector<Vertex>& getVertices() const { return mVertexBufferData; }
+
+    [[nodiscard]] const std::vector<uint32_t>& getIndices() const { return mIndexBufferData; }
+
+    // bind pose box of all vertices
+    [[nodiscard]] const Animations::BoundingBox& getBounds() const { return mBounds; }
+
 private:
     void createVertexBuffer(VkRenderData& renderData);
 
@@ -61,8 +70,11 @@ private:
     VkDescriptorSet mMaterialDescriptorSet{};
 
     Animations::BonesInfo mBonesInfo{};
+    Animations::BoundingBox mBounds{};
 
     VkUniformBufferData mPrimitiveDataUBO{};
+    glm::mat4 mUploadedModelMatrix{1.0f};
+    bool mHasUploadedModel = false;
 
     PrimitiveFlagsPushConstants primitiveFlagsPushConstants{};
 };
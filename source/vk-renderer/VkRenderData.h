@@ -10,6 +10,7 @@
 #include <array>
 #include <complex.h>
 #include "descriptors/DescriptorLayoutCache.h"
+#include "animations/AnimationLOD.h"
 #include <memory>
 
 namespace Core::Assets
@@ -62,7 +63,8 @@ constexpr size_t maxNumberOfBones = 200;
 struct PrimitiveData
 {
     glm::mat4 model;
-    glm::mat4 bones[maxNumberOfBones];
+    // rows of affine skinning matrices, last row is always 0 0 0 1 and is not stored
+    glm::mat3x4 bones[maxNumberOfBones];
 };
 
 constexpr size_t maxNumberOfMaterials = 128;
@@ -247,6 +249,14 @@ struct VkRenderData
 #pragma region Profiling
     float rdFrameTime = 0.f;
     float rdAnimationBonesTransformCalculationTime = 0.f;
+    // animated meshes per LOD, last entry counts off-screen meshes
+    std::array<uint32_t, Animations::animationLODCount + 1> rdAnimationLODMeshCounts{};
+    // meshes due for an update but moved to next frames by animation budget
+    uint32_t rdAnimationDeferredMeshCount = 0;
+    // meshes which copied pose of another instance instead of evaluating their own
+    uint32_t rdAnimationSharedMeshCount = 0;
+    // anim graph inputs left unevaluated because their blend weight was negligible
+    uint32_t rdAnimationPrunedSubgraphCount = 0;
     float rdUpdateSceneProfilingTime = 0.f;
 #pragma endregion
 
@@ -21,6 +21,16 @@ public:
         vmaUnmapMemory(renderData.rdAllocator, UBOData.rdUniformBufferAlloc);
     }
 
+    // writes size bytes at offset, rest of the buffer keeps its previous contents
+    static void uploadData(VkRenderData& renderData, VkUniformBufferData& UBOData, const void* data, size_t size,
+                           size_t offset = 0)
+    {
+        void* mappedData;
+        vmaMapMemory(renderData.rdAllocator, UBOData.rdUniformBufferAlloc, &mappedData);
+        std::memcpy(static_cast<std::byte*>(mappedData) + offset, data, size);
+        vmaUnmapMemory(renderData.rdAllocator, UBOData.rdUniformBufferAlloc);
+    }
+
     static void cleanup(VkRenderData& renderData, VkUniformBufferData& UBOData);
 };
 } // namespace Core::Renderer
\ No newline at end of file